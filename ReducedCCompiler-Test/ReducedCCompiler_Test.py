@@ -9,6 +9,8 @@ from test_conditions_pkg.test_conditions import test_conditions
 from test_loops_pkg.test_loops           import test_loops
 from test_loops_pkg.test_break_continue  import test_break_continue
 from test_memory_pkg.test_memory         import test_memory
+from test_optimizations_pkg.test_optimizations import test_optimizations
+from test_driver_pkg.test_driver         import test_driver
 
 import sys
 from test_extra_pkg.test_extra  import test_extra
@@ -57,6 +59,16 @@ def run_all_tests():
     nb_errors += test_memory()
     os.chdir("..")
 
+    print("\n= Test optimizations =")
+    os.chdir("test_optimizations_pkg")
+    nb_errors += test_optimizations()
+    os.chdir("..")
+
+    print("\n= Test driver =")
+    os.chdir("test_driver_pkg")
+    nb_errors += test_driver()
+    os.chdir("..")
+
     if len(sys.argv) > 1 and sys.argv[1] == "extra":
         print("\n= Extra tests =")
         os.chdir("test_extra_pkg")
@@ -0,0 +1,73 @@
+int mask;
+
+int id(int x)
+{
+    return x;
+}
+
+int main()
+{
+    // Folded operations
+    print 12 & 10;
+    print 12 | 10;
+    print 12 ^ 10;
+    print ~5;
+    print ~-1;
+    print 1 << 4;
+    print -16 >> 2;
+    print 1 << 33;
+
+    // Computed operations
+    int a = id(12);
+    int b = id(10);
+    print a & b;
+    print a | b;
+    print a ^ b;
+    print ~a;
+    print a << 3;
+    print a >> 2;
+    print -a >> 1;
+    print b << id(31);
+    print a & 0;
+    print a | 0;
+    print a & -1;
+
+    // Precedence
+    print 1 | 2 ^ 3 & 4;
+    print a & b == 8;
+    print (a & b) == 8;
+    print 1 << 2 + 1;
+    print 1 + 2 << 1;
+    print a < b << 1;
+    print a & b || 0;
+
+    // Compound assignments
+    int c = 1;
+    c <<= 5;
+    print c;
+    c >>= 2;
+    print c;
+    c |= 3;
+    print c;
+    c &= 6;
+    print c;
+    c ^= 15;
+    print c;
+
+    mask = 255;
+    mask &= a ^ b;
+    print mask;
+    int address = &mask;
+    *address |= 256;
+    print mask;
+    print address[0] >> 8;
+
+    int i;
+    int bits = 0;
+    for (i = 0; i < 8; i += 1)
+    {
+        if (i & 1)
+            bits |= 1 << i;
+    }
+    print bits;
+}
@@ -9,7 +9,7 @@ import tests_utils as tu
 def test_binary_ops():
     LOG_DIR = "logs"
 
-    FILE_PREFIXES = ["binary_ops", "short_circuit"]
+    FILE_PREFIXES = ["binary_ops", "short_circuit", "bitwise_ops"]
     
     TEST_EXT    = ".c"
     MSM_EXT     = ".msm"
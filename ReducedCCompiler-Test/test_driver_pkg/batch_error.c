@@ -0,0 +1,5 @@
+// Compiled in a batch with the other batch_*.c programs, its compilation fails without stopping the others
+int main()
+{
+    return undefined_function(2);
+}
@@ -0,0 +1,15 @@
+// Compiled in a batch with the other batch_*.c programs
+int fibonacci(int n)
+{
+    if (n < 2)
+        return n;
+    return fibonacci(n - 1) + fibonacci(n - 2);
+}
+
+int main()
+{
+    int i;
+    for (i = 0; i < 10; i = i + 1)
+        print fibonacci(i);
+    return 0;
+}
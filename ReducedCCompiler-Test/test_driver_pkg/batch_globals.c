@@ -0,0 +1,21 @@
+// Compiled in a batch with the other batch_*.c programs
+int counter = 5;
+int history[3];
+
+int step(int i)
+{
+    counter = counter * 2;
+    history[i] = counter;
+    return counter;
+}
+
+int main()
+{
+    int i;
+    for (i = 0; i < 3; i = i + 1)
+        step(i);
+    print history[0] + history[1] + history[2];
+    printn(counter);
+    putchar(10);
+    return 0;
+}
@@ -0,0 +1,20 @@
+// Compiled in a batch with the other batch_*.c programs
+int sum(int values, int nb_values)
+{
+    int total = 0;
+    int i;
+    for (i = 0; i < nb_values; i = i + 1)
+        total = total + values[i];
+    return total;
+}
+
+int main()
+{
+    int values = malloc(5);
+    int i;
+    for (i = 0; i < 5; i = i + 1)
+        values[i] = i * i;
+    print sum(values, 5);
+    free(values);
+    return 0;
+}
@@ -0,0 +1,40 @@
+// Same as incremental.c but weight(), which is inlined in fill_weights(), so both are compiled again
+int weights[4];
+int base = 2;
+
+int digit_char(int digit) { return digit + 48; }
+
+int print_number(int n)
+{
+    if (n >= 10)
+        print_number(n / 10);
+    putchar(digit_char(n % 10));
+    return 0;
+}
+
+int weight(int i) { return i * base + 1; }
+
+int fill_weights()
+{
+    int i;
+    for (i = 0; i < 4; i = i + 1)
+        weights[i] = weight(i) + 1;
+    return 0;
+}
+
+int total()
+{
+    int i;
+    int sum = 0;
+    for (i = 0; i < 4; i = i + 1)
+        sum = sum + weights[i];
+    return sum;
+}
+
+int main()
+{
+    fill_weights();
+    print_number(total());
+    putchar(10);
+    return 0;
+}
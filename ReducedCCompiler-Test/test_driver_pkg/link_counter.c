@@ -0,0 +1,23 @@
+// Object file linked with link_main and the runtime : its globals are used by the other module
+int malloc(int size);
+int nb_steps = 0;
+int history[4];
+const int FACTOR = 3;
+int shared;
+
+int step(int value)
+{
+    history[nb_steps] = value;
+    nb_steps += 1;
+    shared = shared + value;
+    return value * FACTOR;
+}
+
+int make_buffer(int size)
+{
+    int buffer = malloc(size);
+    int i;
+    for (i = 0; i < size; i += 1)
+        buffer[i] = i * i;
+    return buffer;
+}
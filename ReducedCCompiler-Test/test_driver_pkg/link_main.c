@@ -0,0 +1,29 @@
+// Object file linked with link_counter and the runtime : the functions and variables of the other modules are declared
+int printn(int n);
+int step(int value);
+int make_buffer(int size);
+int twice(int x);
+extern int nb_steps;
+extern int history[4];
+extern int shared;
+int total = 7;
+
+int main()
+{
+    int i;
+    int sum = 0;
+    for (i = 1; i <= 3; i += 1)
+        sum += step(twice(i));
+    printn(sum); putchar(10);
+    printn(nb_steps); putchar(10);
+    printn(history[0] + history[1] + history[2]); putchar(10);
+    printn(shared + total); putchar(10);
+    int buffer = make_buffer(5);
+    printn(buffer[4]); putchar(10);
+    return 0;
+}
+
+int twice(int x)
+{
+    return 2 * x;
+}
@@ -0,0 +1,434 @@
+import os
+import shutil
+import socket
+import subprocess
+import sys
+import time
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+sys.path.append(os.path.dirname(SCRIPT_DIR))
+
+import tests_utils as tu
+
+# Sends the strings of a request to a daemon as its client does and returns the reply
+def send_daemon_request(socket_path, strings):
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as server:
+        server.connect(socket_path)
+        socket.send_fds(server, [b"\0"], [sys.stdin.fileno(), sys.stdout.fileno(), sys.stderr.fileno()])
+        server.sendall(b"".join(string + b"\0" for string in strings))
+        server.shutdown(socket.SHUT_WR)
+        reply = b""
+        while chunk := server.recv(4096):
+            reply += chunk
+    return reply
+
+def test_driver():
+    LOG_DIR = "logs"
+
+    # Programs compiled together by a single rcc process
+    BATCH_PREFIXES = ["batch_sum", "batch_fibonacci", "batch_globals"]
+    BATCH_DIR      = "batch"
+    BATCH_SUMMARY  = "batch"
+    # Batch in which a compilation fails
+    FAILED_BATCH_PREFIXES = ["batch_error", "batch_sum"]
+    FAILED_BATCH_DIR      = "failed_batch"
+    FAILED_BATCH_SUMMARY  = "failed_batch"
+    # Programs sent to a daemon by clients
+    DAEMON_PREFIXES = ["batch_sum", "batch_globals"]
+    DAEMON_SOCKET   = "rccd.sock"
+    DAEMON_SUFFIX   = "_client"
+    # Requests that the daemon rejects with a failure status : negative or missing number of arguments, more arguments than strings
+    MALFORMED_REQUESTS = [[b".", b"", b"-1"], [b".", b""], [b".", b"", b"3", b"rcc", b"-o"], [b".", b"", b"2x", b"rcc"]]
+    # Compilations through a cache that only holds two of the programs : the least recently used one is removed
+    CACHE_PREFIXES = ["batch_sum", "batch_fibonacci", "batch_sum", "batch_globals", "batch_sum", "batch_fibonacci"]
+    CACHE_DIR      = "cache"
+    CACHE_SIZE     = "30"
+    CACHE_SUFFIX   = "_cached"
+    CACHE_STATS    = "cache_stats"
+    # Modules compiled to object files then linked with the runtime, the link fails without one of them
+    LINK_PREFIXES  = ["link_main", "link_counter"]
+    LINK_RUNTIME   = "link_runtime"
+    LINK_PROGRAM   = "link"
+    OBJECT_EXT     = ".msmo"
+    # Incremental compilations sharing a database, the second source only modifies some functions
+    INCREMENTAL_PREFIXES = ["incremental", "incremental_edited"]
+    INCREMENTAL_DB       = "incremental.rccdb"
+    INCREMENTAL_STATS    = "_stats"
+    INCREMENTAL_STREAM   = "_stream"
+    TEST_EXT      = ".c"
+    MSM_EXT       = ".msm"
+
+    OUT_EXT       = ".txt"
+    REF_EXT       = ".ref"
+
+    test_nb = 1
+    nb_errors = 0
+    skip_next = False
+
+    if not os.path.isdir(LOG_DIR):
+       os.mkdir(LOG_DIR)
+
+    # BATCH COMPILATION
+    test_filenames = [prefix + TEST_EXT for prefix in BATCH_PREFIXES]
+    args = [tu.RCC_PATH, "--runtime", tu.RUNTIME_PATH, "-j", "2", "--outdir", BATCH_DIR] + test_filenames
+    desc = "Compiling " + " ".join(test_filenames) + " in " + BATCH_DIR
+    test_nb_str = tu.convert_test_nb_to_string(test_nb)
+    summary_filename = BATCH_SUMMARY + OUT_EXT
+    err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+    success = tu.test_run_process(desc, args, test_nb, out_filename=summary_filename, err_filename=err_filename)
+
+    if not success:
+        nb_errors += 1
+        skip_next = True
+
+    test_nb += 1
+    success = tu.test_compare_files(summary_filename, summary_filename + REF_EXT, test_nb, skip_test=skip_next)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+
+    for prefix in BATCH_PREFIXES:
+        # EXECUTION
+        exec_output_filename = prefix + OUT_EXT
+        exec_input_filename = BATCH_DIR + "/" + prefix + MSM_EXT
+        exec_ref_filename = exec_output_filename + REF_EXT
+
+        args = [tu.MSM_PATH]
+        desc = "Running " + exec_input_filename
+        test_nb_str = tu.convert_test_nb_to_string(test_nb)
+        err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+        success = tu.test_run_process(desc, args, test_nb,
+                                      in_filename=exec_input_filename,
+                                      out_filename=exec_output_filename,
+                                      err_filename=err_filename,
+                                      skip_test=skip_next)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+        success = tu.test_compare_files(exec_output_filename, exec_ref_filename, test_nb, skip_test=skip_next or not success)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+
+    # FAILED BATCH COMPILATION
+    test_filenames = [prefix + TEST_EXT for prefix in FAILED_BATCH_PREFIXES]
+    args = [tu.RCC_PATH, "--runtime", tu.RUNTIME_PATH, "--outdir", FAILED_BATCH_DIR] + test_filenames
+    desc = "Compiling " + " ".join(test_filenames) + " in " + FAILED_BATCH_DIR + " (expected failure)"
+    test_nb_str = tu.convert_test_nb_to_string(test_nb)
+    summary_filename = FAILED_BATCH_SUMMARY + OUT_EXT
+    err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+    success = tu.test_run_process(desc, args, test_nb, out_filename=summary_filename, err_filename=err_filename, expect_failure=True)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+    success = tu.test_compare_files(summary_filename, summary_filename + REF_EXT, test_nb)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+
+    # CACHE
+    if os.path.isdir(CACHE_DIR):
+        shutil.rmtree(CACHE_DIR)
+
+    for prefix in CACHE_PREFIXES:
+        # COMPILATION
+        test_filename = prefix + TEST_EXT
+        compiled_filename = prefix + CACHE_SUFFIX + MSM_EXT
+        args = [tu.RCC_PATH, "--runtime", tu.RUNTIME_PATH, "--cache", CACHE_DIR, "--cache-size", CACHE_SIZE, test_filename, "-o", compiled_filename]
+        desc = "Compiling " + test_filename + " with the cache"
+        test_nb_str = tu.convert_test_nb_to_string(test_nb)
+        out_filename = LOG_DIR + "/out_" + test_nb_str + ".txt"
+        err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+        success = tu.test_run_process(desc, args, test_nb, out_filename=out_filename, err_filename=err_filename)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+
+        # EXECUTION
+        exec_output_filename = prefix + CACHE_SUFFIX + OUT_EXT
+        exec_ref_filename = prefix + OUT_EXT + REF_EXT
+
+        args = [tu.MSM_PATH]
+        desc = "Running " + compiled_filename
+        test_nb_str = tu.convert_test_nb_to_string(test_nb)
+        err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+        success = tu.test_run_process(desc, args, test_nb,
+                                      in_filename=compiled_filename,
+                                      out_filename=exec_output_filename,
+                                      err_filename=err_filename,
+                                      skip_test=not success)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+        success = tu.test_compare_files(exec_output_filename, exec_ref_filename, test_nb, skip_test=not success)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+
+    # STATISTICS OF THE CACHE
+    args = [tu.RCC_PATH, "--cache", CACHE_DIR, "--cache-size", CACHE_SIZE, "--cache-stats"]
+    desc = "Displaying the statistics of " + CACHE_DIR
+    test_nb_str = tu.convert_test_nb_to_string(test_nb)
+    stats_filename = CACHE_STATS + OUT_EXT
+    err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+    success = tu.test_run_process(desc, args, test_nb, out_filename=stats_filename, err_filename=err_filename)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+    success = tu.test_compare_files(stats_filename, stats_filename + REF_EXT, test_nb, skip_test=not success)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+
+    # SEPARATE COMPILATION
+    sources = [(prefix + TEST_EXT, prefix) for prefix in LINK_PREFIXES] + [(tu.RUNTIME_PATH, LINK_RUNTIME)]
+    for (test_filename, prefix) in sources:
+        object_filename = prefix + OBJECT_EXT
+        args = [tu.RCC_PATH, "--object", test_filename, "-o", object_filename]
+        desc = "Compiling " + test_filename + " to " + object_filename
+        test_nb_str = tu.convert_test_nb_to_string(test_nb)
+        out_filename = LOG_DIR + "/out_" + test_nb_str + ".txt"
+        err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+        success = tu.test_run_process(desc, args, test_nb, out_filename=out_filename, err_filename=err_filename)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+
+    # LINK
+    object_filenames = [prefix + OBJECT_EXT for prefix in LINK_PREFIXES + [LINK_RUNTIME]]
+    linked_filename = LINK_PROGRAM + MSM_EXT
+    args = [tu.MSMLD_PATH] + object_filenames + ["-o", linked_filename]
+    desc = "Linking " + " ".join(object_filenames)
+    test_nb_str = tu.convert_test_nb_to_string(test_nb)
+    out_filename = LOG_DIR + "/out_" + test_nb_str + ".txt"
+    err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+    success = tu.test_run_process(desc, args, test_nb, out_filename=out_filename, err_filename=err_filename)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+
+    # EXECUTION
+    exec_output_filename = LINK_PROGRAM + OUT_EXT
+    args = [tu.MSM_PATH]
+    desc = "Running " + linked_filename
+    test_nb_str = tu.convert_test_nb_to_string(test_nb)
+    err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+    success = tu.test_run_process(desc, args, test_nb,
+                                  in_filename=linked_filename,
+                                  out_filename=exec_output_filename,
+                                  err_filename=err_filename,
+                                  skip_test=not success)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+    success = tu.test_compare_files(exec_output_filename, exec_output_filename + REF_EXT, test_nb, skip_test=not success)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+
+    # The functions and variables of link_counter are undefined without it
+    object_filenames = [LINK_PREFIXES[0] + OBJECT_EXT, LINK_RUNTIME + OBJECT_EXT]
+    args = [tu.MSMLD_PATH] + object_filenames + ["-o", LINK_PROGRAM + "_error" + MSM_EXT]
+    desc = "Linking " + " ".join(object_filenames) + " (expected failure)"
+    test_nb_str = tu.convert_test_nb_to_string(test_nb)
+    out_filename = LOG_DIR + "/out_" + test_nb_str + ".txt"
+    err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+    success = tu.test_run_process(desc, args, test_nb, out_filename=out_filename, err_filename=err_filename, expect_failure=True)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+
+    # INCREMENTAL COMPILATION
+    if os.path.exists(INCREMENTAL_DB):
+        os.remove(INCREMENTAL_DB)
+
+    for prefix in INCREMENTAL_PREFIXES:
+        # COMPILATION, the verbose output counts the functions reused from the database
+        test_filename = prefix + TEST_EXT
+        compiled_filename = prefix + MSM_EXT
+        args = [tu.RCC_PATH, "--no-runtime", "--verbose", "--incremental", INCREMENTAL_DB, test_filename, "-o", compiled_filename]
+        desc = "Compiling " + test_filename + " with " + INCREMENTAL_DB
+        test_nb_str = tu.convert_test_nb_to_string(test_nb)
+        stats_filename = prefix + INCREMENTAL_STATS + OUT_EXT
+        err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+        compiled = tu.test_run_process(desc, args, test_nb, out_filename=stats_filename, err_filename=err_filename)
+
+        if not compiled:
+            nb_errors += 1
+
+        test_nb += 1
+        success = tu.test_compare_files(stats_filename, stats_filename + REF_EXT, test_nb, skip_test=not compiled)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+
+        # EXECUTION
+        exec_output_filename = prefix + OUT_EXT
+        args = [tu.MSM_PATH]
+        desc = "Running " + compiled_filename
+        test_nb_str = tu.convert_test_nb_to_string(test_nb)
+        err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+        success = tu.test_run_process(desc, args, test_nb,
+                                      in_filename=compiled_filename,
+                                      out_filename=exec_output_filename,
+                                      err_filename=err_filename,
+                                      skip_test=not compiled)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+        success = tu.test_compare_files(exec_output_filename, exec_output_filename + REF_EXT, test_nb, skip_test=not success)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+
+    # The code reused from the database is the same as the code compiled from scratch
+    test_filename = INCREMENTAL_PREFIXES[-1] + TEST_EXT
+    incremental_filename = INCREMENTAL_PREFIXES[-1] + MSM_EXT
+    stream_filename = INCREMENTAL_PREFIXES[-1] + INCREMENTAL_STREAM + MSM_EXT
+    args = [tu.RCC_PATH, "--no-runtime", "--stream", test_filename, "-o", stream_filename]
+    desc = "Compiling " + test_filename + " without database"
+    test_nb_str = tu.convert_test_nb_to_string(test_nb)
+    out_filename = LOG_DIR + "/out_" + test_nb_str + ".txt"
+    err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+    success = tu.test_run_process(desc, args, test_nb, out_filename=out_filename, err_filename=err_filename)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+    success = tu.test_compare_files(incremental_filename, stream_filename, test_nb, skip_test=not success)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+
+    # DAEMON
+    if os.path.exists(DAEMON_SOCKET):
+        os.remove(DAEMON_SOCKET)
+    daemon_err_filename = LOG_DIR + "/err_daemon.txt"
+    with open(daemon_err_filename, "w") as daemon_err_file:
+        daemon = subprocess.Popen([tu.RCC_PATH, "--runtime", tu.RUNTIME_PATH, "--daemon=" + DAEMON_SOCKET], env=os.environ, stdout=subprocess.DEVNULL, stderr=daemon_err_file)
+    for _ in range(100):
+        if os.path.exists(DAEMON_SOCKET):
+            break
+        time.sleep(0.05)
+
+    for prefix in DAEMON_PREFIXES:
+        # COMPILATION BY THE DAEMON
+        test_filename = prefix + TEST_EXT
+        compiled_filename = prefix + DAEMON_SUFFIX + MSM_EXT
+        args = [tu.RCC_PATH, "--client=" + DAEMON_SOCKET, test_filename, "-o", compiled_filename]
+        desc = "Compiling " + test_filename + " with the daemon"
+        test_nb_str = tu.convert_test_nb_to_string(test_nb)
+        out_filename = LOG_DIR + "/out_" + test_nb_str + ".txt"
+        err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+        success = tu.test_run_process(desc, args, test_nb, out_filename=out_filename, err_filename=err_filename)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+
+        # EXECUTION
+        exec_output_filename = prefix + DAEMON_SUFFIX + OUT_EXT
+        exec_ref_filename = prefix + OUT_EXT + REF_EXT
+
+        args = [tu.MSM_PATH]
+        desc = "Running " + compiled_filename
+        test_nb_str = tu.convert_test_nb_to_string(test_nb)
+        err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+        success = tu.test_run_process(desc, args, test_nb,
+                                      in_filename=compiled_filename,
+                                      out_filename=exec_output_filename,
+                                      err_filename=err_filename,
+                                      skip_test=not success)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+        success = tu.test_compare_files(exec_output_filename, exec_ref_filename, test_nb, skip_test=not success)
+
+        if not success:
+            nb_errors += 1
+
+        test_nb += 1
+
+    for request in MALFORMED_REQUESTS:
+        desc = "Sending " + str(request) + " to the daemon (expected failure)"
+        test_nb_str = tu.convert_test_nb_to_string(test_nb)
+        reply = send_daemon_request(DAEMON_SOCKET, request)
+        if reply == b"1\n":
+            print("[" + test_nb_str + "] : " + tu.to_bold_success("OK") + " : " + desc)
+        else:
+            print("[" + test_nb_str + "] : " + tu.to_bold_error("KO") + " : " + desc)
+            nb_errors += 1
+
+        test_nb += 1
+
+    # The exit status of a failed compilation is returned to the client
+    test_filename = "batch_error" + TEST_EXT
+    args = [tu.RCC_PATH, "--client=" + DAEMON_SOCKET, test_filename, "-o", "batch_error" + DAEMON_SUFFIX + MSM_EXT]
+    desc = "Compiling " + test_filename + " with the daemon (expected failure)"
+    test_nb_str = tu.convert_test_nb_to_string(test_nb)
+    out_filename = LOG_DIR + "/out_" + test_nb_str + ".txt"
+    err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+    success = tu.test_run_process(desc, args, test_nb, out_filename=out_filename, err_filename=err_filename, expect_failure=True)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+
+    daemon.terminate()
+    daemon.wait()
+    if os.path.exists(DAEMON_SOCKET):
+        os.remove(DAEMON_SOCKET)
+
+    return nb_errors
+
+
+if __name__ == "__main__":
+    print("Test driver")
+    nb_errors = test_driver()
+    if nb_errors > 0:
+        print(tu.to_bold_error("\nXXX " + str(nb_errors) + (" error" if nb_errors == 1 else " errors") + " XXX"))
+    else:
+        print(tu.to_bold_success("   All tests passed"))
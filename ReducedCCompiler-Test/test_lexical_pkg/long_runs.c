@@ -0,0 +1,16 @@
+/* A block comment long enough to be scanned in several chunks ********************** / * still inside
+   spanning lines		with tabs and a star at the end of a chunk *
+*/
+int a_very_long_identifier_that_crosses_the_boundaries_of_several_simd_chunks_0123456789;
+                                                                      int																						b; // Line comment after a long run of blanks xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+
+int c;/**/int d;/***/int e;/* ** */int f; //
+
+
+int main()
+{
+    return a_very_long_identifier_that_crosses_the_boundaries_of_several_simd_chunks_0123456789 + b*c/d;                                 
+    x0123456789abcdefghijklmnopqrstuvwxyz_ABCDEFGHIJKLMNOPQRSTUVWXYZ = 0x1F+0b101 + 017 + 'a' + '\n';
+    `_not_an_identifier @ $
+}
+// Last line comment without newline yyyyyyyyyyyyyyyyyyyy
\ No newline at end of file
@@ -13,6 +13,7 @@ def test_lexical():
         "valid",
         "mix",
         "junk",
+        "long_runs",
     ]
 
     TEST_EXT      = ".c"
@@ -52,6 +53,27 @@ def test_lexical():
         skip_next = False
         test_nb += 1
 
+    # The source can also be read from the standard input
+    test_filename = FILE_PREFIXES[0] + TEST_EXT
+    lex_output_filename = FILE_PREFIXES[0] + "_stdin" + LEXICAL_EXT + OUT_EXT
+    lex_ref_filename = FILE_PREFIXES[0] + LEXICAL_EXT + OUT_EXT + REF_EXT
+
+    args = [tu.RCC_PATH, "--no-runtime", "-", "--stage", "lexical", "-o", lex_output_filename]
+    desc = "Running lexical analysis on " + test_filename + " read from the standard input"
+    test_nb_str = tu.convert_test_nb_to_string(test_nb)
+    out_filename = LOG_DIR + "/out_" + test_nb_str + ".txt"
+    err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
+    success = tu.test_run_process(desc, args, test_nb, in_filename=test_filename, out_filename=out_filename, err_filename=err_filename)
+
+    if not success:
+        nb_errors += 1
+
+    test_nb += 1
+    success = tu.test_compare_files(lex_output_filename, lex_ref_filename, test_nb, skip_test=not success)
+
+    if not success:
+        nb_errors += 1
+
     return nb_errors
 
 
@@ -0,0 +1,34 @@
+int main()
+{
+    int arena = arena_create(10);
+    int a = arena_alloc(arena, 4);
+    int b = arena_alloc(arena, 6);
+    printn(b - a);
+    putchar(10);
+
+    // The arena is full
+    printn(arena_alloc(arena, 1));
+    putchar(10);
+    printn(arena_alloc(arena, 0));
+    putchar(10);
+
+    int i;
+    for (i = 0; i < 4; i += 1)
+        a[i] = i * i;
+    for (i = 0; i < 6; i += 1)
+        b[i] = -i;
+    printn(a[3] + b[5]);
+    putchar(10);
+
+    // Everything is released at once, the same memory is given again
+    arena_reset(arena);
+    printn(arena_alloc(arena, 10) == a);
+    putchar(10);
+
+    arena_destroy(arena);
+    int other = arena_create(10);
+    printn(other == arena);
+    putchar(10);
+    printn(arena_create(100000));
+    putchar(10);
+}
@@ -0,0 +1,36 @@
+int main()
+{
+    int a = malloc(3);
+    int b = malloc(5);
+    printn(b - a);
+    putchar(10);
+
+    // Freed memory isn't reused
+    free(b);
+    int c = malloc(1);
+    printn(c - b);
+    putchar(10);
+
+    printn(malloc(0));
+    putchar(10);
+    printn(malloc(100000));
+    putchar(10);
+
+    // Arenas are allocated with the bump allocator
+    int arena = arena_create(4);
+    printn(arena - c);
+    putchar(10);
+    int d = arena_alloc(arena, 4);
+    printn(d - arena);
+    putchar(10);
+    d[3] = 7;
+    printn(d[3]);
+    putchar(10);
+
+    // realloc copies the data to a new block
+    int e = realloc(d, 8);
+    printn(e - d);
+    putchar(10);
+    printn(e[3]);
+    putchar(10);
+}
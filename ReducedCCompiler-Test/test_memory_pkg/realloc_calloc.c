@@ -0,0 +1,56 @@
+int main()
+{
+    int i;
+
+    // calloc clears the reused memory
+    int dirty = malloc(6);
+    for (i = 0; i < 6; i += 1)
+        dirty[i] = 99;
+    free(dirty);
+    int zeros = calloc(3, 2);
+    println(zeros == dirty);
+    int sum = 0;
+    for (i = 0; i < 6; i += 1)
+        sum += zeros[i];
+    println(sum);
+    free(zeros);
+
+    // Growing a vector by doubling its capacity
+    int capacity = 2;
+    int vector = malloc(capacity);
+    int first = vector;
+    for (i = 0; i < 20; i += 1)
+    {
+        if (i == capacity)
+        {
+            capacity *= 2;
+            vector = realloc(vector, capacity);
+        }
+        vector[i] = i * i;
+    }
+    // The following block was free : the vector never moved
+    println(vector == first);
+    println(vector[-1]);
+    sum = 0;
+    for (i = 0; i < 20; i += 1)
+        sum += vector[i];
+    println(sum);
+    print_free_blocks_list();
+
+    // A block allocated after the vector forces a copy
+    int blocker = malloc(4);
+    int moved = realloc(vector, 64);
+    println(moved == vector);
+    println(moved[19] + moved[3]);
+    print_free_blocks_list();
+
+    // Shrinking keeps the block
+    println(realloc(moved, 10) == moved);
+    println(realloc(NULL, 3) != NULL);
+    println(realloc(blocker, 0));
+
+    // memset and memcpy work on overlapping blocks
+    memset(moved, 7, 4);
+    memcpy(moved + 1, moved, 4);
+    println(moved[0] + moved[4] + moved[5]);
+}
@@ -0,0 +1,50 @@
+// Compiled with --stream : the runtime is compiled one declaration at a time before the program
+int nb_blocks;
+int blocks[4];
+
+int allocate(int size)
+{
+    int block = malloc(size);
+    blocks[nb_blocks] = block;
+    nb_blocks += 1;
+    return block;
+}
+
+int sum(int values, int nb_values)
+{
+    int total = 0;
+    int i;
+    for (i = 0; i < nb_values; i += 1)
+        total += values[i];
+    return total;
+}
+
+int main()
+{
+    int a = allocate(3);
+    int b = allocate(5);
+    int i;
+    for (i = 0; i < 3; i += 1)
+        a[i] = i + 1;
+    for (i = 0; i < 5; i += 1)
+        b[i] = 10 * i;
+    printn(sum(a, 3) + sum(b, 5));
+    putchar(10);
+
+    // The grown block keeps its values
+    a = realloc(a, 6);
+    blocks[0] = a;
+    printn(sum(a, 3));
+    putchar(10);
+
+    int zeros = calloc(4, 2);
+    blocks[2] = zeros;
+    nb_blocks += 1;
+    printn(sum(zeros, 8));
+    putchar(10);
+
+    for (i = 0; i < nb_blocks; i += 1)
+        free(blocks[i]);
+    printn(nb_blocks);
+    putchar(10);
+}
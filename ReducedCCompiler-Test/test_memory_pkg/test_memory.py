@@ -9,7 +9,10 @@ import tests_utils as tu
 def test_memory():
     LOG_DIR = "logs"
 
-    FILE_PREFIXES = ["malloc_edge_case", "simple_reuse_freeblock", "reuse_block_diff_length", "split_blocks", "right_merge", "left_merge"]
+    FILE_PREFIXES = ["malloc_edge_case", "simple_reuse_freeblock", "reuse_block_diff_length", "split_blocks", "right_merge", "left_merge",
+                     "arena", "bump_malloc", "realloc_calloc", "streamed_runtime"]
+    # Additional options of the compilation of a program
+    OPTIONS       = {"bump_malloc": ["--bump-malloc"], "streamed_runtime": ["--stream"]}
     TEST_EXT      = ".c"
     MSM_EXT       = ".msm"
     
@@ -29,8 +32,9 @@ def test_memory():
         # CODE GENERATION
         msm_output_filename = FILE_PREFIXES[test_file_nb] + MSM_EXT
 
-        args = [tu.RCC_PATH, "--runtime", tu.RUNTIME_PATH, test_filename, "-o", msm_output_filename]
-        desc = "Compiling " + test_filename
+        options = OPTIONS.get(FILE_PREFIXES[test_file_nb], [])
+        args = [tu.RCC_PATH, "--runtime", tu.RUNTIME_PATH, test_filename, "-o", msm_output_filename] + options
+        desc = "Compiling " + test_filename + ("" if len(options) == 0 else " with " + " ".join(options))
         test_nb_str = str(test_nb) if test_nb >= 100 else "0" + str(test_nb) if test_nb >= 10 else "00" + str(test_nb)
         out_filename = LOG_DIR + "/out_" + test_nb_str + ".txt"
         err_filename = LOG_DIR + "/err_" + test_nb_str + ".txt"
@@ -0,0 +1,61 @@
+const int TEN = 10;
+const int SCALE = 1;
+int g;
+
+int side(int x)
+{
+    print x;
+    return x;
+}
+
+int main()
+{
+    int x = 5;
+    print x + 1 + 2;
+    print 1 + x + 2;
+    print x - 1 - 2;
+    print x + 1 - 7;
+    print x * 2 * 3;
+    print x * 1 + x * 0 + 0;
+    print x / 1 - TEN;
+    print side(3) * 0;
+    print 0 && side(4);
+    print 1 || side(5);
+    print side(6) && 1;
+    print x && 0;
+    if (0)
+        print 100;
+    else
+        print 200;
+    if (TEN > 5)
+        print 300;
+    int i = 0;
+    while (1)
+    {
+        i = i + 1;
+        if (i >= TEN)
+            break;
+    }
+    print i;
+    do
+        i = i - 1;
+    while (0);
+    print i;
+    g = -TEN;
+    print g % 1;
+    print &g != 0;
+    // The operation of a compound assignment is kept when it folds to its operand
+    int z = 7;
+    z += 0;
+    z -= 0;
+    z *= 1;
+    z /= 1;
+    print z;
+    z *= SCALE;
+    print z;
+    z %= 1;
+    print z;
+    z = 4;
+    z *= 0;
+    print z;
+}
@@ -0,0 +1,45 @@
+int check(int a, int b)
+{
+    int mask = 0;
+    if (a == b)  mask = mask + 1;
+    if (a != b)  mask = mask + 2;
+    if (a < b)   mask = mask + 4;
+    if (a <= b)  mask = mask + 8;
+    if (a > b)   mask = mask + 16;
+    if (a >= b)  mask = mask + 32;
+    if (!(a < b))
+        mask = mask + 64;
+    else
+        mask = mask + 128;
+    if (!!(a == b))
+        mask = mask + 256;
+    if (!a)
+        mask = mask + 512;
+    return mask;
+}
+
+int main()
+{
+    print check(1, 2);
+    print check(2, 2);
+    print check(3, 2);
+    print check(0, -1);
+
+    int i = 0;
+    int sum = 0;
+    while (i < 10)
+    {
+        sum = sum + i;
+        i = i + 1;
+    }
+    print sum;
+
+    do
+        i = i - 3;
+    while (!(i <= 0));
+    print i;
+
+    for (int j = 10; j != 0; j = j - 2)
+        sum = sum - j;
+    print sum;
+}
@@ -0,0 +1,44 @@
+int table[8];
+
+int sum(int values, int nb_values)
+{
+    int total = 0;
+    int i;
+    for (i = 0; i < nb_values; i = i + 1)
+        total = total + values[i];
+    return total;
+}
+
+int main()
+{
+    int i;
+    for (i = 0; i < 8; i = i + 1)
+        table[i] = 3 * i;
+    print sum(table, 8);
+    print table[7];
+    print *(table + 2);
+    print *(5 + table);
+
+    // Elements of a local array are accessed relatively to the frame
+    int local[4];
+    local[0] = 10;
+    for (i = 1; i < 4; i = i + 1)
+        local[i] = local[i - 1] + i;
+    for (i = 0; i < 4; i = i + 1)
+        print local[i];
+    i = 2;
+    print i[local];
+    print *local;
+    print sum(local, 4);
+    local[3] += 100;
+    print local[3];
+    local[1] = local[2] = 7;
+    print local[1] + local[2];
+
+    // Index computed through a pointer
+    int pointer = local;
+    pointer[2] = 40;
+    print local[2];
+    print pointer[1 + 1] + pointer[0];
+    return 0;
+}
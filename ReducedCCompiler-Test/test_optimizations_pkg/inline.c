@@ -0,0 +1,54 @@
+int g;
+
+int side(int x)
+{
+    print x;
+    return x;
+}
+
+int add(int a, int b) { return a + b; }
+int square(int x) { return x * x; }
+int twice_plus(int x, int y) { return add(x, x) + y; }
+int incr_global(int x) { return g = g + x; }
+int increment(int x) { return x = x + 1; }
+int deref(int p) { return *p; }
+int address_of(int x) { return *&x; }
+int ignore_first(int a, int b) { return b; }
+// The argument of the inlined call is bound to a variable of these functions
+int square_next(int y) { return square(y + 1); }
+int square_next_sum(int z) { return square_next(z * 2) + square_next(z); }
+
+int factorial(int n)
+{
+    if (n <= 1)
+        return 1;
+    return n * factorial(n - 1);
+}
+
+int recursive(int n) { return n && recursive(n - 1) + 2; }
+
+int main()
+{
+    int x = 3;
+    int y = 4;
+    print add(x, y);
+    print add(2, 5);
+    print square(x + 1);
+    print square(side(5));
+    print twice_plus(x, y);
+    print add(side(1), side(2));
+    print add(x, x = 10);
+    print x;
+    print incr_global(3);
+    print incr_global(g);
+    print increment(x);
+    print x;
+    print deref(&y);
+    print address_of(7);
+    print ignore_first(side(8), 9);
+    print factorial(5);
+    print recursive(4);
+    print square(square(2));
+    print square_next(x);
+    print square_next_sum(side(1));
+}
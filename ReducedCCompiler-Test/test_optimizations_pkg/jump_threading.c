@@ -0,0 +1,65 @@
+int classify(int x)
+{
+    if (x < 0)
+        return -1;
+    else if (x == 0)
+        return 0;
+    else if (x < 10)
+    {
+        if (x % 2 == 0)
+            return 2;
+        else
+            return 1;
+    }
+    return 10;
+}
+
+int main()
+{
+    print classify(-5);
+    print classify(0);
+    print classify(4);
+    print classify(7);
+    print classify(12);
+
+    int total = 0;
+    for (int i = 0; i < 10; i = i + 1)
+    {
+        if (i == 2)
+            continue;
+        for (int j = 0; j < 10; j = j + 1)
+        {
+            if (j > i)
+                break;
+            if (j == 1)
+                continue;
+            total = total + j;
+        }
+        if (i == 7)
+            break;
+    }
+    print total;
+
+    int n = 0;
+    while (1)
+    {
+        n = n + 1;
+        if (n < 5)
+        {
+        }
+        else
+            break;
+    }
+    print n;
+
+    do
+    {
+        if (n > 2)
+        {
+            n = n - 1;
+            continue;
+        }
+        break;
+    } while (1);
+    print n;
+}
@@ -0,0 +1,66 @@
+int g;
+int h;
+
+int bump()
+{
+    g = g + 1;
+    return g;
+}
+
+int main()
+{
+    int n = 3;
+    int sum = 0;
+    g = 5;
+    h = 7;
+
+    // Invariant global and local arithmetic
+    for (int i = 0; i < n * 2; i += 1)
+    {
+        sum = sum + g * h + n / 2;
+    }
+    print sum;
+
+    // Invariant condition of a do-while loop
+    int k = 0;
+    do
+        k = k + 1;
+    while (k < h + n);
+    print k;
+
+    // A global modified by a called function isn't invariant
+    int count = 0;
+    while (g < 10)
+    {
+        count = count + g;
+        bump();
+    }
+    print count;
+
+    // A local modified through a pointer isn't invariant
+    int m = 1;
+    int p = &m;
+    int j = 0;
+    while (j < 4)
+    {
+        print m * 10;
+        *p = *p + 1;
+        j = j + 1;
+    }
+
+    // Division by a variable that may be zero must stay in the loop
+    int zero = 0;
+    while (zero != 0 && 10 / zero > 1)
+        print 100;
+
+    // Nested loops
+    int total = 0;
+    for (int a = 0; a < 3; a += 1)
+    {
+        for (int b = 0; b < h - 4; b += 1)
+        {
+            total = total + a * h + g;
+        }
+    }
+    print total;
+}
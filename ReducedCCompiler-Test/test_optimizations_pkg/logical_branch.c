@@ -0,0 +1,63 @@
+int calls;
+
+int side(int x)
+{
+    calls = calls + 1;
+    return x;
+}
+
+int test(int a, int b, int c)
+{
+    int mask = 0;
+    if (a && b)              mask = mask + 1;
+    if (a || b)              mask = mask + 2;
+    if (!(a && b))           mask = mask + 4;
+    if (!(a || b))           mask = mask + 8;
+    if (a < b && b < c)      mask = mask + 16;
+    if (a > b || b > c)      mask = mask + 32;
+    if ((a || b) && !c)      mask = mask + 64;
+    if (a && (b || c))       mask = mask + 128;
+    if (a == 0 || b == 0 && c == 0)
+        mask = mask + 256;
+    else
+        mask = mask + 512;
+    return mask;
+}
+
+int main()
+{
+    print test(0, 0, 0);
+    print test(1, 0, 0);
+    print test(0, 1, 2);
+    print test(1, 2, 3);
+    print test(3, 2, 1);
+
+    // Short-circuit evaluation is kept for operands with side effects
+    if (0 && side(1))
+        print 1000;
+    if (1 || side(1))
+        print 2000;
+    while (side(0) && side(1))
+        print 3000;
+    print calls;
+
+    // Value contexts
+    int a = 5;
+    int b = 0;
+    print a && b;
+    print a || b;
+    print b || a - 5;
+    print a && a * 2 > 9;
+    print b && 10 / b;
+    print a || side(0);
+    print calls;
+
+    int i = 0;
+    int n = 0;
+    while (i < 10 && !(i > 6 || n > 100))
+    {
+        n = n + i;
+        i = i + 1;
+    }
+    print n;
+}
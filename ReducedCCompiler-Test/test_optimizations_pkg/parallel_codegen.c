@@ -0,0 +1,84 @@
+// Compiled with -j 4 : the functions are generated by several threads,
+// the labels must be numbered as when they are generated in order
+int total;
+
+int count_multiples(int n, int divisor)
+{
+    int count = 0;
+    int i;
+    for (i = 1; i <= n; i = i + 1)
+    {
+        if (i % divisor == 0)
+            count = count + 1;
+    }
+    return count;
+}
+
+int classify(int x)
+{
+    if (x < 0)
+        return -1;
+    else if (x == 0)
+        return 0;
+    else if (x < 10 && x % 2 == 0)
+        return 2;
+    return 1;
+}
+
+int in_ranges(int x)
+{
+    int matched = 0;
+    if ((x > 3 && x < 8) || (x > 20 && x < 25))
+        matched = 1;
+    return matched;
+}
+
+int collatz_steps(int n)
+{
+    int steps = 0;
+    while (n != 1)
+    {
+        if (n % 2 == 0)
+            n = n / 2;
+        else
+            n = 3 * n + 1;
+        steps = steps + 1;
+    }
+    return steps;
+}
+
+int first_square_above(int limit)
+{
+    int i = 0;
+    while (1)
+    {
+        i = i + 1;
+        if (i * i <= limit)
+            continue;
+        break;
+    }
+    return i;
+}
+
+int add_to_total(int value)
+{
+    total = total + value;
+    return total;
+}
+
+int main()
+{
+    print count_multiples(100, 7);
+    print classify(-5);
+    print classify(0);
+    print classify(4);
+    print classify(11);
+    int i;
+    for (i = 0; i < 26; i = i + 5)
+        print in_ranges(i);
+    print collatz_steps(27);
+    print first_square_above(50);
+    add_to_total(40);
+    print add_to_total(2);
+    return 0;
+}
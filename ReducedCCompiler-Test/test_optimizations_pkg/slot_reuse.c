@@ -0,0 +1,23 @@
+// The values of x and y used twice are stored, a frame slot is reused once its value is dead
+// so that the recursion stays within the memory of the machine
+int depth(int n)
+{
+    int x = n;
+    int y = n;
+    x = x * x + x;
+    y = y + x * y;
+    x = x - y * x;
+    y = y * x - y;
+    x = x + y - x;
+    y = y - x + y;
+    x = x * y - x;
+    y = x - y;
+    if (n == 0)
+        return 0;
+    return depth(n - 1) + 1 + (x - x) + (y - y);
+}
+
+int main()
+{
+    print depth(7000);
+}
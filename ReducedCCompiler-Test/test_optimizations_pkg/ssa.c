@@ -0,0 +1,96 @@
+int counter;
+int trace;
+
+int next()
+{
+    counter = counter + 1;
+    return counter;
+}
+
+int fib(int n)
+{
+    int a = 0;
+    int b = 1;
+    while (n > 0)
+    {
+        // The two values are swapped on the back edge
+        int tmp = a;
+        a = b;
+        b = tmp + b;
+        n = n - 1;
+    }
+    return a;
+}
+
+int sum_to(int n, int acc)
+{
+    if (n == 0)
+        return acc;
+    return sum_to(n - 1, acc + n);
+}
+
+int main()
+{
+    // Constant on every path
+    int x = 4;
+    int y;
+    if (x > 3)
+        y = x * 2;
+    else
+        y = x + 100;
+    print y;
+
+    int k = 0;
+    int flag = 1;
+    while (k < 10)
+    {
+        if (flag == 0)
+            print 999;
+        k = k + 1;
+    }
+    print k;
+
+    // Same value computed twice
+    int p = k * k + y;
+    int q = y + k * k;
+    print p - q;
+    print p;
+
+    // Side effects keep their order
+    print next() - next();
+    int first = next();
+    counter = 100;
+    print first;
+    print counter;
+    trace = counter;
+    counter = 0;
+    print trace + counter;
+
+    // Pointers and globals
+    int address = &trace;
+    *address = 42;
+    print trace;
+    *address = *address + 1;
+    print *address;
+
+    print fib(10);
+    print fib(1);
+    print sum_to(100, 0);
+
+    int i;
+    int total = 0;
+    for (i = 0; i < 5; i = i + 1)
+    {
+        int j = 0;
+        do
+        {
+            total = total + i * j;
+            j = j + 1;
+        } while (j <= i);
+    }
+    print total;
+
+    print (k > 5 && next() > 0) + (k < 5 || next() < 0);
+    print counter;
+    return 0;
+}
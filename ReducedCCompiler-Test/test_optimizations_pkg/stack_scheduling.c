@@ -0,0 +1,51 @@
+int g;
+
+int collatz_steps(int n)
+{
+    int steps = 0;
+    while (n != 1)
+    {
+        if (n % 2 == 0)
+            n = n / 2;
+        else
+            n = 3 * n + 1;
+        steps = steps + 1;
+    }
+    return steps;
+}
+
+int main()
+{
+    int a;
+    int b = 3;
+    int c;
+    a = b + 1;
+    c = a * 2;
+    print c + a;
+
+    // Chained assignments keep the value on the stack
+    a = b = c = 7;
+    print a + b + c;
+
+    g = a;
+    g = g + 1;
+    print g;
+
+    int address = &g;
+    *address = *address * 3;
+    print g;
+
+    int x = 1;
+    int y = 2;
+    int i;
+    for (i = 0; i < 6; i = i + 1)
+    {
+        int t = x;
+        x = y;
+        y = t + y;
+        print y;
+    }
+
+    print collatz_steps(27);
+    return 0;
+}
@@ -0,0 +1,64 @@
+// The declarations alternate between functions and globals :
+// the functions are generated before the number of global variables is known
+int counter;
+const int STEP = 3;
+
+int next()
+{
+    counter = counter + STEP;
+    return counter;
+}
+
+int table[5];
+int after_table = 7;
+
+int square(int x)
+{
+    return x * x;
+}
+
+int fill(int n)
+{
+    int i;
+    for (i = 0; i < n; i = i + 1)
+        table[i] = square(i) + after_table;
+    return table[n - 1];
+}
+
+const int LIMIT = 100;
+int history[4];
+int last;
+
+int sum_to(int n, int accumulator)
+{
+    if (n == 0)
+        return accumulator;
+    return sum_to(n - 1, accumulator + n);
+}
+
+int record(int value)
+{
+    last = value;
+    history[value % 4] = value;
+    return value < LIMIT;
+}
+
+int main()
+{
+    print next();
+    print next();
+    print fill(5);
+    int i;
+    for (i = 0; i < 5; i = i + 1)
+        print table[i];
+    print after_table;
+    print sum_to(10, 0);
+    while (record(next()))
+    {
+    }
+    print last;
+    for (i = 0; i < 4; i = i + 1)
+        print history[i];
+    print &history[3] - &table[0];
+    return 0;
+}
@@ -0,0 +1,36 @@
+int scale(int x)
+{
+    return x * 8;
+}
+
+int main()
+{
+    print scale(5);
+    print scale(-3);
+    print 4 * scale(1);
+
+    int i;
+    int evens = 0;
+    int multiples_of_4 = 0;
+    for (i = -10; i <= 10; i = i + 1)
+    {
+        if (i % 2 == 0)
+            evens = evens + 1;
+        if (!(i % 4))
+            multiples_of_4 = multiples_of_4 + 1;
+        if (i % 8)
+        {
+        }
+        else
+            print i * 2;
+    }
+    print evens;
+    print multiples_of_4;
+
+    // Values of the modulo and of the division are kept
+    print -7 % 4;
+    print (0 - i) % 4;
+    print (0 - i) / 4;
+    print (i % 2 != 0) + (i * 1024);
+    return 0;
+}
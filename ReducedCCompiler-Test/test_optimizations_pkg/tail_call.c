@@ -0,0 +1,70 @@
+int g;
+
+int sum(int n, int acc)
+{
+    if (n == 0)
+        return acc;
+    return sum(n - 1, acc + n);
+}
+
+int gcd(int a, int b)
+{
+    if (b == 0)
+        return a;
+    else
+        return gcd(b, a % b);
+}
+
+// The arguments are evaluated before any parameter is overwritten
+int swap_count(int a, int b, int n)
+{
+    if (n == 0)
+    {
+        print a;
+        print b;
+        return 0;
+    }
+    return swap_count(b, a, n - 1);
+}
+
+int count_down(int n)
+{
+    while (1)
+    {
+        if (n <= 0)
+            return 0;
+        g = g + 1;
+        return count_down(n - 1);
+    }
+}
+
+// Not a tail call : the address of a local is given to the callee
+int by_address(int p, int n)
+{
+    int x = *p + n;
+    if (n == 0)
+        return x;
+    return by_address(&x, n - 1);
+}
+
+// Not a tail call : the callee reads the local array of its caller
+int by_array(int p, int n)
+{
+    int values[1];
+    values[0] = n * 10;
+    if (n == 0)
+        return p[0];
+    return by_array(values, n - 1);
+}
+
+int main()
+{
+    print sum(5000, 0);
+    print gcd(1071, 462);
+    swap_count(1, 2, 3);
+    count_down(4000);
+    print g;
+    int start = 1;
+    print by_address(&start, 4);
+    print by_array(0, 1);
+}
@@ -0,0 +1,85 @@
+int before;
+int squares[6];
+int after;
+
+int sum(int values, int nb_values)
+{
+    int total = 0;
+    int i;
+    for (i = 0; i < nb_values; i = i + 1)
+        total = total + values[i];
+    return total;
+}
+
+// Each call has its own copy of the local array
+int depth(int n)
+{
+    int digits[3];
+    digits[0] = n;
+    digits[1] = n * 10;
+    digits[2] = n * 100;
+    if (n > 0)
+        depth(n - 1);
+    return digits[0] + digits[1] + digits[2];
+}
+
+int main()
+{
+    int x = 1;
+    int values[5];
+    int y = 2;
+
+    before = -1;
+    after = -2;
+    int i;
+    for (i = 0; i < 6; i = i + 1)
+        squares[i] = i * i;
+    print sum(squares, 6);
+
+    values[0] = 5;
+    values[1] = 3;
+    values[2] = 4;
+    values[3] = 1;
+    values[4] = 2;
+
+    // Bubble sort
+    int j;
+    for (i = 0; i < 5; i = i + 1)
+    {
+        for (j = 0; j + 1 < 5 - i; j = j + 1)
+        {
+            if (values[j] > values[j + 1])
+            {
+                int tmp = values[j];
+                values[j] = values[j + 1];
+                values[j + 1] = tmp;
+            }
+        }
+    }
+    for (i = 0; i < 5; i = i + 1)
+        print values[i];
+
+    // The neighbouring variables are untouched
+    print x;
+    print y;
+    print before;
+    print after;
+
+    values[2] += 10;
+    print values[2];
+    *(values + 4) = 42;
+    print values[4];
+    print *values;
+    print &values[3] - values;
+    print &squares == squares;
+
+    print depth(3);
+
+    {
+        int inner[2];
+        inner[0] = 7;
+        inner[1] = 8;
+        print inner[0] * inner[1];
+    }
+    return 0;
+}
@@ -0,0 +1,10 @@
+// Each array fits in the memory, not both of them
+int g[40000];
+int h[40000];
+
+int main()
+{
+    g[0] = 1;
+    h[0] = 2;
+    print g[0] + h[0];
+}
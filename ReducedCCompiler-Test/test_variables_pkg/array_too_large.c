@@ -0,0 +1,7 @@
+// The frame of the function can't hold the array
+int main()
+{
+    int a[2000000];
+    a[0] = 1;
+    print a[0];
+}
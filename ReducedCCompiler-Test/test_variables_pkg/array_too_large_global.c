@@ -0,0 +1,8 @@
+// The data segment can't hold the array
+int g[70000];
+
+int main()
+{
+    g[0] = 1;
+    print g[0];
+}
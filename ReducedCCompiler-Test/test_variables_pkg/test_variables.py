@@ -9,11 +9,14 @@ import tests_utils as tu
 def test_variables():
     LOG_DIR = "logs"
 
-    FILE_PREFIXES = ["variables", "global_var", "address_of_global", "address_of_cancel_deref", "pointer"]
+    FILE_PREFIXES = ["variables", "global_var", "address_of_global", "address_of_cancel_deref", "pointer", "array"]
+    # Programs whose compilation fails, the diagnostics are compared to their reference
+    FAILING_PREFIXES = ["array_too_large", "array_too_large_global", "array_globals_overflow"]
     
     TEST_EXT    = ".c"
     MSM_EXT     = ".msm"
     EXEC_SUFFIX = "_exec"
+    ERR_SUFFIX  = "_err"
     OUT_EXT     = ".txt"
     REF_EXT     = ".ref"
 
@@ -68,6 +71,27 @@ def test_variables():
         skip_next = False
         test_nb += 1
 
+    for prefix in FAILING_PREFIXES:
+        test_filename = prefix + TEST_EXT
+        args = [tu.RCC_PATH, "--no-runtime", test_filename, "-o", prefix + MSM_EXT]
+        desc = "Compiling " + test_filename + " (expected failure)"
+        out_filename = LOG_DIR + "/out_" + str(test_nb) + ".txt"
+        err_filename = prefix + ERR_SUFFIX + OUT_EXT
+        success = tu.test_run_process(desc, args, test_nb, out_filename=out_filename, err_filename=err_filename, expect_failure=True)
+
+        if not success:
+            nb_errors += 1
+            skip_next = True
+
+        test_nb += 1
+        success = tu.test_compare_files(err_filename, err_filename + REF_EXT, test_nb, skip_test=skip_next)
+
+        if not success:
+            nb_errors += 1
+
+        skip_next = False
+        test_nb += 1
+
     return nb_errors
 
 if __name__ == "__main__":
@@ -4,6 +4,7 @@ import subprocess
 # TODO: Should be passed as options to the test script or retrieved from env variables
 RCC_PATH = "../../c-msm/bin/rcc"
 MSM_PATH = "../../c-msm/bin/msm"
+MSMLD_PATH = "../../c-msm/bin/msmld"
 RUNTIME_PATH = "../../c-msm/ReducedCCompiler/runtime.c"
 
 
@@ -63,7 +64,7 @@ def test_compare_files(file_to_compare, reference_file, test_nb, skip_test=False
     return success
 
 
-def test_run_process(description, args, test_nb, out_filename, err_filename, in_filename=None, skip_test=False):
+def test_run_process(description, args, test_nb, out_filename, err_filename, in_filename=None, skip_test=False, expect_failure=False):
     success = True
 
     test_nb_str = convert_test_nb_to_string(test_nb)
@@ -83,7 +84,7 @@ def test_run_process(description, args, test_nb, out_filename, err_filename, in_
                 process = subprocess.Popen(args, env=os.environ, stdin=to_exec_file, stdout=result_file, stderr=err_file)
                 ret_code = process.wait()
         
-        if ret_code == 0:
+        if (ret_code == 0) != expect_failure:
             print("\r[" + test_nb_str + "] : " + to_bold_success("OK") + " : " + description, end="\n")
         else:
             print("\r[" + test_nb_str + "] : " + to_bold_error("KO") + " : " + description, end="\n")
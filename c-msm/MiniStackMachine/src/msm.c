@@ -53,7 +53,10 @@ enum {
     op_cmpeq,     op_cmpne,     op_cmplt,     op_cmple,     op_cmpgt,
     op_cmpge,     op_jump,      op_jumpt,     op_jumpf,     op_prep,
     op_call,      op_ret,       op_resn,      op_send,      op_recv,
-    op_dbg,       op_halt
+    op_jeq,       op_jne,       op_jlt,       op_jle,       op_jgt,
+    op_jge,       op_shl,       op_shr,       op_band,      op_bor,
+    op_bxor,      op_bnot,      op_readx,     op_writex,    op_getx,
+    op_setx,      op_fill,      op_copy,      op_dbg,       op_halt
 };
 struct {
     char *name;
@@ -65,7 +68,10 @@ struct {
     {"cmpeq", 0}, {"cmpne", 0}, {"cmplt", 0}, {"cmple", 0}, {"cmpgt", 0},
     {"cmpge", 0}, {"jump",  2}, {"jumpt", 2}, {"jumpf", 2}, {"prep",  2},
     {"call",  1}, {"ret",   0}, {"resn",  1}, {"send",  0}, {"recv",  0},
-    {"dbg",   0}, {"halt",  0}
+    {"jeq",   2}, {"jne",   2}, {"jlt",   2}, {"jle",   2}, {"jgt",   2},
+    {"jge",   2}, {"shl",   0}, {"shr",   0}, {"band",  0}, {"bor",   0},
+    {"bxor",  0}, {"bnot",  0}, {"readx", 0}, {"writex",0}, {"getx",  1},
+    {"setx",  1}, {"fill",  0}, {"copy",  0}, {"dbg",   0}, {"halt",  0}
 };
 
 typedef struct lbl_s lbl_t;
@@ -189,6 +195,16 @@ int main(int argc, char *argv[]) {
         case op_set:    mem[bp - mem[pc++] - 1] = mem[sp++]; break;
         case op_read:   mem[tp] = mem[mem[tp]];              break;
         case op_write:  mem[mem[tp]] = mem[nx]; sp += 2;     break;
+        case op_readx:  mem[nx] = mem[mem[nx] + mem[tp]]; sp++;           break;
+        case op_writex: mem[mem[nx] + mem[tp]] = mem[nx + 1]; sp += 3;    break;
+        case op_getx:   mem[tp] = mem[bp - mem[pc++] - 1 + mem[tp]];      break;
+        case op_setx:   mem[bp - mem[pc++] - 1 + mem[tp]] = mem[nx]; sp += 2; break;
+        case op_fill:   for (i = 0; i < mem[nx]; i++)        // address, count, value
+                            mem[mem[nx + 1] + i] = mem[tp];
+                        sp += 3;                             break;
+        case op_copy:   if (mem[tp] > 0)                     // destination, source, count
+                            memmove(&mem[mem[nx + 1]], &mem[mem[nx]], sizeof(int) * mem[tp]);
+                        sp += 3;                             break;
         case op_add:    mem[nx] = mem[nx] +  mem[tp]; sp++;  break;
         case op_sub:    mem[nx] = mem[nx] -  mem[tp]; sp++;  break;
         case op_mul:    mem[nx] = mem[nx] *  mem[tp]; sp++;  break;
@@ -203,9 +219,21 @@ int main(int argc, char *argv[]) {
         case op_cmple:  mem[nx] = mem[nx] <= mem[tp]; sp++;  break;
         case op_cmpgt:  mem[nx] = mem[nx] >  mem[tp]; sp++;  break;
         case op_cmpge:  mem[nx] = mem[nx] >= mem[tp]; sp++;  break;
+        case op_shl:    mem[nx] = (int) ((unsigned) mem[nx] << (mem[tp] & 31)); sp++; break;
+        case op_shr:    mem[nx] = mem[nx] >> (mem[tp] & 31); sp++; break;
+        case op_band:   mem[nx] = mem[nx] &  mem[tp]; sp++;  break;
+        case op_bor:    mem[nx] = mem[nx] |  mem[tp]; sp++;  break;
+        case op_bxor:   mem[nx] = mem[nx] ^  mem[tp]; sp++;  break;
+        case op_bnot:   mem[tp] =~mem[tp];                   break;
         case op_jump:   pc =                 mem[pc];        break;
         case op_jumpt:  pc = ( mem[sp++] ? mem[pc] : pc+1);  break;
         case op_jumpf:  pc = (!mem[sp++] ? mem[pc] : pc+1);  break;
+        case op_jeq:    pc = (mem[nx] == mem[tp] ? mem[pc] : pc+1); sp += 2; break;
+        case op_jne:    pc = (mem[nx] != mem[tp] ? mem[pc] : pc+1); sp += 2; break;
+        case op_jlt:    pc = (mem[nx] <  mem[tp] ? mem[pc] : pc+1); sp += 2; break;
+        case op_jle:    pc = (mem[nx] <= mem[tp] ? mem[pc] : pc+1); sp += 2; break;
+        case op_jgt:    pc = (mem[nx] >  mem[tp] ? mem[pc] : pc+1); sp += 2; break;
+        case op_jge:    pc = (mem[nx] >= mem[tp] ? mem[pc] : pc+1); sp += 2; break;
         case op_prep:   mem[--sp] = mem[pc++];
                         mem[--sp] = bp;                      break;
         case op_call:   bp = sp + mem[pc++];
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/token.h"
+
+/*
+* Compares the classification of the scanned words by the perfect hash of the tokenizer
+* with the previous method : copy of the word then comparison with every keyword.
+*/
+
+#define NB_WORDS     (1 << 20)
+#define MIN_DURATION 0.5 // Seconds per method
+
+typedef struct Word_s Word;
+struct Word_s
+{
+    const char* text;
+    int         size;
+};
+
+// Identifier-heavy corpus, about one word out of four is a keyword
+static const char* VOCABULARY[] =
+{
+    "int", "if", "else", "for", "while", "do", "break", "continue", "return", "print", "const",
+    "i", "j", "n", "x", "ptr", "size", "value", "index", "result", "buffer", "nb_elements",
+    "accumulated_values", "current_index", "threshold", "count_greater_values", "interface",
+    "double_value", "constant", "printer", "returned", "format", "whilst", "elsewhere",
+    "malloc", "free", "printn", "println", "main", "left", "right", "node", "next", "previous",
+};
+
+static int classify_with_strcmp(const char* word, int size)
+{
+    char* text = malloc(size + 1);
+    if (text == NULL)
+    {
+        perror("Failed to allocate memory for a word");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(text, word, size);
+    text[size] = '\0';
+
+    int type = TOK_IDENTIFIER;
+    if      (strcmp(text, "int") == 0)       type = TOK_INT;
+    else if (strcmp(text, "if") == 0)        type = TOK_IF;
+    else if (strcmp(text, "else") == 0)      type = TOK_ELSE;
+    else if (strcmp(text, "for") == 0)       type = TOK_FOR;
+    else if (strcmp(text, "while") == 0)     type = TOK_WHILE;
+    else if (strcmp(text, "do") == 0)        type = TOK_DO;
+    else if (strcmp(text, "break") == 0)     type = TOK_BREAK;
+    else if (strcmp(text, "continue") == 0)  type = TOK_CONTINUE;
+    else if (strcmp(text, "return") == 0)    type = TOK_RETURN;
+    else if (strcmp(text, "print") == 0)     type = TOK_PRINT;
+    else if (strcmp(text, "const") == 0)     type = TOK_CONST_SPECIFIER;
+    else if (strcmp(text, "extern") == 0)    type = TOK_EXTERN;
+
+    // The text of an identifier is given to the syntactic tree, it is freed here to only measure the classification
+    free(text);
+    return type;
+}
+
+static int classify_with_hash(const char* word, int size)
+{
+    return token_keyword_type(word, size);
+}
+
+// Classifies the corpus until the minimum duration is reached, returns the number of words per second
+// The checksum is the sum of the types of the words of the corpus
+static double measure(int (*classify)(const char*, int), const Word* words, long* checksum)
+{
+    long nb_classified = 0;
+    clock_t start = clock();
+    double duration;
+    do
+    {
+        *checksum = 0;
+        for (int i = 0; i < NB_WORDS; i++)
+            *checksum += classify(words[i].text, words[i].size);
+        nb_classified += NB_WORDS;
+        duration = (double) (clock() - start) / CLOCKS_PER_SEC;
+    }
+    while (duration < MIN_DURATION);
+    return nb_classified / duration;
+}
+
+int main(void)
+{
+    const int vocabulary_size = sizeof(VOCABULARY) / sizeof(VOCABULARY[0]);
+    Word* words = malloc(sizeof(Word) * NB_WORDS);
+    if (words == NULL)
+    {
+        perror("Failed to allocate memory for the corpus");
+        exit(EXIT_FAILURE);
+    }
+    srand(42);
+    for (int i = 0; i < NB_WORDS; i++)
+    {
+        words[i].text = VOCABULARY[rand() % vocabulary_size];
+        words[i].size = (int) strlen(words[i].text);
+    }
+
+    long strcmp_checksum, hash_checksum;
+    double strcmp_rate = measure(classify_with_strcmp, words, &strcmp_checksum);
+    double hash_rate   = measure(classify_with_hash, words, &hash_checksum);
+    if (strcmp_checksum != hash_checksum)
+    {
+        fprintf(stderr, "The two methods don't give the same classification\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("copy + strcmp : %7.1f M words/s\n", strcmp_rate / 1e6);
+    printf("perfect hash  : %7.1f M words/s (x%.1f)\n", hash_rate / 1e6, hash_rate / strcmp_rate);
+
+    free(words);
+    return EXIT_SUCCESS;
+}
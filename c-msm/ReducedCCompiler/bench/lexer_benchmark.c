@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/token.h"
+
+/*
+* Measures the throughput of the tokenizer in MB/s on a source file given as argument,
+* or on a generated source made of comments, indented code and long identifiers.
+*/
+
+#define GENERATED_SIZE (8 * 1024 * 1024)
+#define MIN_DURATION   1.0 // Seconds
+
+static const char* GENERATED_PATTERN =
+    "/*\n"
+    " * Returns the number of elements of the accumulated_values array that are\n"
+    " * greater than the threshold given as parameter, the array isn't modified.\n"
+    " */\n"
+    "int count_greater_values(int accumulated_values, int nb_accumulated_values, int threshold)\n"
+    "{\n"
+    "    int number_of_greater_values = 0;\n"
+    "    int current_index;\n"
+    "    for (current_index = 0; current_index < nb_accumulated_values; current_index += 1)\n"
+    "    {\n"
+    "        // Values equal to the threshold aren't counted\n"
+    "        if (accumulated_values[current_index] > threshold)\n"
+    "            number_of_greater_values = number_of_greater_values + 1;\n"
+    "    }\n"
+    "    return number_of_greater_values;\n"
+    "}\n"
+    "\n";
+
+static char* generate_source(void)
+{
+    size_t pattern_length = strlen(GENERATED_PATTERN);
+    size_t nb_patterns = GENERATED_SIZE / pattern_length;
+    char* source = malloc(nb_patterns * pattern_length + 1);
+    if (source == NULL)
+    {
+        perror("Failed to allocate memory for the generated source");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < nb_patterns; i++)
+        memcpy(source + i * pattern_length, GENERATED_PATTERN, pattern_length);
+    source[nb_patterns * pattern_length] = '\0';
+    return source;
+}
+
+static char* load_source(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        perror("Failed to open the source file");
+        exit(EXIT_FAILURE);
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+
+    char* source = malloc(size + 1);
+    if (source == NULL || fread(source, 1, size, file) != (size_t) size)
+    {
+        perror("Failed to read the source file");
+        exit(EXIT_FAILURE);
+    }
+    source[size] = '\0';
+    fclose(file);
+    return source;
+}
+
+// Tokenizes the whole source, returns the number of tokens
+static long tokenize(char* source)
+{
+    long nb_tokens = 0;
+    Tokenizer tokenizer = tokenizer_create(source);
+    do
+    {
+        tokenizer_step(&tokenizer);
+        // The identifiers are owned by the caller of the tokenizer
+        if (tokenizer.current.type == TOK_IDENTIFIER)
+            free(tokenizer.current.value.str_val);
+        nb_tokens++;
+    }
+    while (tokenizer.next.type != TOK_EOF);
+    return nb_tokens;
+}
+
+int main(int argc, char* argv[])
+{
+    char* source = (argc > 1) ? load_source(argv[1]) : generate_source();
+    size_t size = strlen(source);
+
+    long nb_tokens = 0;
+    int nb_runs = 0;
+    clock_t start = clock();
+    double duration;
+    do
+    {
+        nb_tokens = tokenize(source);
+        nb_runs++;
+        duration = (double) (clock() - start) / CLOCKS_PER_SEC;
+    }
+    while (duration < MIN_DURATION);
+
+    printf("%zu bytes, %ld tokens, %d runs in %.2f s : %.1f MB/s\n",
+           size, nb_tokens, nb_runs, duration, (double) size * nb_runs / duration / (1024 * 1024));
+
+    free(source);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,476 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "argtable3/argtable3.h"
+
+#include "../src/object_file.h"
+#include "../src/source_buffer.h"
+
+/*
+* Links the object files compiled by 'rcc --object' into a program of the Mini Stack Machine.
+* The global variables of the modules are laid out one module after the other in the data segment,
+* the extern variables of a module take the offset of their definition in another module.
+* The labels that aren't functions are suffixed by the index of their module, so that the modules can't clash.
+* The program starts by the initializations of the modules, then calls _Init() when a module defines it, then main().
+*/
+
+#define MSMLD_NAME          "msmld"
+#define MSMLD_LONG_NAME     "Mini Stack Machine Linker"
+#define MSMLD_VERSION       "0.1"
+
+#define MAX_INPUT_FILES     16384
+#define MAX_LINE_LENGTH     4096 // Same as msm
+#define MAX_OPCODE_LENGTH   16
+#define INIT_FUNCTION       "_Init"
+#define MAIN_FUNCTION       "main"
+
+enum
+{
+    SYMBOL_GLOBAL,      // Global variable defined by the module
+    SYMBOL_EXTERN,      // Global variable defined by another module
+    SYMBOL_EXPORT,      // Function defined by the module
+    SYMBOL_IMPORT,      // Function defined by another module
+};
+
+typedef struct ObjectSymbol_s ObjectSymbol;
+struct ObjectSymbol_s
+{
+    char* name;
+    int   kind;
+    int   value;        // Offset of a variable in its module, number of parameters of a function
+    int   module;       // Index of the module in the command line
+};
+
+// Open addressing hash table of symbols by name
+typedef struct SymbolIndex_s SymbolIndex;
+struct SymbolIndex_s
+{
+    const ObjectSymbol** slots;
+    int                  size;      // Power of 2
+    int                  nb_symbols;
+};
+
+typedef struct Module_s Module;
+struct Module_s
+{
+    const char*   filename;
+    SourceBuffer  source;
+    const char*   init;             // Code initializing the global variables
+    const char*   init_end;         // Directive that starts the code of the functions
+    const char*   code;             // Code of the functions, up to the end of the file
+    ObjectSymbol* symbols;
+    int           nb_symbols;
+    int           nb_globals;
+    int*          linked_offsets;   // Offset in the data segment of the program of each global variable of the module
+    SymbolIndex   functions;        // Functions defined or imported by the module, their labels are kept
+};
+
+static int nb_link_errors = 0;
+
+static void link_error(const char* format, const char* name, const char* filename)
+{
+    fprintf(stderr, "%s: error. ", MSMLD_NAME);
+    fprintf(stderr, format, name, filename);
+    fprintf(stderr, "\n");
+    nb_link_errors++;
+}
+
+// FNV-1a
+static unsigned long symbol_hash(const char* name)
+{
+    unsigned long hash = 2166136261UL;
+    for (; *name != '\0'; name++)
+    {
+        hash ^= (unsigned char) *name;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+static SymbolIndex symbol_index_create(int nb_symbols)
+{
+    SymbolIndex index;
+    index.size       = 16;
+    index.nb_symbols = 0;
+    while (index.size < 2 * nb_symbols)
+        index.size *= 2;
+    index.slots = calloc(index.size, sizeof(ObjectSymbol*));
+    if (index.slots == NULL)
+    {
+        perror("Failed to allocate memory for the symbols");
+        exit(EXIT_FAILURE);
+    }
+    return index;
+}
+
+static const ObjectSymbol* symbol_index_find(const SymbolIndex* index, const char* name)
+{
+    unsigned long slot = symbol_hash(name) & (index->size - 1);
+    while (index->slots[slot] != NULL)
+    {
+        if (strcmp(index->slots[slot]->name, name) == 0)
+            return index->slots[slot];
+        slot = (slot + 1) & (index->size - 1);
+    }
+    return NULL;
+}
+
+// Returns the symbol already indexed with the same name instead, the index is sized for all its symbols
+static const ObjectSymbol* symbol_index_insert(SymbolIndex* index, const ObjectSymbol* symbol)
+{
+    assert(2 * index->nb_symbols < index->size);
+
+    unsigned long slot = symbol_hash(symbol->name) & (index->size - 1);
+    while (index->slots[slot] != NULL)
+    {
+        if (strcmp(index->slots[slot]->name, symbol->name) == 0)
+            return index->slots[slot];
+        slot = (slot + 1) & (index->size - 1);
+    }
+    index->slots[slot] = symbol;
+    index->nb_symbols++;
+    return NULL;
+}
+
+// Copies the line starting at 'text' without its end of line, returns the start of the next line
+static const char* read_line(const char* text, char line[MAX_LINE_LENGTH])
+{
+    size_t length = strcspn(text, "\n");
+    if (length >= MAX_LINE_LENGTH)
+        length = MAX_LINE_LENGTH - 1;
+    memcpy(line, text, length);
+    line[length] = '\0';
+    text += strcspn(text, "\n");
+    return (*text == '\n') ? text + 1 : text;
+}
+
+static bool is_directive(const char* line, const char* directive)
+{
+    size_t length = strlen(directive);
+    return strncmp(line, directive, length) == 0 && (line[length] == '\0' || line[length] == ' ');
+}
+
+// Reads the directives of the object file up to its code, returns false if it isn't an object file
+static bool module_load(Module* module, int index, const char* filename)
+{
+    FILE* file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: error. Failed to open the object file \"%s\"\n", MSMLD_NAME, filename);
+        exit(EXIT_FAILURE);
+    }
+    module->filename       = filename;
+    module->source         = source_buffer_load(file);
+    module->init           = NULL;
+    module->init_end       = NULL;
+    module->code           = NULL;
+    module->symbols        = NULL;
+    module->nb_symbols     = 0;
+    module->nb_globals     = -1;
+    module->linked_offsets = NULL;
+
+    char line[MAX_LINE_LENGTH];
+    const char* text = read_line(module->source.content, line);
+    if (strcmp(line, OBJECT_FILE_MAGIC) != 0)
+        return false;
+
+    int capacity = 0;
+    while (*text != '\0' && module->init == NULL)
+    {
+        text = read_line(text, line);
+        char directive[MAX_OPCODE_LENGTH];
+        char name[MAX_LINE_LENGTH];
+        int value;
+        if (is_directive(line, OBJECT_FILE_INIT))
+            module->init = text;
+        else if (is_directive(line, OBJECT_FILE_GLOBALS))
+        {
+            if (sscanf(line, "%*s %d", &(module->nb_globals)) != 1 || module->nb_globals < 0)
+                return false;
+        }
+        else if (sscanf(line, "%15s %4095s %d", directive, name, &value) == 3)
+        {
+            ObjectSymbol symbol;
+            if (strcmp(directive, OBJECT_FILE_GLOBAL) == 0)
+                symbol.kind = SYMBOL_GLOBAL;
+            else if (strcmp(directive, OBJECT_FILE_EXTERN) == 0)
+                symbol.kind = SYMBOL_EXTERN;
+            else if (strcmp(directive, OBJECT_FILE_EXPORT) == 0)
+                symbol.kind = SYMBOL_EXPORT;
+            else if (strcmp(directive, OBJECT_FILE_IMPORT) == 0)
+                symbol.kind = SYMBOL_IMPORT;
+            else
+                return false;
+            bool is_variable = (symbol.kind == SYMBOL_GLOBAL || symbol.kind == SYMBOL_EXTERN);
+            if (is_variable && (module->nb_globals == -1 || value < 0 || value >= module->nb_globals))
+                return false;
+
+            symbol.name = malloc(strlen(name) + 1);
+            if (symbol.name == NULL)
+            {
+                perror("Failed to allocate memory for the symbols");
+                exit(EXIT_FAILURE);
+            }
+            strcpy(symbol.name, name);
+            symbol.value  = value;
+            symbol.module = index;
+
+            if (module->nb_symbols == capacity)
+            {
+                capacity = (capacity == 0) ? 64 : 2 * capacity;
+                ObjectSymbol* reallocated_symbols = realloc(module->symbols, sizeof(ObjectSymbol) * capacity);
+                if (reallocated_symbols == NULL)
+                {
+                    perror("Failed to allocate memory for the symbols");
+                    exit(EXIT_FAILURE);
+                }
+                module->symbols = reallocated_symbols;
+            }
+            module->symbols[module->nb_symbols++] = symbol;
+        }
+        else
+            return false;
+    }
+    if (module->init == NULL || module->nb_globals == -1)
+        return false;
+
+    // The code of the functions follows the initializations
+    for (text = module->init; *text != '\0' && module->code == NULL; )
+    {
+        const char* next = read_line(text, line);
+        if (is_directive(line, OBJECT_FILE_CODE))
+        {
+            module->init_end = text;
+            module->code     = next;
+        }
+        text = next;
+    }
+    if (module->code == NULL)
+        return false;
+
+    module->functions = symbol_index_create(module->nb_symbols);
+    for (int i = 0; i < module->nb_symbols; i++)
+    {
+        const ObjectSymbol* symbol = module->symbols + i;
+        if ((symbol->kind == SYMBOL_EXPORT || symbol->kind == SYMBOL_IMPORT) && symbol_index_insert(&(module->functions), symbol) != NULL)
+            return false;
+    }
+    return true;
+}
+
+static void module_free(Module* module)
+{
+    for (int i = 0; i < module->nb_symbols; i++)
+        free(module->symbols[i].name);
+    free(module->symbols);
+    free(module->linked_offsets);
+    free(module->functions.slots);
+    source_buffer_free(&(module->source));
+}
+
+// Lays out the global variables of the modules and resolves their symbols, returns the number of global variables
+static int link_modules(Module* modules, int nb_modules, SymbolIndex* definitions)
+{
+    int nb_globals = 0;
+    int nb_definitions = 0;
+    for (int m = 0; m < nb_modules; m++)
+        nb_definitions += modules[m].nb_symbols;
+    *definitions = symbol_index_create(nb_definitions);
+
+    for (int m = 0; m < nb_modules; m++)
+    {
+        Module* module = modules + m;
+        module->linked_offsets = malloc(sizeof(int) * (module->nb_globals + (size_t) 1));
+        if (module->linked_offsets == NULL)
+        {
+            perror("Failed to allocate memory for the layout of the global variables");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < module->nb_globals; i++)
+            module->linked_offsets[i] = nb_globals + i;
+        nb_globals += module->nb_globals;
+
+        for (int i = 0; i < module->nb_symbols; i++)
+        {
+            const ObjectSymbol* symbol = module->symbols + i;
+            if (symbol->kind != SYMBOL_GLOBAL && symbol->kind != SYMBOL_EXPORT)
+                continue;
+            const ObjectSymbol* previous = symbol_index_insert(definitions, symbol);
+            if (previous != NULL)
+                link_error("Multiple definition of \"%s\", also defined by \"%s\"", symbol->name, modules[previous->module].filename);
+        }
+    }
+
+    for (int m = 0; m < nb_modules; m++)
+    {
+        Module* module = modules + m;
+        for (int i = 0; i < module->nb_symbols; i++)
+        {
+            const ObjectSymbol* symbol = module->symbols + i;
+            if (symbol->kind == SYMBOL_EXTERN)
+            {
+                const ObjectSymbol* definition = symbol_index_find(definitions, symbol->name);
+                if (definition == NULL || definition->kind != SYMBOL_GLOBAL)
+                    link_error("Undefined variable \"%s\" declared by \"%s\"", symbol->name, module->filename);
+                else
+                    module->linked_offsets[symbol->value] = modules[definition->module].linked_offsets[definition->value];
+            }
+            else if (symbol->kind == SYMBOL_IMPORT)
+            {
+                const ObjectSymbol* definition = symbol_index_find(definitions, symbol->name);
+                if (definition == NULL || definition->kind != SYMBOL_EXPORT)
+                    link_error("Undefined function \"%s()\" declared by \"%s\"", symbol->name, module->filename);
+                else if (definition->value != symbol->value)
+                    link_error("Function \"%s()\" declared by \"%s\" with another number of parameters", symbol->name, module->filename);
+            }
+        }
+    }
+
+    const ObjectSymbol* main_function = symbol_index_find(definitions, MAIN_FUNCTION);
+    if (main_function == NULL || main_function->kind != SYMBOL_EXPORT)
+        link_error("Undefined function \"%s()\"%s", MAIN_FUNCTION, "");
+
+    return nb_globals;
+}
+
+static bool is_kept_label(const Module* module, const char* label)
+{
+    return object_file_is_entry_label(label) || symbol_index_find(&(module->functions), label) != NULL;
+}
+
+// Copies the code of the module from 'text' up to 'end', the labels and the relocations of the globals are linked
+static void write_module_code(const Module* module, int index, const char* text, const char* end, int nb_globals, FILE* out_file)
+{
+    char line[MAX_LINE_LENGTH];
+    while (text < end && *text != '\0')
+    {
+        const char* next = read_line(text, line);
+        char opcode[MAX_OPCODE_LENGTH];
+        char operand[MAX_LINE_LENGTH];
+        int nb_tokens = sscanf(line, "%15s %4095s", opcode, operand);
+        if (line[0] == '.')
+        {
+            if (is_kept_label(module, line + 1))
+                fprintf(out_file, "%s\n", line);
+            else
+                fprintf(out_file, "%s.%d\n", line, index);
+        }
+        else if (nb_tokens == 2 && object_file_has_label_operand(opcode))
+        {
+            if (is_kept_label(module, operand))
+                fprintf(out_file, "        %s %s\n", opcode, operand);
+            else
+                fprintf(out_file, "        %s %s.%d\n", opcode, operand, index);
+        }
+        else if (nb_tokens == 2 && strcmp(opcode, "push") == 0 && strncmp(operand, GLOBAL_RELOCATION, strlen(GLOBAL_RELOCATION)) == 0)
+        {
+            int offset = atoi(operand + strlen(GLOBAL_RELOCATION));
+            if (offset < 0 || offset >= module->nb_globals)
+            {
+                fprintf(stderr, "%s: error. Invalid relocation \"%s\" in \"%s\"\n", MSMLD_NAME, operand, module->filename);
+                exit(EXIT_FAILURE);
+            }
+            fprintf(out_file, "        push %d\n", nb_globals - module->linked_offsets[offset]);
+        }
+        else
+            fprintf(out_file, "%s\n", line);
+        text = next;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    struct arg_file* input;
+    struct arg_file* output;
+    struct arg_lit*  help;
+    struct arg_lit*  version;
+    struct arg_end*  end;
+    void* argtable[] =
+    {
+        input   = arg_filen(NULL, NULL,     "<file>", 1, MAX_INPUT_FILES, "object files compiled by 'rcc --object'"),
+        output  = arg_filen( "o", "output", "<file>", 0, 1, "output file"),
+        help    = arg_litn(  "h", "help",             0, 1, "display this help and exit"),
+        version = arg_litn( NULL, "version",          0, 1, "display version info and exit"),
+        end     = arg_end(20),
+    };
+
+    int nb_errors = arg_parse(argc, argv, argtable);
+
+    /* special case: '--help' takes precedence over error reporting */
+    if (help->count > 0)
+    {
+        printf("%s.\n\n", MSMLD_LONG_NAME);
+        printf("Usage: %s", MSMLD_NAME);
+        arg_print_syntax(stdout, argtable, "\n");
+        arg_print_glossary(stdout, argtable, "  %-40s %s\n");
+        exit(EXIT_SUCCESS);
+    }
+    else if (version->count > 0)
+    {
+        printf("%s %s\n", MSMLD_LONG_NAME, MSMLD_VERSION);
+        exit(EXIT_SUCCESS);
+    }
+    else if (nb_errors > 0)
+    {
+        arg_print_errors(stdout, end, MSMLD_NAME);
+        printf("Try '%s --help' for more information.\n", MSMLD_NAME);
+        exit(EXIT_FAILURE);
+    }
+
+    int nb_modules = input->count;
+    Module* modules = malloc(sizeof(Module) * nb_modules);
+    if (modules == NULL)
+    {
+        perror("Failed to allocate memory for the modules");
+        exit(EXIT_FAILURE);
+    }
+    for (int m = 0; m < nb_modules; m++)
+    {
+        if ( ! module_load(modules + m, m, input->filename[m]))
+        {
+            fprintf(stderr, "%s: error. \"%s\" isn't an object file compiled by 'rcc --object'\n", MSMLD_NAME, input->filename[m]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    SymbolIndex definitions;
+    int nb_globals = link_modules(modules, nb_modules, &definitions);
+    if (nb_link_errors > 0)
+    {
+        fprintf(stderr, "%s: error. %d error%s found during the link : link aborted\n", MSMLD_NAME, nb_link_errors, (nb_link_errors == 1) ? "" : "s");
+        exit(EXIT_FAILURE);
+    }
+
+    // The output is only created once the link succeeded
+    FILE* output_file = stdout;
+    if (output->count > 0)
+    {
+        output_file = fopen(*(output->filename), "w");
+        if (output_file == NULL)
+        {
+            fprintf(stderr, "%s: error. Failed to open the output file \"%s\"\n", MSMLD_NAME, *(output->filename));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (int m = 0; m < nb_modules; m++)
+        write_module_code(modules + m, m, modules[m].code, modules[m].source.content + modules[m].source.size, nb_globals, output_file);
+
+    const ObjectSymbol* init_function = symbol_index_find(&definitions, INIT_FUNCTION);
+    object_file_write_entry_start(output_file, nb_globals);
+    for (int m = 0; m < nb_modules; m++)
+        write_module_code(modules + m, m, modules[m].init, modules[m].init_end, nb_globals, output_file);
+    object_file_write_entry_end(output_file, init_function != NULL && init_function->kind == SYMBOL_EXPORT);
+
+    fclose(output_file);
+    free(definitions.slots);
+    for (int m = 0; m < nb_modules; m++)
+        module_free(modules + m);
+    free(modules);
+    arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+
+    return EXIT_SUCCESS;
+}
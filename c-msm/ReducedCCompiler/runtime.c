@@ -80,6 +80,7 @@ int scann(int ptr_n)
 
 const int HEAP_SIZE = 16384; // 2^14
 int HEAP_START;
+int HEAP_TOP; // Next cell given by the bump allocator
 const int INVALID_POINTER = -1;
 const int NULL = 0;
 const int S_CELL_SIZE = 1;
@@ -128,6 +129,7 @@ int _Init()
     // Heap initialization
     int first_free_block = HEAP_START + 1;
     *HEAP_START = first_free_block;
+    HEAP_TOP = first_free_block;
 
     // Initialization of the first free block
     int block_size = HEAP_SIZE;
@@ -333,6 +335,160 @@ int free(int ptr)
     *nfb_prev_n_cell = new_free_block;
 }
 
+/*
+* Bump allocator, compiled as 'malloc', 'free' and 'realloc' by rcc with the --bump-malloc option.
+* Allocating only moves the top of the heap, the memory is never given back.
+*/
+int _bump_malloc(int size)
+{
+    int ptr = HEAP_TOP;
+    if (size < 1 || ptr + size > HEAP_START + 1 + HEAP_SIZE)
+        return NULL;
+    HEAP_TOP = ptr + size;
+    return ptr;
+}
+
+int _bump_free(int ptr)
+{
+    return ptr; // Nothing is released, the pointer is only returned to use the parameter
+}
+
+// The size of the block isn't known : 'size' cells are copied, the new block follows the old one in the heap
+int _bump_realloc(int ptr, int size)
+{
+    int new_ptr = malloc(size);
+    if (ptr != NULL && new_ptr != NULL)
+        memcpy(new_ptr, ptr, size);
+    return new_ptr;
+}
+
+int calloc(int nb_elements, int element_size)
+{
+    int size = nb_elements * element_size;
+    int ptr = malloc(size);
+    if (ptr != NULL)
+        memset(ptr, 0, size);
+    return ptr;
+}
+
+/*
+* The block grows in place when the block following it is free and large enough,
+* otherwise the data is copied to a new block.
+*/
+int realloc(int ptr, int size)
+{
+    if (ptr == NULL)
+        return malloc(size);
+    if (size < 1)
+    {
+        free(ptr);
+        return NULL;
+    }
+
+    if (size < DATA_SIZE_MIN)
+        size = DATA_SIZE_MIN;
+
+    int block = data_to_block_pointer(ptr);
+    int block_size = -block[S_CELL_BEG]; // size is negative in an allocated block
+    int needed_block_size = data_to_block_size(size);
+    if (needed_block_size <= block_size)
+        return ptr;
+
+    int rneighbor_block = block + block_size;
+    if (rneighbor_block < HEAP_START + HEAP_SIZE)
+    {
+        int rneighbor_size = rneighbor_block[S_CELL_BEG];
+        if (rneighbor_size > BLOCK_SIZE_MIN && block_size + rneighbor_size >= needed_block_size)
+        { // Right neighbor is free and large enough
+            int next_block = rneighbor_block[N_CELL];
+            int prev_block = rneighbor_block[compute_p_cell(rneighbor_size)];
+
+            int remaining_size = block_size + rneighbor_size - needed_block_size;
+            int link_to_next = next_block; // Block that takes the place of the neighbor in the free list
+            if (remaining_size < BLOCK_SIZE_MIN)
+            { // The whole neighbor is merged in the block
+                needed_block_size = block_size + rneighbor_size;
+            }
+            else
+            { // The end of the neighbor is a new free block
+                int new_free_block = block + needed_block_size;
+                new_free_block[S_CELL_BEG] = remaining_size;
+                new_free_block[compute_s_cell_end(remaining_size)] = remaining_size;
+                new_free_block[N_CELL] = next_block;
+                new_free_block[compute_p_cell(remaining_size)] = prev_block;
+                link_to_next = new_free_block;
+            }
+
+            if (prev_block == INVALID_POINTER)
+                *HEAP_START = link_to_next;
+            else
+                prev_block[N_CELL] = link_to_next;
+
+            if (next_block != INVALID_POINTER)
+            {
+                int next_block_size = next_block[S_CELL_BEG];
+                if (link_to_next == next_block)
+                    next_block[compute_p_cell(next_block_size)] = prev_block;
+                else
+                    next_block[compute_p_cell(next_block_size)] = link_to_next;
+            }
+
+            block[S_CELL_BEG] = -needed_block_size;
+            block[compute_s_cell_end(needed_block_size)] = -needed_block_size;
+            return ptr;
+        }
+    }
+
+    int new_ptr = malloc(size);
+    if (new_ptr == NULL)
+        return NULL;
+    memcpy(new_ptr, ptr, block_to_data_size(block_size));
+    free(ptr);
+    return new_ptr;
+}
+
+/*
+* An arena is a block allocated with malloc whose memory is handed out by
+* moving a pointer, everything it contains is freed at once by resetting it.
+* The first cells of the arena store its current top and its end.
+*/
+const int ARENA_TOP = 0;
+const int ARENA_END = 1;
+const int ARENA_HEADER_SIZE = 2;
+
+int arena_create(int size)
+{
+    if (size < 0)
+        return NULL;
+
+    int arena = malloc(ARENA_HEADER_SIZE + size);
+    if (arena == NULL)
+        return NULL;
+
+    arena[ARENA_TOP] = arena + ARENA_HEADER_SIZE;
+    arena[ARENA_END] = arena + ARENA_HEADER_SIZE + size;
+    return arena;
+}
+
+int arena_alloc(int arena, int n)
+{
+    int ptr = arena[ARENA_TOP];
+    if (n < 1 || ptr + n > arena[ARENA_END])
+        return NULL;
+    arena[ARENA_TOP] = ptr + n;
+    return ptr;
+}
+
+int arena_reset(int arena)
+{
+    arena[ARENA_TOP] = arena + ARENA_HEADER_SIZE;
+}
+
+int arena_destroy(int arena)
+{
+    free(arena);
+}
+
 int print_free_blocks_list()
 {
     int free_block = *HEAP_START;
@@ -3,130 +3,383 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "ssa.h"
+#include "thread_pool.h"
 
 #define SHORT_CIRUIT_ENABLED 1
+#define EAGER_OPERAND_MAX_SIZE 5 // Maximum number of nodes of a right operand of '&&' and '||' evaluated without jump
+
+#if defined(_MSC_VER)
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define THREAD_LOCAL __thread
+#endif
+
+/*
+* The labels are numbered in the order they are generated.
+* A function generated by a worker thread numbers its labels -1, -2, ... with its own counter :
+* they get their number when the functions are copied in the order of the program,
+* so the code is the same whatever the number of threads.
+*/
+static THREAD_LOCAL int label_counter = 0;
+static THREAD_LOCAL int is_label_relative = 0;
+
+static int new_label_number()
+{
+    return is_label_relative ? -(++label_counter) : label_counter++;
+}
+
+// Generates the code that jumps to the label '<label_prefix>_<label_number>' if the condition evaluates to 'jump_if'
+void generate_branch(SyntacticNode* condition, int jump_if, const char* label_prefix, int label_number,
+                     FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations);
+
+// Generates the code that pushes the address of a variable
+void generate_address(const SyntacticNode* node_ref, FILE * stream, int nb_global_variables);
+// Generates the 'read' of the cell pointed by the address, or the 'write' of the value below the address when 'is_write' is set
+void generate_memory_access(SyntacticNode* address, int is_write, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations);
+static int power_of_two_exponent(const SyntacticNode* node);
+// Generates the code of a value only tested against zero
+void generate_tested_value(SyntacticNode* node, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations);
+// Generates the two operands of a comparison
+void generate_compared_operands(SyntacticNode* comparison, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations);
 
-void generate_program(SyntacticNode* program, FILE * stream, int is_init_called, int nb_global_variables, SyntacticNode** global_declarations)
+void generate_program(SyntacticNode* program, FILE * stream, int is_init_called, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations, int nb_jobs)
 {
     assert(program != NULL);
 
-    #define CALL_INIT \
-        "        prep _Init"  "\n" \
-        "        call 0"
-
-    #define CALL_MAIN \
-        "        prep main"   "\n" \
-        "        call 0"
-
-    #define PUTCHAR_PRIMITIVE \
-        ".putchar"            "\n" \
-        "        send"        "\n" \
-        "        push 0"      "\n" \
-        "        ret"
-
-    #define GETCHAR_PRIMITIVE \
-        ".getchar"            "\n" \
-        "        recv"        "\n" \
-        "        ret"
-
-    #define INIT_DATA_SEGMENT \
-        "        push 0"      "\n" \
-        "        read"        "\n" \
-        "        push %d"     "\n" \
-        "        add"         "\n" \
-        "        push 0"      "\n" \
-        "        write"
-
-    generate_code(program, stream, NO_LOOP, nb_global_variables, global_declarations);
-
-    fprintf(stream, ".start"             "\n");
-    fprintf(stream, INIT_DATA_SEGMENT    "\n", nb_global_variables);
-    for (int i = 0; i < nb_global_variables; i++)
+    generate_code_parallel(program, stream, nb_global_variables, global_declarations, optimizations, nb_jobs);
+    generate_entry_point(stream, is_init_called, nb_global_variables, global_declarations, optimizations);
+}
+
+void generate_entry_point(FILE * stream, int is_init_called, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations)
+{
+    assert(nb_global_variables != UNKNOWN_NB_GLOBALS);
+
+    object_file_write_entry_start(stream, nb_global_variables);
+    generate_global_initializations(stream, nb_global_variables, nb_global_variables, global_declarations, optimizations);
+    object_file_write_entry_end(stream, is_init_called);
+}
+
+void generate_global_initializations(FILE * stream, int nb_declarations, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations)
+{
+    for (int i = 0; i < nb_declarations; i++)
     {
-        assert(global_declarations[i] != NULL);
-        generate_code(global_declarations[i], stream, NO_LOOP, nb_global_variables, NULL);
+        // The slots following the first element of an array have no declaration
+        if (global_declarations[i] != NULL)
+            generate_code(global_declarations[i], stream, NO_LOOP, nb_global_variables, NULL, optimizations);
     }
-    if (is_init_called)
-        fprintf(stream, CALL_INIT            "\n");
-    fprintf(stream, CALL_MAIN            "\n");
-    fprintf(stream, "        halt"       "\n");
-    fprintf(stream, PUTCHAR_PRIMITIVE    "\n" "\n");
-    fprintf(stream, GETCHAR_PRIMITIVE    "\n");
+}
+
+typedef struct GeneratedFunction_s GeneratedFunction;
+struct GeneratedFunction_s
+{
+    SyntacticNode* function;
+    int            worker;     // Index of the thread that generated the function, and of its file
+    long           start;      // Position of the code in the file of the worker
+    long           end;
+    int            nb_labels;
+};
+
+typedef struct ParallelGeneration_s ParallelGeneration;
+struct ParallelGeneration_s
+{
+    GeneratedFunction* functions;
+    FILE**             worker_files;
+    int                nb_global_variables;
+    SyntacticNode**    global_declarations;
+    optimization_t     optimizations;
+};
+
+static void generate_function_task(void* context, int task, int worker)
+{
+    ParallelGeneration* generation = context;
+    GeneratedFunction* generated = generation->functions + task;
+    FILE* stream = generation->worker_files[worker];
 
+    label_counter     = 0;
+    is_label_relative = 1;
+    generated->worker = worker;
+    generated->start  = ftell(stream);
+    generate_code(generated->function, stream, NO_LOOP, generation->nb_global_variables, generation->global_declarations, generation->optimizations);
+    generated->end       = ftell(stream);
+    generated->nb_labels = label_counter;
 }
 
-void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations)
+// Writes a line of code whose label, if it is relative, is numbered from 'first_label_number'
+static void write_relocated_line(char* line, FILE* out_stream, int first_label_number)
 {
-    assert(node != NULL);
+    // A line has at most one label, '_-' can't appear in the names of the functions nor in the numbers
+    char* relative_label = strstr(line, "_-");
+    if (relative_label == NULL)
+    {
+        fputs(line, out_stream);
+    }
+    else
+    {
+        char* end = NULL;
+        long relative_number = strtol(relative_label + 2, &end, 10);
+        *relative_label = '\0';
+        fprintf(out_stream, "%s_%ld%s", line, first_label_number + relative_number - 1, end);
+    }
+}
+
+// Copies the code of a function generated by a worker, its labels are numbered from 'first_label_number'
+static void copy_generated_function(const GeneratedFunction* generated, FILE* in_stream, FILE* out_stream, int first_label_number)
+{
+    char line[MAX_CODE_LINE_LENGTH];
+    long position = generated->start;
+    fseek(in_stream, position, SEEK_SET);
+    while (position < generated->end && fgets(line, sizeof(line), in_stream) != NULL)
+    {
+        position += (long) strlen(line);
+        write_relocated_line(line, out_stream, first_label_number);
+    }
+}
+
+int generate_relocatable_function(SyntacticNode* function, FILE * stream, optimization_t optimizations)
+{
+    assert(function != NULL && function->type == NODE_FUNCTION);
+
+    int serial_label_counter = label_counter;
+    label_counter     = 0;
+    is_label_relative = 1;
+    generate_code(function, stream, NO_LOOP, UNKNOWN_NB_GLOBALS, NULL, optimizations);
+    int nb_labels = label_counter;
+    label_counter     = serial_label_counter;
+    is_label_relative = 0;
+    return nb_labels;
+}
 
-    static int label_counter = 0;
+void write_relocatable_function(const char* code, size_t size, int nb_labels, FILE * stream)
+{
+    assert(code != NULL);
+
+    char line[MAX_CODE_LINE_LENGTH];
+    size_t position = 0;
+    while (position < size)
+    {
+        const char* newline = memchr(code + position, '\n', size - position);
+        size_t length = (newline == NULL) ? size - position : (size_t) (newline - (code + position)) + 1;
+        if (length >= sizeof(line))
+            length = sizeof(line) - 1;
+        memcpy(line, code + position, length);
+        line[length] = '\0';
+        position += length;
+        write_relocated_line(line, stream, label_counter);
+    }
+    label_counter += nb_labels;
+}
+
+void generate_code_parallel(SyntacticNode* program, FILE * stream, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations, int nb_jobs)
+{
+    assert(program != NULL && program->type == NODE_PROGRAM);
+
+    int nb_functions = 0;
+    for (int i = 0; i < program->nb_children; i++)
+    {
+        if (program->children[i]->type == NODE_FUNCTION)
+            nb_functions++;
+    }
+    if (nb_jobs <= 1 || nb_functions <= 1)
+    {
+        generate_code(program, stream, NO_LOOP, nb_global_variables, global_declarations, optimizations);
+        return;
+    }
+    if (nb_jobs > nb_functions)
+        nb_jobs = nb_functions;
+
+    ParallelGeneration generation;
+    generation.functions           = malloc(sizeof(GeneratedFunction) * nb_functions);
+    generation.worker_files        = malloc(sizeof(FILE*) * nb_jobs);
+    generation.nb_global_variables = nb_global_variables;
+    generation.global_declarations = global_declarations;
+    generation.optimizations       = optimizations;
+    if (generation.functions == NULL || generation.worker_files == NULL)
+    {
+        perror("Failed to allocate memory for the parallel code generation");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0, j = 0; i < program->nb_children; i++)
+    {
+        if (program->children[i]->type == NODE_FUNCTION)
+            generation.functions[j++].function = program->children[i];
+    }
+    for (int i = 0; i < nb_jobs; i++)
+    {
+        generation.worker_files[i] = tmpfile();
+        if (generation.worker_files[i] == NULL)
+        {
+            perror("Failed to create the temporary file of the generated code");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // The calling thread is one of the workers
+    int serial_label_counter = label_counter;
+    thread_pool_run(nb_jobs, nb_functions, generate_function_task, &generation);
+    label_counter     = serial_label_counter;
+    is_label_relative = 0;
+
+    for (int i = 0; i < nb_jobs; i++)
+        fflush(generation.worker_files[i]);
+
+    // The functions and the other declarations are written in the order of the program
+    for (int i = 0, j = 0; i < program->nb_children; i++)
+    {
+        if (program->children[i]->type == NODE_FUNCTION)
+        {
+            GeneratedFunction* generated = generation.functions + j++;
+            copy_generated_function(generated, generation.worker_files[generated->worker], stream, label_counter);
+            label_counter += generated->nb_labels;
+        }
+        else
+            generate_code(program->children[i], stream, NO_LOOP, nb_global_variables, global_declarations, optimizations);
+    }
+
+    for (int i = 0; i < nb_jobs; i++)
+        fclose(generation.worker_files[i]);
+    free(generation.worker_files);
+    free(generation.functions);
+}
+
+void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations)
+{
+    assert(node != NULL);
 
     switch (node->type)
     {
         case NODE_NEGATION:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_tested_value(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        not\n");
             break;
         }
+        case NODE_BITWISE_NOT:
+        {
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            fprintf(stream, "        bnot\n");
+            break;
+        }
         case NODE_UNARY_MINUS:
         {
             fprintf(stream, "        push 0\n");
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        sub\n");
             break;
         }
         case NODE_ADD :
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        add\n");
             break;
         }
         case NODE_SUB:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        sub\n");
             break;
         }
         case NODE_MUL:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            if (is_opti_enabled(optimizations, OPTI_STRENGTH_REDUCTION))
+            {
+                // x * 2^k ----> x << k
+                int exponent = power_of_two_exponent(node->children[1]);
+                int operand  = 0;
+                if (exponent == -1)
+                {
+                    exponent = power_of_two_exponent(node->children[0]);
+                    operand  = 1;
+                }
+                if (exponent != -1)
+                {
+                    generate_code(node->children[operand], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+                    fprintf(stream, "        push %d\n", exponent);
+                    fprintf(stream, "        shl\n");
+                    break;
+                }
+            }
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        mul\n");
             break;
         }
         case NODE_DIV:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        div\n");
             break;
         }
         case NODE_MOD:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        mod\n");
             break;
         }
+        case NODE_BITWISE_OR:
+        {
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            fprintf(stream, "        bor\n");
+            break;
+        }
+        case NODE_BITWISE_XOR:
+        {
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            fprintf(stream, "        bxor\n");
+            break;
+        }
+        case NODE_BITWISE_AND:
+        {
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            fprintf(stream, "        band\n");
+            break;
+        }
+        case NODE_LEFT_SHIFT:
+        {
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            fprintf(stream, "        shl\n");
+            break;
+        }
+        case NODE_RIGHT_SHIFT:
+        {
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            fprintf(stream, "        shr\n");
+            break;
+        }
         case NODE_AND:
         {
             #if (SHORT_CIRUIT_ENABLED)
+            if (is_opti_enabled(optimizations, OPTI_LOGICAL_BRANCH) && is_eager_evaluable(node->children[1]))
             {
-                int label_number = label_counter++;
-                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+                fprintf(stream, "        and\n");
+            }
+            else
+            {
+                int label_number = new_label_number();
+                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
                 fprintf(stream, "        dup\n");
                 fprintf(stream, "        jumpf endand_%d\n", label_number);
-                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
                 fprintf(stream, "        and\n");
                 fprintf(stream, ".endand_%d\n", label_number);
             }
             #else
             {
-                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
                 fprintf(stream, "        and\n");
             }
             #endif
@@ -135,23 +388,30 @@ void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_globa
         case NODE_OR:
         {
             #if (SHORT_CIRUIT_ENABLED)
+            if (is_opti_enabled(optimizations, OPTI_LOGICAL_BRANCH) && is_eager_evaluable(node->children[1]))
+            {
+                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+                fprintf(stream, "        or\n");
+            }
+            else
             {
-                int label_number = label_counter++;
-                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
+                int label_number = new_label_number();
+                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
                 fprintf(stream, "        dup\n");
                 fprintf(stream, "        jumpf falseor_%d\n", label_number);
                 fprintf(stream, "        drop\n");
                 fprintf(stream, "        push 1\n");
                 fprintf(stream, "        jump endor_%d\n", label_number);
                 fprintf(stream, ".falseor_%d\n", label_number);
-                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
                 fprintf(stream, "        or\n");
                 fprintf(stream, ".endor_%d\n", label_number);
             }
             #else
             {
-                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
                 fprintf(stream, "        or\n");
             }
             #endif
@@ -159,65 +419,64 @@ void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_globa
         }
         case NODE_EQUAL:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_compared_operands(node, stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        cmpeq\n");
             break;
         }
         case NODE_NOT_EQUAL:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_compared_operands(node, stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        cmpne\n");
             break;
         }
         case NODE_LESS:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        cmplt\n");
             break;
         }
         case NODE_LESS_OR_EQUAL:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        cmple\n");
             break;
         }
         case NODE_GREATER:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        cmpgt\n");
             break;
         }
         case NODE_GREATER_OR_EQUAL:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        cmpge\n");
             break;
         }
         case NODE_PRINT:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        dbg\n");
             break;
         }
         case NODE_PROGRAM:
         case NODE_SEQUENCE:
         case NODE_BLOCK:
+        case NODE_INLINED_CALL:
         {
             for (int i = 0; i < node->nb_children; i++)
             {
-                generate_code(node->children[i], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[i], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             }
             break;
         }
         case NODE_DROP:
         {
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             fprintf(stream, "        drop\n");
             break;
         }
@@ -227,19 +486,21 @@ void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_globa
                 global_declarations[node->stack_offset] = node;
             else if (node->nb_children == 1)
             {
-                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
                 fprintf(stream, "        drop\n");
             }
             break;
         }
         case NODE_REF:
         {
-            if (syntactic_node_is_flag_set(node, GLOBAL_FLAG))
+            if (syntactic_node_is_flag_set(node, ARRAY_FLAG))
+                generate_address(node, stream, nb_global_variables);
+            else if (syntactic_node_is_flag_set(node, GLOBAL_FLAG))
             {
                 // End of data segment address is stored in memory cell 0
                 fprintf(stream, "        push 0\n");
                 fprintf(stream, "        read\n");
-                fprintf(stream, "        push %d\n", nb_global_variables - node->stack_offset);
+                generate_global_distance(stream, nb_global_variables, node->stack_offset);
                 fprintf(stream, "        sub\n");
                 fprintf(stream, "        read\n");
             }
@@ -253,12 +514,12 @@ void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_globa
             SyntacticNode* assignable;
             if (node->type == NODE_ASSIGNMENT)
             {
-                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
                 assignable = node->children[0];
             }
             else
             {
-                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
                 assignable = node->children[0]->children[0];
             }
 
@@ -270,7 +531,7 @@ void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_globa
                 {
                     fprintf(stream, "        push 0\n");
                     fprintf(stream, "        read\n");
-                    fprintf(stream, "        push %d\n", nb_global_variables - assignable->stack_offset);
+                    generate_global_distance(stream, nb_global_variables, assignable->stack_offset);
                     fprintf(stream, "        sub\n");
                     fprintf(stream, "        write\n");
                 }
@@ -283,52 +544,36 @@ void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_globa
             {
                 assert(assignable->nb_children == 1);
 
-                generate_code(assignable->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-                fprintf(stream, "        write\n");
+                generate_memory_access(assignable->children[0], 1, stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             }
             break;
         }
         case NODE_CONDITION:
-        {
-            int has_else = (node->nb_children == 3);
-            int label_number = label_counter++;
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            fprintf(stream, has_else ? "        jumpf else_%d\n"
-                                     : "        jumpf endif_%d\n", label_number);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
-            if (has_else)
-            {
-                fprintf(stream, "        jump endif_%d\n", label_number);
-                fprintf(stream, ".else_%d\n", label_number);
-                generate_code(node->children[2], stream, loop_nb, nb_global_variables, global_declarations);
-            }
-            fprintf(stream, ".endif_%d\n", label_number);
-            break;
-        }
         case NODE_INVERTED_CONDITION:
         {
             int has_else = (node->nb_children == 3);
-            int label_number = label_counter++;
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            fprintf(stream, has_else ? "        jumpt else_%d\n"
-                                     : "        jumpt endif_%d\n", label_number);
-            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations);
+            int label_number = new_label_number();
+            // The code of the condition is skipped when the condition isn't met
+            int jump_if = (node->type == NODE_INVERTED_CONDITION);
+            generate_branch(node->children[0], jump_if, has_else ? "else" : "endif", label_number,
+                            stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(node->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             if (has_else)
             {
                 fprintf(stream, "        jump endif_%d\n", label_number);
                 fprintf(stream, ".else_%d\n", label_number);
-                generate_code(node->children[2], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[2], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             }
             fprintf(stream, ".endif_%d\n", label_number);
             break;
         }
         case NODE_LOOP:
         {
-            int current_loop_number = label_counter++;
+            int current_loop_number = new_label_number();
             fprintf(stream, ".loop_%d\n", current_loop_number);
             for (int i = 0; i < node->nb_children; i++)
             {
-                generate_code(node->children[i], stream, current_loop_number, nb_global_variables, global_declarations);
+                generate_code(node->children[i], stream, current_loop_number, nb_global_variables, global_declarations, optimizations);
             }
             fprintf(stream, "        jump loop_%d\n", current_loop_number);
             fprintf(stream, ".endloop_%d\n", current_loop_number);
@@ -336,12 +581,27 @@ void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_globa
         }
         case NODE_FUNCTION:
         {
+            // A prototype generates nothing, the call jumps to the label of the definition
+            if (syntactic_node_is_flag_set(node, EXTERN_FLAG))
+                break;
+
+            if (is_opti_enabled(optimizations, OPTI_SSA) && ssa_is_function_supported(node))
+            {
+                SsaFunction* function = ssa_function_create(node, optimizations);
+                ssa_function_optimize(function, optimizations);
+                ssa_function_lower(function, stream, nb_global_variables, optimizations);
+                ssa_function_free(function);
+                break;
+            }
+
             fprintf(stream, ".%s\n", node->value.str_val);
             if(node->nb_var > 0)
                 fprintf(stream, "        resn %d\n", node->nb_var);
+            if (syntactic_node_is_flag_set(node, TAIL_CALL_FLAG))
+                fprintf(stream, ".%s.tailcall\n", node->value.str_val);
             for (int i = 0; i < node->nb_children; i++)
             {
-                generate_code(node->children[i], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[i], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             }
             fprintf(stream, "        push 0\n");
             fprintf(stream, "        ret\n");
@@ -354,17 +614,30 @@ void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_globa
             fprintf(stream, "        prep %s\n", node->value.str_val);
             for (int i = 0; i < node->nb_children; i++)
             {
-                generate_code(node->children[i], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[i], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             }
             fprintf(stream, "        call %d\n", node->children[0]->nb_children);
             break;
         }
+        case NODE_TAIL_CALL:
+        {
+            assert(node->nb_children == 1 && node->children[0]->type == NODE_SEQUENCE);
+
+            // The arguments are all evaluated before overwriting the parameters
+            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            for (int i = node->children[0]->nb_children - 1; i >= 0; i--)
+            {
+                fprintf(stream, "        set %d\n", i);
+            }
+            fprintf(stream, "        jump %s.tailcall\n", node->value.str_val);
+            break;
+        }
         case NODE_RETURN:
         {
             int has_retval = (node->nb_children > 0);
             if (has_retval)
             {
-                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
+                generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             }
             else
             {
@@ -392,36 +665,252 @@ void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_globa
         case NODE_DEREF:
         {
             assert(node->nb_children == 1);
-            generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations);
-            fprintf(stream, "        read\n");
+            generate_memory_access(node->children[0], 0, stream, loop_nb, nb_global_variables, global_declarations, optimizations);
             break;
         }
         case NODE_ADDRESS:
         {
             assert(node->nb_children == 1);
-            SyntacticNode* node_ref = node->children[0];
-            assert(node_ref->type == NODE_REF);
+            assert(node->children[0]->type == NODE_REF);
+            generate_address(node->children[0], stream, nb_global_variables);
+            break;
+        }
+        case NODE_CONSTANT: fprintf(stream, "        push %d\n", node->value.int_val); break;
+    }
+}
+
+void generate_branch(SyntacticNode* condition, int jump_if, const char* label_prefix, int label_number,
+                     FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations)
+{
+    assert(condition != NULL);
 
-            if (syntactic_node_is_flag_set(node_ref, GLOBAL_FLAG))
+    if (is_opti_enabled(optimizations, OPTI_FUSED_BRANCH))
+    {
+        while (condition->type == NODE_NEGATION)
+        {
+            condition = condition->children[0];
+            jump_if = ! jump_if;
+        }
+    }
+
+    if (is_opti_enabled(optimizations, OPTI_LOGICAL_BRANCH) && (condition->type == NODE_AND || condition->type == NODE_OR))
+    {
+        // 'a && b' is false as soon as 'a' is false, 'a || b' is true as soon as 'a' is true
+        int is_and = (condition->type == NODE_AND);
+        if (jump_if != is_and)
+        {
+            generate_branch(condition->children[0], jump_if, label_prefix, label_number,
+                            stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_branch(condition->children[1], jump_if, label_prefix, label_number,
+                            stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+        }
+        else
+        { // The value of 'a' alone can only tell that the jump isn't taken
+            int skip_label_number = new_label_number();
+            generate_branch(condition->children[0], ! jump_if, "skip", skip_label_number,
+                            stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_branch(condition->children[1], jump_if, label_prefix, label_number,
+                            stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            fprintf(stream, ".skip_%d\n", skip_label_number);
+        }
+        return;
+    }
+
+    if (is_opti_enabled(optimizations, OPTI_FUSED_BRANCH))
+    {
+
+        // The opposite comparison is used to jump when the condition is false
+        const char* compare_and_branch = NULL;
+        switch (condition->type)
+        {
+            case NODE_EQUAL:            compare_and_branch = jump_if ? "jeq" : "jne"; break;
+            case NODE_NOT_EQUAL:        compare_and_branch = jump_if ? "jne" : "jeq"; break;
+            case NODE_LESS:             compare_and_branch = jump_if ? "jlt" : "jge"; break;
+            case NODE_LESS_OR_EQUAL:    compare_and_branch = jump_if ? "jle" : "jgt"; break;
+            case NODE_GREATER:          compare_and_branch = jump_if ? "jgt" : "jle"; break;
+            case NODE_GREATER_OR_EQUAL: compare_and_branch = jump_if ? "jge" : "jlt"; break;
+        }
+
+        if (compare_and_branch != NULL)
+        {
+            generate_compared_operands(condition, stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            fprintf(stream, "        %s %s_%d\n", compare_and_branch, label_prefix, label_number);
+            return;
+        }
+    }
+
+    generate_tested_value(condition, stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+    fprintf(stream, "        %s %s_%d\n", jump_if ? "jumpt" : "jumpf", label_prefix, label_number);
+}
+
+void generate_global_distance(FILE * stream, int nb_global_variables, int offset)
+{
+    if (nb_global_variables == UNKNOWN_NB_GLOBALS)
+        fprintf(stream, "        push " GLOBAL_RELOCATION "%d\n", offset);
+    else
+        fprintf(stream, "        push %d\n", nb_global_variables - offset);
+}
+
+void resolve_global_relocations(FILE* in_stream, FILE* out_stream, int nb_global_variables)
+{
+    assert(in_stream != NULL && out_stream != NULL);
+
+    #define RELOCATED_PUSH "        push " GLOBAL_RELOCATION
+
+    char buffer[MAX_CODE_LINE_LENGTH];
+    while (fgets(buffer, sizeof(buffer), in_stream) != NULL)
+    {
+        if (strncmp(buffer, RELOCATED_PUSH, strlen(RELOCATED_PUSH)) == 0)
+            fprintf(out_stream, "        push %d\n", nb_global_variables - atoi(buffer + strlen(RELOCATED_PUSH)));
+        else
+            fputs(buffer, out_stream);
+    }
+}
+
+void generate_address(const SyntacticNode* node_ref, FILE * stream, int nb_global_variables)
+{
+    if (syntactic_node_is_flag_set(node_ref, GLOBAL_FLAG))
+    {
+        fprintf(stream, "        push 0\n");
+        fprintf(stream, "        read\n");
+        generate_global_distance(stream, nb_global_variables, node_ref->stack_offset);
+        fprintf(stream, "        sub\n");
+    }
+    else
+    {
+        fprintf(stream, "        prep start\n");
+        fprintf(stream, "        drop\n");
+        fprintf(stream, "        prep start\n");
+        fprintf(stream, "        push %d\n", node_ref->stack_offset + 1);
+        fprintf(stream, "        sub\n");
+        fprintf(stream, "        sub\n");
+        fprintf(stream, "        sub\n");
+    }
+}
+
+static int is_local_array(const SyntacticNode* node)
+{
+    return node->type == NODE_REF && syntactic_node_is_flag_set(node, ARRAY_FLAG) && !syntactic_node_is_flag_set(node, GLOBAL_FLAG);
+}
+
+void generate_memory_access(SyntacticNode* address, int is_write, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations)
+{
+    if (is_opti_enabled(optimizations, OPTI_INDEXED_ACCESS))
+    {
+        // The elements of a local array are addressed relatively to the frame, like the variables
+        if (is_local_array(address))
+        {
+            fprintf(stream, "        %s %d\n", is_write ? "set" : "get", address->stack_offset);
+            return;
+        }
+        if (address->type == NODE_ADD)
+        {
+            for (int i = 0; i < 2; i++)
             {
-                fprintf(stream, "        push 0\n");
-                fprintf(stream, "        read\n");
-                fprintf(stream, "        push %d\n", nb_global_variables - node_ref->stack_offset);
-                fprintf(stream, "        sub\n");
+                if (is_local_array(address->children[i]))
+                {
+                    generate_code(address->children[1 - i], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+                    fprintf(stream, "        %s %d\n", is_write ? "setx" : "getx", address->children[i]->stack_offset);
+                    return;
+                }
             }
-            else
+            generate_code(address->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            generate_code(address->children[1], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+            fprintf(stream, "        %s\n", is_write ? "writex" : "readx");
+            return;
+        }
+    }
+    generate_code(address, stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+    fprintf(stream, "        %s\n", is_write ? "write" : "read");
+}
+
+// Returns k if the node is the constant 2^k with k >= 1, -1 otherwise
+static int power_of_two_exponent(const SyntacticNode* node)
+{
+    if (node->type != NODE_CONSTANT || node->value.int_val < 2 || (node->value.int_val & (node->value.int_val - 1)) != 0)
+        return -1;
+
+    int exponent = 0;
+    while ((1 << exponent) != node->value.int_val)
+        exponent++;
+    return exponent;
+}
+
+void generate_tested_value(SyntacticNode* node, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations)
+{
+    // x % 2^k and x & (2^k - 1) are zero for the same values of x, whatever its sign
+    if (is_opti_enabled(optimizations, OPTI_STRENGTH_REDUCTION) && node->type == NODE_MOD
+        && power_of_two_exponent(node->children[1]) != -1)
+    {
+        generate_code(node->children[0], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+        fprintf(stream, "        push %d\n", node->children[1]->value.int_val - 1);
+        fprintf(stream, "        band\n");
+    }
+    else
+    {
+        generate_code(node, stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+    }
+}
+
+static inline int is_zero(const SyntacticNode* node)
+{
+    return node->type == NODE_CONSTANT && node->value.int_val == 0;
+}
+
+void generate_compared_operands(SyntacticNode* comparison, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations)
+{
+    int is_equality = (comparison->type == NODE_EQUAL || comparison->type == NODE_NOT_EQUAL);
+    for (int i = 0; i < 2; i++)
+    {
+        if (is_equality && is_zero(comparison->children[1 - i]))
+            generate_tested_value(comparison->children[i], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+        else
+            generate_code(comparison->children[i], stream, loop_nb, nb_global_variables, global_declarations, optimizations);
+    }
+}
+
+static int eager_evaluable_size(const SyntacticNode* node)
+{
+    switch (node->type)
+    {
+        case NODE_CONSTANT:
+        case NODE_REF:
+            return 1;
+        case NODE_NEGATION:
+        case NODE_UNARY_MINUS:
+        case NODE_BITWISE_NOT:
+        case NODE_EQUAL:
+        case NODE_NOT_EQUAL:
+        case NODE_LESS:
+        case NODE_LESS_OR_EQUAL:
+        case NODE_GREATER:
+        case NODE_GREATER_OR_EQUAL:
+        case NODE_ADD:
+        case NODE_SUB:
+        case NODE_MUL:
+        case NODE_BITWISE_OR:
+        case NODE_BITWISE_XOR:
+        case NODE_BITWISE_AND:
+        case NODE_LEFT_SHIFT:
+        case NODE_RIGHT_SHIFT:
+        {
+            int size = 1;
+            for (int i = 0; i < node->nb_children; i++)
             {
-                fprintf(stream, "        prep start\n");
-                fprintf(stream, "        drop\n");
-                fprintf(stream, "        prep start\n");
-                fprintf(stream, "        push %d\n", node_ref->stack_offset + 1);
-                fprintf(stream, "        sub\n");
-                fprintf(stream, "        sub\n");
-                fprintf(stream, "        sub\n");
+                int child_size = eager_evaluable_size(node->children[i]);
+                if (child_size < 0)
+                    return -1;
+                size += child_size;
             }
-
-            break;
+            return size;
         }
-        case NODE_CONSTANT: fprintf(stream, "        push %d\n", node->value.int_val); break;
+        default: // Calls, assignments, dereferences and divisions
+            return -1;
     }
 }
+
+int is_eager_evaluable(const SyntacticNode* node)
+{
+    int size = eager_evaluable_size(node);
+    return 0 < size && size <= EAGER_OPERAND_MAX_SIZE;
+}
@@ -4,10 +4,41 @@
 #include <stdio.h>
 
 #include "syntactic_node.h"
+#include "object_file.h"
+#include "optimization.h"
 
 #define NO_LOOP -1
 
-void generate_program(SyntacticNode* program, FILE * stream, int is_init_called, int nb_global_variables, SyntacticNode** global_declarations);
-void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations);
+/*
+* The globals are addressed from the end of the data segment, at a distance that depends on the number of global variables.
+* When the functions are generated before the whole program is known, UNKNOWN_NB_GLOBALS is given instead :
+* the distance is written as a relocation 'push @globals-<offset>' that resolve_global_relocations() replaces once the number is known,
+* or that the linker replaces in an object file.
+*/
+#define UNKNOWN_NB_GLOBALS   -1
+#define MAX_CODE_LINE_LENGTH 4096 // Same as msm
+
+void generate_program(SyntacticNode* program, FILE * stream, int is_init_called, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations, int nb_jobs);
+// Generates the code run at start, which initializes the global variables then calls main(), and the primitive functions
+void generate_entry_point(FILE * stream, int is_init_called, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations);
+// Generates the initializations of the 'nb_declarations' first global variables, in the order of their offsets
+void generate_global_initializations(FILE * stream, int nb_declarations, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations);
+void generate_code(SyntacticNode* node, FILE * stream, int loop_nb, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations);
+// Generates the declarations of the program as generate_code() does, the functions are generated by 'nb_jobs' threads
+// The code is the same whatever the number of threads
+void generate_code_parallel(SyntacticNode* program, FILE * stream, int nb_global_variables, SyntacticNode** global_declarations, optimization_t optimizations, int nb_jobs);
+/*
+* A relocatable function numbers its labels -1, -2, ... so that its code can be kept and written later, e.g. by an incremental compilation.
+* Once written, its labels get the next numbers of the program : the code is the same as the one generated in place.
+*/
+// Returns the number of labels of the function
+int generate_relocatable_function(SyntacticNode* function, FILE * stream, optimization_t optimizations);
+void write_relocatable_function(const char* code, size_t size, int nb_labels, FILE * stream);
+// Generates the 'push' of the distance from the end of the data segment to the global variable at 'offset'
+void generate_global_distance(FILE * stream, int nb_global_variables, int offset);
+// Copies the generated code, the relocations of the globals are replaced by their distance
+void resolve_global_relocations(FILE* in_stream, FILE* out_stream, int nb_global_variables);
+// True if the operand can be evaluated even when short-circuit evaluation would skip it : cheap, without side effect and can't trap
+int is_eager_evaluable(const SyntacticNode* node);
 
 #endif // CODE_GENERATION_H
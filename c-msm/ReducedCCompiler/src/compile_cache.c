@@ -0,0 +1,358 @@
+#include "compile_cache.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CACHE_ENABLED
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+    #define MODIFICATION_TIME(status) ((status).st_mtimespec)
+#else
+    #define MODIFICATION_TIME(status) ((status).st_mtim)
+#endif
+#endif
+
+#define FNV_PRIME         1099511628211ULL
+#define COPY_CHUNK_SIZE   65536
+#define KEY_LENGTH        (2 * SHA256_DIGEST_SIZE)  // Hexadecimal digits of a key
+#define ENTRY_EXTENSION   ".msm"
+#define STATS_FILENAME    "stats.txt"
+#define EVICTION_PERCENT  90          // The eviction leaves some room so that the next stores don't evict again
+
+uint64_t cache_hash_bytes(uint64_t hash, const void* bytes, size_t size)
+{
+    const unsigned char* data = bytes;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+CacheKey compile_cache_key(const Sha256* options, const void* source, size_t size)
+{
+    assert(options != NULL);
+
+    Sha256 sha = *options;
+    sha256_update(&sha, source, size);
+    CacheKey key;
+    sha256_final(&sha, key.digest);
+    return key;
+}
+
+#ifdef CACHE_ENABLED
+typedef struct CacheStats_s CacheStats;
+struct CacheStats_s
+{
+    long long nb_hits;
+    long long nb_misses;
+    long long size;        // Total size of the entries, recomputed when the entries are evicted
+};
+
+typedef struct CacheEntry_s CacheEntry;
+struct CacheEntry_s
+{
+    char            name[KEY_LENGTH + sizeof(ENTRY_EXTENSION)];
+    long long       size;
+    struct timespec last_use;
+};
+
+static bool copy_file(FILE* from, FILE* to)
+{
+    char chunk[COPY_CHUNK_SIZE];
+    size_t nb_read;
+    while ((nb_read = fread(chunk, sizeof(char), sizeof(chunk), from)) > 0)
+    {
+        if (fwrite(chunk, sizeof(char), nb_read, to) != nb_read)
+            return false;
+    }
+    return ! ferror(from);
+}
+
+static char* cache_path(const CompileCache* cache, const char* name)
+{
+    size_t size = strlen(cache->directory) + strlen(name) + 2;
+    char* path = malloc(size);
+    if (path == NULL)
+    {
+        perror("Failed to allocate memory for a path of the cache");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(path, size, "%s/%s", cache->directory, name);
+    return path;
+}
+
+static void entry_name(const CacheKey* key, char name[KEY_LENGTH + sizeof(ENTRY_EXTENSION)])
+{
+    for (int i = 0; i < SHA256_DIGEST_SIZE; i++)
+        snprintf(name + 2 * i, 3, "%02x", key->digest[i]);
+    strcpy(name + KEY_LENGTH, ENTRY_EXTENSION);
+}
+
+static bool is_entry_name(const char* name)
+{
+    if (strlen(name) != KEY_LENGTH + strlen(ENTRY_EXTENSION) || strcmp(name + KEY_LENGTH, ENTRY_EXTENSION) != 0)
+        return false;
+    for (int i = 0; i < KEY_LENGTH; i++)
+    {
+        if (strchr("0123456789abcdef", name[i]) == NULL)
+            return false;
+    }
+    return true;
+}
+
+// The statistics file is locked until it is closed, the process waits for the other compilations to release it
+static int lock_stats(const CompileCache* cache, CacheStats* stats)
+{
+    char* path = cache_path(cache, STATS_FILENAME);
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    free(path);
+    if (fd == -1)
+        return -1;
+    while (lockf(fd, F_LOCK, 0) == -1)
+    {
+        if (errno != EINTR)
+        {
+            close(fd);
+            return -1;
+        }
+    }
+
+    char content[128];
+    ssize_t nb_read = pread(fd, content, sizeof(content) - 1, 0);
+    content[(nb_read > 0) ? nb_read : 0] = '\0';
+    *stats = (CacheStats) {0};
+    sscanf(content, "%lld %lld %lld", &(stats->nb_hits), &(stats->nb_misses), &(stats->size));
+    return fd;
+}
+
+static void unlock_stats(int fd, const CacheStats* stats)
+{
+    char content[128];
+    int length = snprintf(content, sizeof(content), "%lld %lld %lld\n", stats->nb_hits, stats->nb_misses, stats->size);
+    if (ftruncate(fd, 0) == 0 && pwrite(fd, content, (size_t) length, 0) != length)
+        fprintf(stderr, "Failed to update the statistics of the cache\n");
+    close(fd); // Releases the lock
+}
+
+// Lists the entries of the cache, returns their number
+static int list_entries(const CompileCache* cache, CacheEntry** entries, long long* total_size)
+{
+    *entries = NULL;
+    *total_size = 0;
+    DIR* directory = opendir(cache->directory);
+    if (directory == NULL)
+        return 0;
+
+    int nb_entries = 0;
+    int capacity = 0;
+    struct dirent* file;
+    while ((file = readdir(directory)) != NULL)
+    {
+        if (! is_entry_name(file->d_name))
+            continue;
+        char* path = cache_path(cache, file->d_name);
+        struct stat status;
+        bool exists = stat(path, &status) == 0;
+        free(path);
+        if (! exists)
+            continue; // Evicted by another compilation
+
+        if (nb_entries == capacity)
+        {
+            capacity = (capacity == 0) ? 64 : 2 * capacity;
+            CacheEntry* reallocated_entries = realloc(*entries, sizeof(CacheEntry) * capacity);
+            if (reallocated_entries == NULL)
+            {
+                perror("Failed to allocate memory for the entries of the cache");
+                exit(EXIT_FAILURE);
+            }
+            *entries = reallocated_entries;
+        }
+        CacheEntry* entry = *entries + nb_entries++;
+        strcpy(entry->name, file->d_name);
+        entry->size     = (long long) status.st_size;
+        entry->last_use = MODIFICATION_TIME(status);
+        *total_size += entry->size;
+    }
+    closedir(directory);
+    return nb_entries;
+}
+
+static int compare_last_uses(const void* a, const void* b)
+{
+    const CacheEntry* entry_a = a;
+    const CacheEntry* entry_b = b;
+    if (entry_a->last_use.tv_sec != entry_b->last_use.tv_sec)
+        return (entry_a->last_use.tv_sec < entry_b->last_use.tv_sec) ? -1 : 1;
+    if (entry_a->last_use.tv_nsec != entry_b->last_use.tv_nsec)
+        return (entry_a->last_use.tv_nsec < entry_b->last_use.tv_nsec) ? -1 : 1;
+    return strcmp(entry_a->name, entry_b->name);
+}
+
+// Removes the entries used the least recently, the statistics are locked
+static void evict_entries(const CompileCache* cache, CacheStats* stats)
+{
+    CacheEntry* entries;
+    int nb_entries = list_entries(cache, &entries, &(stats->size));
+    if (stats->size > cache->max_size)
+    {
+        long long target_size = cache->max_size / 100 * EVICTION_PERCENT;
+        qsort(entries, nb_entries, sizeof(CacheEntry), compare_last_uses);
+        for (int i = 0; i < nb_entries && stats->size > target_size; i++)
+        {
+            char* path = cache_path(cache, entries[i].name);
+            if (unlink(path) == 0)
+                stats->size -= entries[i].size;
+            free(path);
+        }
+    }
+    free(entries);
+}
+
+CompileCache compile_cache_open(const char* directory, long long max_size)
+{
+    assert(directory != NULL && max_size >= 0);
+
+    if (mkdir(directory, 0755) == -1 && errno != EEXIST)
+    {
+        fprintf(stderr, "Failed to create the cache directory \"%s\" : %s\n", directory, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    return (CompileCache) { .directory = directory, .max_size = max_size };
+}
+
+bool compile_cache_fetch(const CompileCache* cache, const CacheKey* key, FILE* out_file)
+{
+    assert(cache != NULL && key != NULL && out_file != NULL);
+
+    char name[KEY_LENGTH + sizeof(ENTRY_EXTENSION)];
+    entry_name(key, name);
+    char* path = cache_path(cache, name);
+    FILE* entry = fopen(path, "r");
+    free(path);
+
+    bool is_hit = entry != NULL;
+    if (is_hit)
+    {
+        // The modification time of an entry is its last use
+        futimens(fileno(entry), NULL);
+        is_hit = copy_file(entry, out_file);
+        fclose(entry);
+    }
+
+    CacheStats stats;
+    int stats_fd = lock_stats(cache, &stats);
+    if (stats_fd != -1)
+    {
+        if (is_hit)
+            stats.nb_hits++;
+        else
+            stats.nb_misses++;
+        unlock_stats(stats_fd, &stats);
+    }
+    return is_hit;
+}
+
+void compile_cache_store(const CompileCache* cache, const CacheKey* key, FILE* code_file)
+{
+    assert(cache != NULL && key != NULL && code_file != NULL);
+
+    char name[KEY_LENGTH + sizeof(ENTRY_EXTENSION)];
+    entry_name(key, name);
+    char* path = cache_path(cache, name);
+
+    // The entry is written aside then renamed, so that the other compilations never read a partial entry
+    char temporary_name[KEY_LENGTH + 32];
+    snprintf(temporary_name, sizeof(temporary_name), "%.*s.%ld.tmp", KEY_LENGTH, name, (long) getpid());
+    char* temporary_path = cache_path(cache, temporary_name);
+
+    rewind(code_file);
+    FILE* entry = fopen(temporary_path, "w");
+    bool is_written = entry != NULL && copy_file(code_file, entry);
+    if (entry != NULL)
+        is_written = (fclose(entry) == 0) && is_written;
+
+    struct stat status;
+    CacheStats stats;
+    int stats_fd = -1;
+    if (is_written && stat(temporary_path, &status) == 0)
+        stats_fd = lock_stats(cache, &stats);
+
+    if (stats_fd != -1)
+    {
+        // Another compilation may have stored the same entry meanwhile
+        struct stat previous_status;
+        if (stat(path, &previous_status) == 0)
+            stats.size -= (long long) previous_status.st_size;
+        if (rename(temporary_path, path) == 0)
+        {
+            stats.size += (long long) status.st_size;
+            if (stats.size > cache->max_size)
+                evict_entries(cache, &stats);
+        }
+        unlock_stats(stats_fd, &stats);
+    }
+    unlink(temporary_path);
+
+    free(temporary_path);
+    free(path);
+}
+
+void compile_cache_print_stats(const CompileCache* cache, FILE* out_file)
+{
+    assert(cache != NULL && out_file != NULL);
+
+    CacheStats stats = {0};
+    int stats_fd = lock_stats(cache, &stats);
+    CacheEntry* entries;
+    long long size;
+    int nb_entries = list_entries(cache, &entries, &size);
+    free(entries);
+    if (stats_fd != -1)
+    {
+        stats.size = size;
+        unlock_stats(stats_fd, &stats);
+    }
+
+    long long nb_lookups = stats.nb_hits + stats.nb_misses;
+    fprintf(out_file, "Cache \"%s\" :\n", cache->directory);
+    fprintf(out_file, "  hits      : %lld\n", stats.nb_hits);
+    fprintf(out_file, "  misses    : %lld\n", stats.nb_misses);
+    fprintf(out_file, "  hit rate  : %lld%%\n", (nb_lookups == 0) ? 0 : 100 * stats.nb_hits / nb_lookups);
+    fprintf(out_file, "  entries   : %d\n", nb_entries);
+    fprintf(out_file, "  size      : %lld KiB of %lld KiB\n", (size + 1023) / 1024, cache->max_size / 1024);
+}
+#else
+CompileCache compile_cache_open(const char* directory, long long max_size)
+{
+    fprintf(stderr, "The compilation cache isn't supported on this platform\n");
+    (void) directory; (void) max_size;
+    exit(EXIT_FAILURE);
+}
+
+bool compile_cache_fetch(const CompileCache* cache, const CacheKey* key, FILE* out_file)
+{
+    (void) cache; (void) key; (void) out_file;
+    return false;
+}
+
+void compile_cache_store(const CompileCache* cache, const CacheKey* key, FILE* code_file)
+{
+    (void) cache; (void) key; (void) code_file;
+}
+
+void compile_cache_print_stats(const CompileCache* cache, FILE* out_file)
+{
+    (void) cache; (void) out_file;
+}
+#endif
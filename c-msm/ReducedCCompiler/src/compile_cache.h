@@ -0,0 +1,50 @@
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "sha256.h"
+
+/*
+* The cache keeps the generated code of the compilations in a directory, one file per compilation named after its key.
+* The key is the SHA-256 of everything the generated code depends on : the source, the runtime, the options and the compiler itself.
+* A hit copies the code without compiling, the entries used the least recently are removed once the cache is too large.
+* The hits and misses are counted in a statistics file of the directory, shared by the compilations running at the same time.
+*/
+
+#if !defined(_WIN32) && !defined(WIN32)
+    #define CACHE_ENABLED 1
+#endif
+
+#define CACHE_HASH_INIT 14695981039346656037ULL
+
+typedef struct CompileCache_s CompileCache;
+struct CompileCache_s
+{
+    const char* directory;
+    long long   max_size;    // In bytes
+};
+
+typedef struct CacheKey_s CacheKey;
+struct CacheKey_s
+{
+    unsigned char digest[SHA256_DIGEST_SIZE];
+};
+
+// FNV-1a, the hashes are chained by starting from the previous one
+uint64_t cache_hash_bytes(uint64_t hash, const void* bytes, size_t size);
+// Key of a source compiled by the compiler, with the options and the runtime already hashed in 'options'
+CacheKey compile_cache_key(const Sha256* options, const void* source, size_t size);
+
+// Creates the directory of the cache if needed, the process exits if it can't be created
+CompileCache compile_cache_open(const char* directory, long long max_size);
+// Copies the code of the compilation to the output and counts a hit, returns false and counts a miss if it isn't cached
+bool compile_cache_fetch(const CompileCache* cache, const CacheKey* key, FILE* out_file);
+// Stores the code of the compilation read from the start of the file, then evicts the oldest entries if the cache is too large
+void compile_cache_store(const CompileCache* cache, const CacheKey* key, FILE* code_file);
+void compile_cache_print_stats(const CompileCache* cache, FILE* out_file);
+
+#endif // COMPILE_CACHE_H
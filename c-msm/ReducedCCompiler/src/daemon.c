@@ -0,0 +1,410 @@
+#include "daemon.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef DAEMON_ENABLED
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NB_STREAMS      3     // Standard input, output and error
+#define REQUEST_CHUNK   4096
+#define ENV_SET_PREFIX  '='   // Prefix of the value of the environment variable, which is sent empty when it isn't set
+
+static bool write_all(int fd, const void* data, size_t size)
+{
+    const char* bytes = data;
+    while (size > 0)
+    {
+        ssize_t written = write(fd, bytes, size);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        bytes += written;
+        size  -= (size_t) written;
+    }
+    return true;
+}
+
+// The strings of a request are each followed by their null terminator
+static bool write_string(int fd, const char* string)
+{
+    return write_all(fd, string, strlen(string) + 1);
+}
+
+// Reads until the end of the stream, the content is null terminated
+static char* read_all(int fd, size_t* size)
+{
+    size_t capacity = REQUEST_CHUNK;
+    char* content = malloc(capacity + 1);
+    *size = 0;
+    while (content != NULL)
+    {
+        if (*size == capacity)
+        {
+            capacity *= 2;
+            char* reallocated_content = realloc(content, capacity + 1);
+            if (reallocated_content == NULL)
+                free(content);
+            content = reallocated_content;
+            continue;
+        }
+        ssize_t nb_read = read(fd, content + *size, capacity - *size);
+        if (nb_read == -1 && errno == EINTR)
+            continue;
+        if (nb_read <= 0)
+            break;
+        *size += (size_t) nb_read;
+    }
+    if (content == NULL)
+    {
+        perror("Failed to allocate memory for a daemon request");
+        exit(EXIT_FAILURE);
+    }
+    content[*size] = '\0';
+    return content;
+}
+
+static bool socket_address(const char* socket_path, struct sockaddr_un* address)
+{
+    if (strlen(socket_path) >= sizeof(address->sun_path))
+    {
+        fprintf(stderr, "Socket path too long : %s\n", socket_path);
+        return false;
+    }
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    strcpy(address->sun_path, socket_path);
+    return true;
+}
+
+// The descriptors of the standard streams are passed with the first byte of the request
+static bool send_streams(int fd)
+{
+    int streams[NB_STREAMS] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+    char control[CMSG_SPACE(sizeof(streams))];
+    memset(control, 0, sizeof(control));
+    char byte = 0;
+    struct iovec vector = { &byte, 1 };
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov        = &vector;
+    message.msg_iovlen     = 1;
+    message.msg_control    = control;
+    message.msg_controllen = sizeof(control);
+
+    struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type  = SCM_RIGHTS;
+    header->cmsg_len   = CMSG_LEN(sizeof(streams));
+    memcpy(CMSG_DATA(header), streams, sizeof(streams));
+
+    return sendmsg(fd, &message, 0) == 1;
+}
+
+static bool receive_streams(int fd, int streams[NB_STREAMS])
+{
+    char control[CMSG_SPACE(sizeof(int) * NB_STREAMS)];
+    char byte;
+    struct iovec vector = { &byte, 1 };
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov        = &vector;
+    message.msg_iovlen     = 1;
+    message.msg_control    = control;
+    message.msg_controllen = sizeof(control);
+
+    if (recvmsg(fd, &message, 0) != 1)
+        return false;
+    struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+    if (header == NULL || header->cmsg_type != SCM_RIGHTS || header->cmsg_len != CMSG_LEN(sizeof(int) * NB_STREAMS))
+        return false;
+    memcpy(streams, CMSG_DATA(header), sizeof(int) * NB_STREAMS);
+    return true;
+}
+
+static char* next_string(char* string, const char* end)
+{
+    return (string < end) ? string + strlen(string) + 1 : (char*) end;
+}
+
+// Request : working directory, environment variable, number of arguments, arguments
+// Returns false if the request is malformed, the strings point into the request
+static bool parse_request(char* request, size_t size, char** cwd, char** env_value, int* argc, char*** argv)
+{
+    char* end         = request + size;
+    char* argc_string = next_string(next_string(request, end), end);
+    if (argc_string >= end)
+        return false;
+
+    char* argc_end;
+    errno = 0;
+    long nb_arguments = strtol(argc_string, &argc_end, 10);
+    if (argc_end == argc_string || *argc_end != '\0' || errno != 0 || nb_arguments < 0)
+        return false;
+    // The number of arguments can't exceed the number of strings received
+    long nb_strings = 0;
+    for (char* argument = next_string(argc_string, end); argument < end; argument = next_string(argument, end))
+        nb_strings++;
+    if (nb_arguments > nb_strings)
+        return false;
+
+    *argv = malloc(sizeof(char*) * (nb_arguments + (size_t) 1));
+    if (*argv == NULL)
+    {
+        perror("Failed to allocate memory for a daemon request");
+        exit(EXIT_FAILURE);
+    }
+    char* argument = next_string(argc_string, end);
+    for (long i = 0; i < nb_arguments; i++)
+    {
+        (*argv)[i] = argument;
+        argument = next_string(argument, end);
+    }
+    (*argv)[nb_arguments] = NULL;
+
+    *cwd       = request;
+    *env_value = next_string(request, end);
+    *argc      = (int) nb_arguments;
+    return true;
+}
+
+// Runs the command of the request in a child process and sends its exit status to the client
+static void daemon_handle(int client, const char* env_name, DaemonCommand command)
+{
+    int streams[NB_STREAMS];
+    if ( ! receive_streams(client, streams))
+        return;
+
+    size_t size;
+    char* request = read_all(client, &size);
+    char* cwd;
+    char* env_value;
+    int argc;
+    char** argv = NULL;
+    // A request that can't be run fails like the command would
+    int exit_status = EXIT_FAILURE;
+    pid_t pid = -1;
+    if ( ! parse_request(request, size, &cwd, &env_value, &argc, &argv))
+        fprintf(stderr, "Malformed daemon request\n");
+    else
+    {
+        fflush(NULL);
+        pid = fork();
+        if (pid == -1)
+            perror("Failed to run a daemon request");
+    }
+    if (pid == 0)
+    {
+        for (int i = 0; i < NB_STREAMS; i++)
+        {
+            dup2(streams[i], i);
+            close(streams[i]);
+        }
+        close(client);
+
+        if (chdir(cwd) == -1)
+        {
+            perror("Failed to enter the working directory of the client");
+            exit(EXIT_FAILURE);
+        }
+        // Without the variable on the client side, the one of the daemon applies
+        if (env_value[0] == ENV_SET_PREFIX)
+            setenv(env_name, env_value + 1, 1);
+
+        exit(command(argc, argv));
+    }
+
+    for (int i = 0; i < NB_STREAMS; i++)
+        close(streams[i]);
+    int status;
+    while (pid != -1 && waitpid(pid, &status, 0) == -1)
+    {
+        if (errno != EINTR)
+        {
+            perror("Failed to wait for a daemon request");
+            pid = -1;
+        }
+    }
+    // Same status as the one of a shell for a command killed by a signal
+    if (pid != -1)
+        exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+
+    char reply[16];
+    snprintf(reply, sizeof(reply), "%d\n", exit_status);
+    write_all(client, reply, strlen(reply));
+    free(argv);
+    free(request);
+}
+
+int daemon_serve(const char* socket_path, const char* env_name, DaemonCommand command)
+{
+    assert(socket_path != NULL && env_name != NULL && command != NULL);
+
+    struct sockaddr_un address;
+    if ( ! socket_address(socket_path, &address))
+        return EXIT_FAILURE;
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server == -1)
+    {
+        perror("Failed to create the socket of the daemon");
+        return EXIT_FAILURE;
+    }
+
+    // The socket left by a daemon that is no longer running is replaced
+    struct stat socket_status;
+    if (stat(socket_path, &socket_status) == 0 && S_ISSOCK(socket_status.st_mode))
+    {
+        if (connect(server, (struct sockaddr*) &address, sizeof(address)) == 0)
+        {
+            fprintf(stderr, "A daemon already listens on %s\n", socket_path);
+            close(server);
+            return EXIT_FAILURE;
+        }
+        unlink(socket_path);
+    }
+
+    // The socket is bound aside then renamed, so that the clients never find it before it listens
+    char listening_path[sizeof(address.sun_path) + 16];
+    snprintf(listening_path, sizeof(listening_path), "%s.%ld", socket_path, (long) getpid());
+    struct sockaddr_un listening_address;
+    if ( ! socket_address(listening_path, &listening_address))
+    {
+        close(server);
+        return EXIT_FAILURE;
+    }
+    unlink(listening_path);
+    if (bind(server, (struct sockaddr*) &listening_address, sizeof(listening_address)) == -1 || listen(server, SOMAXCONN) == -1
+        || rename(listening_path, socket_path) == -1)
+    {
+        perror("Failed to listen on the socket of the daemon");
+        unlink(listening_path);
+        close(server);
+        return EXIT_FAILURE;
+    }
+
+    // The processes that handle the requests are never waited for
+    signal(SIGCHLD, SIG_IGN);
+    for (;;)
+    {
+        int client = accept(server, NULL, NULL);
+        if (client == -1)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            perror("Failed to accept a request");
+            close(server);
+            return EXIT_FAILURE;
+        }
+
+        fflush(NULL);
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(server);
+            signal(SIGCHLD, SIG_DFL);
+            daemon_handle(client, env_name, command);
+            close(client);
+            _exit(EXIT_SUCCESS);
+        }
+        if (pid == -1)
+            perror("Failed to handle a request");
+        close(client);
+    }
+}
+
+bool daemon_request(const char* socket_path, int argc, char* argv[], const char* env_name, int* exit_status)
+{
+    assert(socket_path != NULL && argv != NULL && env_name != NULL && exit_status != NULL);
+
+    struct sockaddr_un address;
+    if ( ! socket_address(socket_path, &address))
+        return false;
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server == -1)
+        return false;
+    if (connect(server, (struct sockaddr*) &address, sizeof(address)) == -1)
+    {
+        close(server);
+        return false;
+    }
+
+    size_t cwd_size = REQUEST_CHUNK;
+    char* cwd = malloc(cwd_size);
+    while (cwd != NULL && getcwd(cwd, cwd_size) == NULL && errno == ERANGE)
+    {
+        free(cwd);
+        cwd_size *= 2;
+        cwd = malloc(cwd_size);
+    }
+    if (cwd == NULL)
+    {
+        perror("Failed to allocate memory for a daemon request");
+        exit(EXIT_FAILURE);
+    }
+
+    const char* env_value = getenv(env_name);
+    char argc_string[16];
+    snprintf(argc_string, sizeof(argc_string), "%d", argc);
+
+    bool is_sent = send_streams(server) && write_string(server, cwd);
+    if (is_sent && env_value != NULL)
+    {
+        const char prefix = ENV_SET_PREFIX;
+        is_sent = write_all(server, &prefix, 1) && write_string(server, env_value);
+    }
+    else if (is_sent)
+        is_sent = write_string(server, "");
+    is_sent = is_sent && write_string(server, argc_string);
+    for (int i = 0; i < argc && is_sent; i++)
+        is_sent = write_string(server, argv[i]);
+    free(cwd);
+
+    // The end of the request is the end of the stream
+    size_t size = 0;
+    char* reply = NULL;
+    if (is_sent && shutdown(server, SHUT_WR) == 0)
+        reply = read_all(server, &size);
+    close(server);
+
+    if (size == 0)
+    {
+        fprintf(stderr, "The daemon on %s didn't reply\n", socket_path);
+        *exit_status = EXIT_FAILURE;
+    }
+    else
+        *exit_status = atoi(reply);
+    free(reply);
+    return true;
+}
+#else
+int daemon_serve(const char* socket_path, const char* env_name, DaemonCommand command)
+{
+    (void) socket_path; (void) env_name; (void) command;
+
+    fprintf(stderr, "The daemon isn't supported on this platform\n");
+    return EXIT_FAILURE;
+}
+
+bool daemon_request(const char* socket_path, int argc, char* argv[], const char* env_name, int* exit_status)
+{
+    (void) socket_path; (void) argc; (void) argv; (void) env_name; (void) exit_status;
+
+    return false;
+}
+#endif
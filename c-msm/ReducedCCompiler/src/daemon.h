@@ -0,0 +1,25 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <stdbool.h>
+
+/*
+* A daemon runs commands sent by clients through a UNIX socket, so that the state prepared before serving is kept warm.
+* The client sends its command line, its working directory, the value of one environment variable and its standard streams :
+* the command reads and writes them directly, then the client exits with the status of the command.
+* Each request is handled by its own processes, so that the requests run concurrently and a command may exit at any point.
+*/
+
+#if !defined(_WIN32) && !defined(WIN32)
+    #define DAEMON_ENABLED 1
+#endif
+
+// Command run for a request, returns its exit status
+typedef int (*DaemonCommand)(int argc, char* argv[]);
+
+// Runs the commands received on the socket, only returns if the socket can't be served
+int daemon_serve(const char* socket_path, const char* env_name, DaemonCommand command);
+// Sends the command to the daemon and waits for its exit status, returns false if no daemon listens on the socket
+bool daemon_request(const char* socket_path, int argc, char* argv[], const char* env_name, int* exit_status);
+
+#endif // DAEMON_H
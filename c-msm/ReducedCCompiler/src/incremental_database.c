@@ -0,0 +1,316 @@
+#include "incremental_database.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compile_cache.h"
+
+#define DATABASE_MAGIC      "#rcc-incremental 1"
+#define DATABASE_OPTIONS    "#options"
+#define DATABASE_FUNCTION   "#function"
+#define TEMPORARY_EXTENSION ".tmp"
+
+static uint64_t hash_name(const char* name, size_t length)
+{
+    return cache_hash_bytes(CACHE_HASH_INIT, name, length);
+}
+
+static void* allocate(void* pointer, size_t size, const char* description)
+{
+    void* allocated = realloc(pointer, size);
+    if (allocated == NULL)
+    {
+        fprintf(stderr, "Failed to allocate memory for the %s of the incremental database\n", description);
+        exit(EXIT_FAILURE);
+    }
+    return allocated;
+}
+
+// Parses the content of the previous database, returns false if it is malformed
+static bool parse_previous_functions(IncrementalDatabase* database)
+{
+    const char* content = database->previous_content.content;
+    size_t size = database->previous_content.size;
+
+    size_t position = strlen(DATABASE_MAGIC "\n");
+    if (size < position || strncmp(content, DATABASE_MAGIC "\n", position) != 0)
+        return false;
+    unsigned long long options_hash;
+    int nb_read = 0;
+    if (sscanf(content + position, DATABASE_OPTIONS " %llx\n%n", &options_hash, &nb_read) != 1 || nb_read == 0)
+        return false;
+    if (options_hash != database->options_hash)
+        return true; // Compiled with other options, nothing can be reused
+    position += (size_t) nb_read;
+
+    int capacity = 0;
+    while (position < size)
+    {
+        const char* line = content + position;
+        const char* line_end = memchr(line, '\n', size - position);
+        if (line_end == NULL || strncmp(line, DATABASE_FUNCTION " ", strlen(DATABASE_FUNCTION " ")) != 0)
+            return false;
+
+        const char* name = line + strlen(DATABASE_FUNCTION " ");
+        const char* name_end = memchr(name, ' ', (size_t) (line_end - name));
+        unsigned long long fingerprint;
+        int nb_labels;
+        int is_inlinable;
+        long code_size;
+        if (name_end == NULL || name_end == name
+            || sscanf(name_end, " %llx %d %d %ld", &fingerprint, &nb_labels, &is_inlinable, &code_size) != 4
+            || nb_labels < 0 || code_size < 0 || (size_t) code_size > size - (size_t) (line_end + 1 - content))
+            return false;
+
+        if (database->nb_previous_functions == capacity)
+        {
+            capacity = (capacity == 0) ? 64 : 2 * capacity;
+            database->previous_functions = allocate(database->previous_functions, sizeof(IncrementalFunction) * capacity, "functions");
+        }
+        IncrementalFunction* function = database->previous_functions + database->nb_previous_functions++;
+        function->name          = name;
+        function->name_length   = (int) (name_end - name);
+        function->fingerprint   = (uint64_t) fingerprint;
+        function->nb_labels     = nb_labels;
+        function->is_inlinable  = is_inlinable != 0;
+        function->code          = line_end + 1;
+        function->code_size     = (size_t) code_size;
+        function->is_code_owned = false;
+        position = (size_t) (function->code + function->code_size - content);
+    }
+    return true;
+}
+
+static void index_previous_functions(IncrementalDatabase* database)
+{
+    int index_size = 64;
+    while (index_size < 2 * database->nb_previous_functions)
+        index_size *= 2;
+    database->previous_index      = allocate(NULL, sizeof(int) * index_size, "index");
+    database->previous_index_size = index_size;
+    for (int i = 0; i < index_size; i++)
+        database->previous_index[i] = -1;
+
+    for (int i = 0; i < database->nb_previous_functions; i++)
+    {
+        const IncrementalFunction* function = database->previous_functions + i;
+        int slot = (int) (hash_name(function->name, (size_t) function->name_length) & (uint64_t) (index_size - 1));
+        while (database->previous_index[slot] != -1)
+            slot = (slot + 1) & (index_size - 1);
+        database->previous_index[slot] = i;
+    }
+}
+
+IncrementalDatabase incremental_database_open(const char* path, uint64_t options_hash)
+{
+    assert(path != NULL);
+
+    IncrementalDatabase database = {0};
+    database.path         = path;
+    database.options_hash = options_hash;
+
+    FILE* file = fopen(path, "r");
+    if (file != NULL)
+    {
+        database.previous_content = source_buffer_load(file);
+        if ( ! parse_previous_functions(&database))
+        {
+            fprintf(stderr, "The incremental database \"%s\" is malformed, the whole source is compiled\n", path);
+            database.nb_previous_functions = 0;
+        }
+    }
+    index_previous_functions(&database);
+    return database;
+}
+
+void incremental_database_free(IncrementalDatabase* database)
+{
+    assert(database != NULL);
+
+    for (int i = 0; i < database->nb_functions; i++)
+    {
+        if (database->functions[i].is_code_owned)
+            free((char*) database->functions[i].code);
+    }
+    free(database->functions);
+    free(database->signatures);
+    free(database->previous_index);
+    free(database->previous_functions);
+    if (database->previous_content.content != NULL)
+        source_buffer_free(&(database->previous_content));
+}
+
+static const IncrementalSignature* find_signature(const IncrementalDatabase* database, const char* name)
+{
+    if (database->signatures_size == 0)
+        return NULL;
+
+    int slot = (int) (hash_name(name, strlen(name)) & (uint64_t) (database->signatures_size - 1));
+    while (database->signatures[slot].name != NULL)
+    {
+        if (strcmp(database->signatures[slot].name, name) == 0)
+            return database->signatures + slot;
+        slot = (slot + 1) & (database->signatures_size - 1);
+    }
+    return NULL;
+}
+
+static void set_signature(IncrementalDatabase* database, const char* name, uint64_t signature)
+{
+    // The table is at most half full
+    if (2 * (database->nb_signatures + 1) > database->signatures_size)
+    {
+        IncrementalSignature* signatures = database->signatures;
+        int size = database->signatures_size;
+        database->signatures_size = (size == 0) ? 256 : 2 * size;
+        database->signatures = allocate(NULL, sizeof(IncrementalSignature) * database->signatures_size, "signatures");
+        memset(database->signatures, 0, sizeof(IncrementalSignature) * database->signatures_size);
+        database->nb_signatures = 0;
+        for (int i = 0; i < size; i++)
+        {
+            if (signatures[i].name != NULL)
+                set_signature(database, signatures[i].name, signatures[i].signature);
+        }
+        free(signatures);
+    }
+
+    int slot = (int) (hash_name(name, strlen(name)) & (uint64_t) (database->signatures_size - 1));
+    while (database->signatures[slot].name != NULL && strcmp(database->signatures[slot].name, name) != 0)
+        slot = (slot + 1) & (database->signatures_size - 1);
+    if (database->signatures[slot].name == NULL)
+        database->nb_signatures++;
+    database->signatures[slot].name      = name;
+    database->signatures[slot].signature = signature;
+}
+
+// Hashes the names referenced by the node with the signatures of the global symbols they denote so far
+// A local variable that hides a global one adds the signature of the global one, which only compiles the function more often
+static uint64_t hash_references(const IncrementalDatabase* database, const SyntacticNode* node, uint64_t hash)
+{
+    if (node->type == NODE_REF || node->type == NODE_CALL)
+    {
+        const IncrementalSignature* signature = find_signature(database, node->value.str_val);
+        uint64_t value = (signature == NULL) ? 0 : signature->signature;
+        hash = cache_hash_bytes(hash, node->value.str_val, strlen(node->value.str_val) + 1);
+        hash = cache_hash_bytes(hash, &value, sizeof(value));
+    }
+    for (int i = 0; i < node->nb_children; i++)
+        hash = hash_references(database, node->children[i], hash);
+    return hash;
+}
+
+uint64_t incremental_database_fingerprint(const IncrementalDatabase* database, const SyntacticNode* function, uint64_t source_hash)
+{
+    assert(database != NULL && function != NULL && function->type == NODE_FUNCTION);
+
+    return hash_references(database, function, source_hash);
+}
+
+static void sign_variables(IncrementalDatabase* database, const SyntacticNode* node, uint64_t source_hash)
+{
+    if (node->type == NODE_DECL)
+    {
+        // The code addresses the variable by its offset
+        int offset = node->stack_offset;
+        set_signature(database, node->value.str_val, cache_hash_bytes(source_hash, &offset, sizeof(offset)));
+    }
+    else
+    {
+        for (int i = 0; i < node->nb_children; i++)
+            sign_variables(database, node->children[i], source_hash);
+    }
+}
+
+void incremental_database_sign(IncrementalDatabase* database, const SyntacticNode* declaration, uint64_t hash, bool is_inlinable)
+{
+    assert(database != NULL && declaration != NULL);
+
+    if (declaration->type == NODE_FUNCTION)
+    {
+        // The callers only depend on the body of the functions they inline
+        int nb_params = declaration->children[0]->nb_children;
+        uint64_t signature = cache_hash_bytes(CACHE_HASH_INIT, &nb_params, sizeof(nb_params));
+        if (is_inlinable)
+            signature = cache_hash_bytes(signature, &hash, sizeof(hash));
+        set_signature(database, declaration->value.str_val, signature);
+    }
+    else
+        sign_variables(database, declaration, hash);
+}
+
+const IncrementalFunction* incremental_database_find(const IncrementalDatabase* database, const char* name, uint64_t fingerprint)
+{
+    assert(database != NULL && name != NULL);
+
+    size_t name_length = strlen(name);
+    int slot = (int) (hash_name(name, name_length) & (uint64_t) (database->previous_index_size - 1));
+    while (database->previous_index[slot] != -1)
+    {
+        const IncrementalFunction* function = database->previous_functions + database->previous_index[slot];
+        if ((size_t) function->name_length == name_length && strncmp(function->name, name, name_length) == 0)
+            return (function->fingerprint == fingerprint) ? function : NULL;
+        slot = (slot + 1) & (database->previous_index_size - 1);
+    }
+    return NULL;
+}
+
+void incremental_database_add(IncrementalDatabase* database, const char* name, uint64_t fingerprint, int nb_labels, bool is_inlinable,
+                              const char* code, size_t code_size, bool is_code_owned)
+{
+    assert(database != NULL && name != NULL && code != NULL);
+
+    if (database->nb_functions == database->functions_capacity)
+    {
+        database->functions_capacity = (database->functions_capacity == 0) ? 64 : 2 * database->functions_capacity;
+        database->functions = allocate(database->functions, sizeof(IncrementalFunction) * database->functions_capacity, "functions");
+    }
+    IncrementalFunction* function = database->functions + database->nb_functions++;
+    function->name          = name;
+    function->name_length   = (int) strlen(name);
+    function->fingerprint   = fingerprint;
+    function->nb_labels     = nb_labels;
+    function->is_inlinable  = is_inlinable;
+    function->code          = code;
+    function->code_size     = code_size;
+    function->is_code_owned = is_code_owned;
+    if ( ! is_code_owned)
+        database->nb_reused++;
+}
+
+void incremental_database_save(IncrementalDatabase* database)
+{
+    assert(database != NULL);
+
+    size_t size = strlen(database->path) + sizeof(TEMPORARY_EXTENSION);
+    char* temporary_path = allocate(NULL, size, "path");
+    snprintf(temporary_path, size, "%s" TEMPORARY_EXTENSION, database->path);
+
+    // The database is written aside, so that a compilation that stops midway leaves the previous one
+    FILE* file = fopen(temporary_path, "w");
+    bool is_written = file != NULL;
+    if (is_written)
+    {
+        fprintf(file, DATABASE_MAGIC "\n");
+        fprintf(file, DATABASE_OPTIONS " %016llx\n", (unsigned long long) database->options_hash);
+        for (int i = 0; i < database->nb_functions; i++)
+        {
+            const IncrementalFunction* function = database->functions + i;
+            fprintf(file, DATABASE_FUNCTION " %s %016llx %d %d %ld\n", function->name, (unsigned long long) function->fingerprint,
+                    function->nb_labels, function->is_inlinable ? 1 : 0, (long) function->code_size);
+            fwrite(function->code, sizeof(char), function->code_size, file);
+        }
+        is_written = ! ferror(file);
+        is_written = (fclose(file) == 0) && is_written;
+    }
+    // The previous database may have to be removed first, e.g. on Windows
+    if (is_written && rename(temporary_path, database->path) != 0)
+        is_written = remove(database->path) == 0 && rename(temporary_path, database->path) == 0;
+    if ( ! is_written)
+    {
+        fprintf(stderr, "Failed to write the incremental database \"%s\"\n", database->path);
+        remove(temporary_path);
+    }
+    free(temporary_path);
+}
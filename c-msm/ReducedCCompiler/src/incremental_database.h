@@ -0,0 +1,84 @@
+#ifndef INCREMENTAL_DATABASE_H
+#define INCREMENTAL_DATABASE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "source_buffer.h"
+#include "syntactic_node.h"
+
+/*
+* The database of an incremental compilation keeps the code of each function of the previous compilation of a source,
+* under the fingerprint of the function : the hash of its source, from its first token to its last, and of the signatures
+* of the global symbols it references.
+* A function whose fingerprint didn't change is only declared, its code is copied from the database.
+*
+* The signature of a global variable changes with its declaration and its offset, the one of a function with its number
+* of parameters, and with its fingerprint when its body is inlined in its callers : the functions depending on a modified
+* declaration are compiled again. The database is a text file written aside then renamed once the compilation succeeded.
+*
+*   #rcc-incremental 1
+*   #options <hash of the compiler, the options and the runtime>
+*   #function <name> <fingerprint> <nb labels> <inlinable> <size of the code>
+*   <code of the function, its labels are relative>
+*/
+
+typedef struct IncrementalFunction_s IncrementalFunction;
+struct IncrementalFunction_s
+{
+    const char* name;
+    int         name_length;
+    uint64_t    fingerprint;
+    int         nb_labels;
+    bool        is_inlinable;   // The callers inline its body, so it is always compiled
+    const char* code;
+    size_t      code_size;
+    bool        is_code_owned;  // The code of a reused function stays in the previous database
+};
+
+typedef struct IncrementalSignature_s IncrementalSignature;
+struct IncrementalSignature_s
+{
+    const char* name;
+    uint64_t    signature;
+};
+
+typedef struct IncrementalDatabase_s IncrementalDatabase;
+struct IncrementalDatabase_s
+{
+    const char*           path;
+    uint64_t              options_hash;
+    SourceBuffer          previous_content;
+    IncrementalFunction*  previous_functions;
+    int                   nb_previous_functions;
+    int*                  previous_index;        // Open addressing hash table of the previous functions
+    int                   previous_index_size;   // Power of 2
+    IncrementalFunction*  functions;             // Functions of the compilation, written in the database once it succeeded
+    int                   nb_functions;
+    int                   functions_capacity;
+    IncrementalSignature* signatures;            // Open addressing hash table of the global symbols declared so far
+    int                   signatures_size;       // Power of 2
+    int                   nb_signatures;
+    int                   nb_reused;             // Functions whose code comes from the previous database
+};
+
+// Loads the database of the previous compilation, it is empty if the file doesn't exist or was written with other options
+IncrementalDatabase incremental_database_open(const char* path, uint64_t options_hash);
+void incremental_database_free(IncrementalDatabase* database);
+
+// Hashes the source of the function with the signatures of the global symbols it references, before its semantic analysis
+uint64_t incremental_database_fingerprint(const IncrementalDatabase* database, const SyntacticNode* function, uint64_t source_hash);
+// Sets the signature of the global symbols declared by a global declaration after its semantic analysis
+// 'hash' is the fingerprint of a function or the source hash of global variables
+void incremental_database_sign(IncrementalDatabase* database, const SyntacticNode* declaration, uint64_t hash, bool is_inlinable);
+
+// Finds the function compiled with the same fingerprint by the previous compilation, NULL if the function must be compiled
+const IncrementalFunction* incremental_database_find(const IncrementalDatabase* database, const char* name, uint64_t fingerprint);
+// Adds a function of the compilation, a reused function gives the code found in the previous database
+void incremental_database_add(IncrementalDatabase* database, const char* name, uint64_t fingerprint, int nb_labels, bool is_inlinable,
+                              const char* code, size_t code_size, bool is_code_owned);
+// Writes the functions of the compilation, a failure is only reported since the next compilation can do without the database
+void incremental_database_save(IncrementalDatabase* database);
+
+#endif // INCREMENTAL_DATABASE_H
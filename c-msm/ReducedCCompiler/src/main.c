@@ -14,6 +14,13 @@
 #include "semantic_analysis.h"
 #include "code_generation.h"
 #include "optimization.h"
+#include "peephole.h"
+#include "source_buffer.h"
+#include "daemon.h"
+#include "compile_cache.h"
+#include "object_file.h"
+#include "incremental_database.h"
+#include "build_id.h"
 
 
 #define RCC_NAME            "rcc"
@@ -30,46 +37,122 @@
 
     #define STAT(pathname, statbuf) _stat(pathname, statbuf)
     #define STAT_S _stat
+
+    #define TRUNCATE(file) _chsize(_fileno(file), 0)
 #else
+    #include <sys/wait.h>
     #include <unistd.h>
     #define ACCESS(pathname, mode) access(pathname, mode)
 
     #define STAT(pathname, statbuf) stat(pathname, statbuf)
     #define STAT_S stat
+
+    #define TRUNCATE(file) ftruncate(fileno(file), 0)
+
+    // The compilations of a batch run in child processes that share the analysed runtime
+    #define BATCH_ENABLED 1
 #endif
 
+#define STDIN_FILENAME  "-"   // Input file name that reads the source from the standard input
+#define MAX_INPUT_FILES 16384
+#define MSM_EXTENSION   ".msm"
+#define DEFAULT_CACHE_SIZE 65536 // KiB
+
 #define STAGE_LEXICAL   "lexical"
 #define STAGE_SYNTACTIC "syntactic"
 #define STAGE_SEMANTIC  "semantic"
 
-// Loads the source file content as a null terminated buffer allocated dynamically and closes the FILE*
-char* load_file_content_and_close(FILE * file);
-
 void lexical_analysis_on_file(FILE* in_file, int verbose, FILE* out_file);
-void syntactic_analysis_on_file(FILE* in_file, int verbose, unsigned char optimisations, FILE* out_file);
-void semantic_analysis_on_file(FILE* in_file, int verbose, unsigned char optimisations, FILE* out_file, FILE * runtime_file);
-void compile_file(FILE* in_file, int verbose, unsigned char optimisations, FILE* out_file, FILE * runtime_file);
+void syntactic_analysis_on_file(FILE* in_file, int verbose, optimization_t optimisations, FILE* out_file);
+void semantic_analysis_on_file(FILE* in_file, int verbose, optimization_t optimisations, FILE* out_file, FILE * runtime_file);
+// The functions are generated by 'nb_jobs' threads
+
+typedef struct AnalysedRuntime_s AnalysedRuntime;
+struct AnalysedRuntime_s
+{
+    SyntacticAnalyzer analyzer;    // Its tree is NULL without runtime
+    SymbolTable       table;       // Symbols of the primitive functions and of the runtime
+};
+
+// Opens the source file, the process exits if it can't be read
+FILE* open_source_file(const char* filename);
+// Parses and analyses the runtime before the program
+AnalysedRuntime analyse_runtime(FILE* runtime_file, optimization_t optimisations);
+// The functions are generated by 'nb_jobs' threads, the source is freed once parsed
+void compile_file(SourceBuffer* usercode_source, int verbose, optimization_t optimisations, FILE* out_file, AnalysedRuntime* runtime, int nb_jobs);
+// Hashes what the generated code depends on besides the source : the compiler, the options and the runtime, which is rewound
+Sha256 hash_compilation_options(FILE* runtime_file, optimization_t optimisations);
+// The incremental database only tells apart the options it was written with, by the first bytes of their hash
+uint64_t options_fingerprint(const Sha256* options_hash);
+// Compiles the source after a miss of the cache, then stores its code in the cache under the key
+void compile_file_to_cache(SourceBuffer* usercode_source, optimization_t optimisations, FILE* out_file, AnalysedRuntime* runtime, int nb_jobs,
+                           const CompileCache* cache, const CacheKey* key);
+// Compiles each file in 'outdir_name', 'nb_jobs' at a time, the runtime is analysed once for all the files
+// The diagnostics of each file are reported together, followed by a summary. Returns EXIT_FAILURE if a compilation failed
+// Without cache, 'cache' is NULL
+int compile_batch(const char** filenames, int nb_files, const char* outdir_name, int verbose, optimization_t optimisations, FILE* runtime_file, int nb_jobs,
+                  const CompileCache* cache, const Sha256* options_hash);
+// Analyses the runtime once, then runs the command lines sent by the clients until the daemon is stopped
+int serve_compilations(const char* socket_path, const char* runtime_path, FILE* runtime_file, optimization_t optimisations);
+// Runs the rcc command line, each request to the daemon runs it in its own process
+int rcc_main(int argc, char* argv[]);
+// Compiles the source one global declaration at a time : each one is analysed, optimized, generated then freed before the next one is parsed
+// An incremental compilation reuses the code of the functions kept in the database that didn't change, without database 'database' is NULL
+void compile_file_streamed(FILE* in_file, optimization_t optimisations, FILE* out_file, FILE * runtime_file, IncrementalDatabase* database);
+// Compiles the source, without runtime, to an object file that msmld links with the other modules of the program
+// The declarations are compiled one at a time as with compile_file_streamed(), the code of every function is kept
+void compile_object(FILE* in_file, optimization_t optimisations, FILE* out_file);
+// Replaces the 'malloc', 'free' and 'realloc' functions of the runtime by its bump allocator
+void select_bump_allocator(SyntacticNode* runtime_tree);
 
 
 /* global arg_xxx structs */
-struct arg_lit *verb, *help, *version, *no_runtime;
-struct arg_file *output, *input, *runtime_filename;
+struct arg_lit *verb, *help, *version, *no_runtime, *bump_malloc, *stream, *object;
+struct arg_file *output, *input, *runtime_filename, *outdir, *daemon_socket, *client_socket, *cache_dir, *incremental_db;
 struct arg_str *stage;
-struct arg_lit *no_const_fold;
+struct arg_int *jobs, *cache_size;
+struct arg_lit *cache_stats;
+struct arg_lit *no_const_fold, *no_inline, *no_tail_call, *no_licm, *no_fused_branch, *no_logical_branch, *no_jump_threading, *no_ssa, *no_stack_sched, *no_strength_red, *no_indexed_access;
 struct arg_end *end;
 
 int main(int argc, char* argv[])
+{
+    return rcc_main(argc, argv);
+}
+
+int rcc_main(int argc, char* argv[])
 {
     /* the global arg_xxx structs are initialised within the argtable */
     void* argtable[] =
     {
-        input            = arg_filen(NULL, NULL,      "<file>",                         1, 1, "input file"),
+        input            = arg_filen(NULL, NULL,      "<file>",                         0, MAX_INPUT_FILES, "input file, '-' for the standard input, several files need --outdir"),
         output           = arg_filen( "o", "output",  "<file>",                         0, 1, "output file"),
+        outdir           = arg_filen(NULL, "outdir",  "<dir>",                          0, 1, "compile each input file in <dir>/<name>.msm, -j of them at a time"),
         verb             = arg_litn(  "v", "verbose",                                   0, 1, "verbose output"),
         no_runtime       = arg_litn( NULL, "no-runtime",                                0, 1, "no runtime"),
         runtime_filename = arg_filen(NULL, "runtime", "<file>",                         0, 1, "runtime file, default to environnment variable RCC_RUNTIME"),
+        bump_malloc      = arg_litn( NULL, "bump-malloc",                               0, 1, "compile malloc of the runtime as a bump allocator whose free does nothing"),
         stage            = arg_strn( NULL, "stage",   "<lexical|syntactical|semantic>", 0, 1, "stop the compilation at this stage"),
+        stream           = arg_litn( NULL, "stream",                                    0, 1, "compile one global declaration at a time, the memory used doesn't grow with the size of the functions"),
+        object           = arg_litn(  "c", "object",                                    0, 1, "compile to an object file without runtime, linked with the other object files by msmld"),
+        jobs             = arg_intn(  "j", "jobs",    "<n>",                            0, 1, "number of threads generating the functions, or of files compiled at a time with --outdir, default to 1"),
+        cache_dir        = arg_filen(NULL, "cache",   "<dir>",                          0, 1, "reuse the code generated in <dir> for the same source, runtime and options"),
+        cache_size       = arg_intn( NULL, "cache-size", "<KiB>",                       0, 1, "maximal size of the cache, the least recently used codes are removed, default to 65536"),
+        cache_stats      = arg_litn( NULL, "cache-stats",                               0, 1, "display the statistics of the cache and exit"),
+        incremental_db   = arg_filen(NULL, "incremental", "<file>",                     0, 1, "keep the code of each function in <file>, only the functions modified or depending on a modified declaration are compiled again"),
         no_const_fold    = arg_litn( NULL, "no-const-fold",                             0, 1, "disable constant folding"),
+        no_inline        = arg_litn( NULL, "no-inline",                                 0, 1, "disable inlining of small functions"),
+        no_tail_call     = arg_litn( NULL, "no-tail-call",                              0, 1, "disable self-recursive tail call elimination"),
+        no_licm          = arg_litn( NULL, "no-licm",                                   0, 1, "disable loop-invariant code motion"),
+        no_fused_branch  = arg_litn( NULL, "no-fused-branch",                           0, 1, "disable compare-and-branch instructions"),
+        no_logical_branch= arg_litn( NULL, "no-logical-branch",                         0, 1, "disable jumps of '&&' and '||' in conditions"),
+        no_jump_threading= arg_litn( NULL, "no-jump-threading",                         0, 1, "disable jump threading and label coalescing"),
+        no_ssa           = arg_litn( NULL, "no-ssa",                                    0, 1, "disable the optimizations on the SSA form"),
+        no_stack_sched   = arg_litn( NULL, "no-stack-scheduling",                       0, 1, "disable the reuse of the values left on the stack"),
+        no_strength_red  = arg_litn( NULL, "no-strength-reduction",                     0, 1, "disable strength reduction of the operations by a power of two"),
+        no_indexed_access= arg_litn( NULL, "no-indexed-access",                         0, 1, "disable the indexed memory instructions"),
+        daemon_socket    = arg_filen(NULL, "daemon",  "<socket>",                       0, 1, "keep the runtime analysed and compile the requests of the clients on this UNIX socket"),
+        client_socket    = arg_filen(NULL, "client",  "<socket>",                       0, 1, "send the compilation to the daemon on this socket, compile locally if there is none"),
         help             = arg_litn(  "h", "help",                                      0, 1, "display this help and exit"),
         version          = arg_litn( NULL, "version",                                   0, 1, "display version info and exit"),
         end              = arg_end(20),
@@ -100,47 +183,221 @@ int main(int argc, char* argv[])
         printf("Try '%s --help' for more information.\n", RCC_NAME);
         exit(EXIT_FAILURE);
     }
+    // The daemon and the statistics of the cache are the only commands without input file
+    else if (input->count == 0 && daemon_socket->count == 0 && cache_stats->count == 0)
+    {
+        printf("%s: missing option %s\n", RCC_NAME, input->hdr.datatype);
+        printf("Try '%s --help' for more information.\n", RCC_NAME);
+        exit(EXIT_FAILURE);
+    }
 
-    FILE* source_file = NULL;
-    FILE* output_file = stdout;
-
-    if (ACCESS(*(input->filename), R_OK) == -1)
+    if (client_socket->count > 0)
     {
-        // TODO ACCESS() doesn't fail on windows when an asked permission is denied
-        if (errno == EACCES)
+        if (daemon_socket->count > 0)
         {
-            fprintf(stderr, "%s: error. %s : Permission denied\n", RCC_NAME, *(input->filename));
+            fprintf(stderr, "%s: invalid option. \"--%s\" option is incompatible with \"--%s\" option.\n",
+                    RCC_NAME, client_socket->hdr.longopts, daemon_socket->hdr.longopts);
             exit(EXIT_FAILURE);
         }
-        else if (errno == ENOENT)
+
+        // The daemon runs the same command line without the client option
+        char** arguments = malloc(sizeof(char*) * (argc + (size_t) 1));
+        if (arguments == NULL)
         {
-            fprintf(stderr, "%s: error. %s : No such file or directory\n", RCC_NAME, *(input->filename));
+            perror("Failed to allocate memory for the arguments of the daemon");
             exit(EXIT_FAILURE);
         }
+        int nb_arguments = 0;
+        for (int i = 0; i < argc; i++)
+        {
+            if (strcmp(argv[i], "--client") == 0)
+                i++;
+            else if (strncmp(argv[i], "--client=", strlen("--client=")) != 0)
+                arguments[nb_arguments++] = argv[i];
+        }
+        arguments[nb_arguments] = NULL;
+
+        int exit_status;
+        if (daemon_request(*(client_socket->filename), nb_arguments, arguments, RCC_RUNTIME_ENV_VAR, &exit_status))
+            exit(exit_status);
+        free(arguments);
     }
 
-    source_file = fopen(*(input->filename), "r");
-    if (source_file == NULL)
+    CompileCache cache = {0};
+    if (cache_dir->count > 0)
     {
-        perror("failed to open the source file");
+        struct arg_hdr* incompatible_option = NULL;
+        if (daemon_socket->count > 0)
+            incompatible_option = &(daemon_socket->hdr);
+        else if (stage->count > 0)
+            incompatible_option = &(stage->hdr);
+        else if (stream->count > 0)
+            incompatible_option = &(stream->hdr);
+        else if (verb->count > 0)
+            incompatible_option = &(verb->hdr);
+        else if (object->count > 0)
+            incompatible_option = &(object->hdr);
+        if (incompatible_option != NULL)
+        {
+            fprintf(stderr, "%s: invalid option. \"--%s\" option is incompatible with \"--%s\" option.\n",
+                    RCC_NAME, cache_dir->hdr.longopts, incompatible_option->longopts);
+            exit(EXIT_FAILURE);
+        }
+
+        long long max_size = (long long) DEFAULT_CACHE_SIZE * 1024;
+        if (cache_size->count > 0)
+        {
+            if (*(cache_size->ival) < 0)
+            {
+                fprintf(stderr, "%s: invalid option. The size of the cache can't be negative\n", RCC_NAME);
+                exit(EXIT_FAILURE);
+            }
+            max_size = (long long) *(cache_size->ival) * 1024;
+        }
+        cache = compile_cache_open(*(cache_dir->filename), max_size);
+    }
+    else if (cache_size->count > 0 || cache_stats->count > 0)
+    {
+        fprintf(stderr, "%s: invalid option. \"--%s\" option needs the \"--%s\" option.\n",
+                RCC_NAME, (cache_size->count > 0) ? cache_size->hdr.longopts : cache_stats->hdr.longopts, cache_dir->hdr.longopts);
         exit(EXIT_FAILURE);
     }
 
-    if (output->count > 0)
+    if (cache_stats->count > 0)
     {
-        output_file = fopen(*(output->filename), "w");
-        if (output_file == NULL)
+        if (input->count > 0)
+        {
+            fprintf(stderr, "%s: invalid option. \"--%s\" option doesn't compile the input files.\n", RCC_NAME, cache_stats->hdr.longopts);
+            exit(EXIT_FAILURE);
+        }
+        compile_cache_print_stats(&cache, stdout);
+        exit(EXIT_SUCCESS);
+    }
+
+    if (object->count > 0)
+    {
+        // The runtime is linked as an object file of its own
+        struct arg_hdr* incompatible_option = NULL;
+        if (runtime_filename->count > 0)
+            incompatible_option = &(runtime_filename->hdr);
+        else if (bump_malloc->count > 0)
+            incompatible_option = &(bump_malloc->hdr);
+        else if (daemon_socket->count > 0)
+            incompatible_option = &(daemon_socket->hdr);
+        else if (outdir->count > 0)
+            incompatible_option = &(outdir->hdr);
+        else if (stage->count > 0)
+            incompatible_option = &(stage->hdr);
+        else if (stream->count > 0)
+            incompatible_option = &(stream->hdr);
+        else if (jobs->count > 0)
+            incompatible_option = &(jobs->hdr);
+        if (incompatible_option != NULL)
+        {
+            fprintf(stderr, "%s: invalid option. \"--%s\" option is incompatible with \"--%s\" option.\n",
+                    RCC_NAME, object->hdr.longopts, incompatible_option->longopts);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (incremental_db->count > 0)
+    {
+        // The declarations are compiled one at a time as with --stream, a single source is compiled
+        struct arg_hdr* incompatible_option = NULL;
+        if (cache_dir->count > 0)
+            incompatible_option = &(cache_dir->hdr);
+        else if (object->count > 0)
+            incompatible_option = &(object->hdr);
+        else if (daemon_socket->count > 0)
+            incompatible_option = &(daemon_socket->hdr);
+        else if (outdir->count > 0)
+            incompatible_option = &(outdir->hdr);
+        else if (stage->count > 0)
+            incompatible_option = &(stage->hdr);
+        else if (jobs->count > 0)
+            incompatible_option = &(jobs->hdr);
+        if (incompatible_option != NULL)
         {
-            fprintf(stderr, "%s: error. Failed to open the output file \"%s\"\n", RCC_NAME, *(output->filename));
+            fprintf(stderr, "%s: invalid option. \"--%s\" option is incompatible with \"--%s\" option.\n",
+                    RCC_NAME, incremental_db->hdr.longopts, incompatible_option->longopts);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    FILE* source_file = NULL;
+    FILE* output_file = stdout;
+    int is_batch = (outdir->count > 0);
+
+    if (daemon_socket->count > 0)
+    {
+        if (input->count > 0 || output->count > 0 || outdir->count > 0 || stage->count > 0 || stream->count > 0)
+        {
+            fprintf(stderr, "%s: invalid option. \"--%s\" option only takes the runtime and optimization options.\n",
+                    RCC_NAME, daemon_socket->hdr.longopts);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (is_batch)
+    {
+        if (output->count > 0)
+        {
+            fprintf(stderr, "%s: invalid option. \"--%s\" option is incompatible with \"--%s\" option.\n",
+                    RCC_NAME, output->hdr.longopts, outdir->hdr.longopts);
             exit(EXIT_FAILURE);
         }
+        if (stage->count > 0 || stream->count > 0)
+        {
+            fprintf(stderr, "%s: invalid option. \"--%s\" option is incompatible with \"--%s\" option.\n",
+                    RCC_NAME, (stage->count > 0) ? stage->hdr.longopts : stream->hdr.longopts, outdir->hdr.longopts);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (input->count > 1)
+    {
+        fprintf(stderr, "%s: invalid option. Several input files need the \"--%s\" option.\n", RCC_NAME, outdir->hdr.longopts);
+        exit(EXIT_FAILURE);
+    }
+    else
+    {
+        source_file = open_source_file(*(input->filename));
+
+        if (output->count > 0)
+        {
+            output_file = fopen(*(output->filename), "w");
+            if (output_file == NULL)
+            {
+                fprintf(stderr, "%s: error. Failed to open the output file \"%s\"\n", RCC_NAME, *(output->filename));
+                exit(EXIT_FAILURE);
+            }
+        }
     }
 
     optimization_t opti = NO_OPTIMIZATION;
     if (no_const_fold->count == 0)
         opti |= OPTI_CONST_FOLD;
+    if (no_inline->count == 0)
+        opti |= OPTI_INLINE;
+    if (no_tail_call->count == 0)
+        opti |= OPTI_TAIL_CALL;
+    if (no_licm->count == 0)
+        opti |= OPTI_LICM;
+    if (no_fused_branch->count == 0)
+        opti |= OPTI_FUSED_BRANCH;
+    if (no_logical_branch->count == 0)
+        opti |= OPTI_LOGICAL_BRANCH;
+    if (no_jump_threading->count == 0)
+        opti |= OPTI_JUMP_THREADING;
+    if (no_ssa->count == 0)
+        opti |= OPTI_SSA;
+    if (no_stack_sched->count == 0)
+        opti |= OPTI_STACK_SCHEDULING;
+    if (no_strength_red->count == 0)
+        opti |= OPTI_STRENGTH_REDUCTION;
+    if (no_indexed_access->count == 0)
+        opti |= OPTI_INDEXED_ACCESS;
 
     FILE* runtime_file = NULL;
+    char* runtime_path = NULL;
     if (no_runtime->count > 0)
     {
         if (runtime_filename->count > 0)
@@ -149,10 +406,15 @@ int main(int argc, char* argv[])
                     RCC_NAME, runtime_filename->hdr.longopts, no_runtime->hdr.longopts);
             exit(EXIT_FAILURE);
         }
+        if (bump_malloc->count > 0)
+        {
+            fprintf(stderr, "%s: invalid option. \"--%s\" option is incompatible with \"--%s\" option.\n",
+                    RCC_NAME, bump_malloc->hdr.longopts, no_runtime->hdr.longopts);
+            exit(EXIT_FAILURE);
+        }
     }
-    else
+    else if (object->count == 0)
     {
-        char* runtime_path = NULL;
         if (runtime_filename->count > 0)
             runtime_path = *( (char**) (runtime_filename)->filename);
         else
@@ -175,10 +437,79 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (stream->count > 0 && stage->count > 0)
+    {
+        fprintf(stderr, "%s: invalid option. \"--%s\" option is incompatible with \"--%s\" option.\n",
+                RCC_NAME, stream->hdr.longopts, stage->hdr.longopts);
+        exit(EXIT_FAILURE);
+    }
+
+    if (stream->count > 0 && jobs->count > 0)
+    {
+        fprintf(stderr, "%s: invalid option. \"--%s\" option is incompatible with \"--%s\" option.\n",
+                RCC_NAME, stream->hdr.longopts, jobs->hdr.longopts);
+        exit(EXIT_FAILURE);
+    }
+    int nb_jobs = 1;
+    if (jobs->count > 0)
+    {
+        nb_jobs = *(jobs->ival);
+        if (nb_jobs < 1)
+        {
+            fprintf(stderr, "%s: invalid option. The number of jobs must be at least 1\n", RCC_NAME);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    Sha256 options_hash = {0};
+    if (cache_dir->count > 0 || incremental_db->count > 0)
+        options_hash = hash_compilation_options(runtime_file, opti);
+
     // Stage handling
-    if (stage->count == 0)
+    if (daemon_socket->count > 0)
+    {
+        exitcode = serve_compilations(*(daemon_socket->filename), runtime_path, runtime_file, opti);
+    }
+    else if (is_batch)
+    {
+        exitcode = compile_batch(input->filename, input->count, *(outdir->filename), verb->count, opti, runtime_file, nb_jobs,
+                                 (cache_dir->count > 0) ? &cache : NULL, &options_hash);
+    }
+    else if (stage->count == 0)
     {
-        compile_file(source_file, verb->count, opti, output_file, runtime_file);
+        if (object->count > 0)
+            compile_object(source_file, opti, output_file);
+        else if (incremental_db->count > 0)
+        {
+            IncrementalDatabase database = incremental_database_open(*(incremental_db->filename), options_fingerprint(&options_hash));
+            compile_file_streamed(source_file, opti, output_file, runtime_file, &database);
+            incremental_database_free(&database);
+        }
+        else if (stream->count > 0)
+            compile_file_streamed(source_file, opti, output_file, runtime_file, NULL);
+        else if (cache_dir->count > 0)
+        {
+            // A hit neither parses the source nor analyses the runtime
+            SourceBuffer usercode_source = source_buffer_load(source_file);
+            CacheKey key = compile_cache_key(&options_hash, usercode_source.content, usercode_source.size);
+            if (compile_cache_fetch(&cache, &key, output_file))
+            {
+                source_buffer_free(&usercode_source);
+                if (runtime_file != NULL)
+                    fclose(runtime_file);
+            }
+            else
+            {
+                AnalysedRuntime runtime = analyse_runtime(runtime_file, opti);
+                compile_file_to_cache(&usercode_source, opti, output_file, &runtime, nb_jobs, &cache, &key);
+            }
+        }
+        else
+        {
+            SourceBuffer usercode_source = source_buffer_load(source_file);
+            AnalysedRuntime runtime = analyse_runtime(runtime_file, opti);
+            compile_file(&usercode_source, verb->count, opti, output_file, &runtime, nb_jobs);
+        }
     }
     else
     {
@@ -208,36 +539,106 @@ int main(int argc, char* argv[])
     return exitcode;
 }
 
-void compile_file(FILE* in_file, int verbose, unsigned char optimisations, FILE* out_file, FILE* runtime_file)
+FILE* open_source_file(const char* filename)
 {
-    SymbolTable table = symbol_table_create();
+    if (strcmp(filename, STDIN_FILENAME) == 0)
+        return stdin;
 
-    // ** Runtime ** //
-    SyntacticAnalyzer runtime_analyzer = {0};
+    if (ACCESS(filename, R_OK) == -1)
+    {
+        // TODO ACCESS() doesn't fail on windows when an asked permission is denied
+        if (errno == EACCES)
+        {
+            fprintf(stderr, "%s: error. %s : Permission denied\n", RCC_NAME, filename);
+            exit(EXIT_FAILURE);
+        }
+        else if (errno == ENOENT)
+        {
+            fprintf(stderr, "%s: error. %s : No such file or directory\n", RCC_NAME, filename);
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    if (runtime_file != NULL)
+    FILE* source_file = fopen(filename, "r");
+    if (source_file == NULL)
     {
-        char* runtime_content = load_file_content_and_close(runtime_file);
-        runtime_analyzer = syntactic_analyzer_create(runtime_content, optimisations);
-        syntactic_analyzer_build_tree(&runtime_analyzer);
-        assert(runtime_analyzer.syntactic_tree != NULL);
-        assert(runtime_analyzer.nb_errors == 0);
+        perror("failed to open the source file");
+        exit(EXIT_FAILURE);
+    }
+    return source_file;
+}
 
-        free(runtime_content);
+#ifdef DAEMON_ENABLED
+// Runtime analysed by the daemon, reused by the requests that compile the same runtime file with the same options
+typedef struct WarmRuntime_s WarmRuntime;
+struct WarmRuntime_s
+{
+    AnalysedRuntime runtime;
+    bool            is_set;
+    struct stat     file_status;      // Identifies the file and its version
+    optimization_t  optimizations;
+    int             is_bump_malloc;
+};
+static WarmRuntime warm_runtime = { .is_set = false };
+
+static bool is_warm_runtime(FILE* runtime_file, optimization_t optimisations)
+{
+    struct stat file_status;
+    return warm_runtime.is_set && fstat(fileno(runtime_file), &file_status) == 0
+        && file_status.st_dev   == warm_runtime.file_status.st_dev
+        && file_status.st_ino   == warm_runtime.file_status.st_ino
+        && file_status.st_size  == warm_runtime.file_status.st_size
+        && file_status.st_mtime == warm_runtime.file_status.st_mtime
+        && optimisations == warm_runtime.optimizations
+        && (bump_malloc->count > 0) == warm_runtime.is_bump_malloc;
+}
+#endif
 
-        semantic_analysis(runtime_analyzer.syntactic_tree, &table);
-        assert(table.nb_errors == 0);
+AnalysedRuntime analyse_runtime(FILE* runtime_file, optimization_t optimisations)
+{
+#ifdef DAEMON_ENABLED
+    if (runtime_file != NULL && is_warm_runtime(runtime_file, optimisations))
+    {
+        fclose(runtime_file);
+        return warm_runtime.runtime;
     }
-    // ************ //
+#endif
 
-    char* usercode_content = load_file_content_and_close(in_file);
+    AnalysedRuntime runtime;
+    runtime.analyzer = (SyntacticAnalyzer) {0};
+    runtime.table    = symbol_table_create();
+
+    if (runtime_file != NULL)
+    {
+        SourceBuffer runtime_source = source_buffer_load(runtime_file);
+        runtime.analyzer = syntactic_analyzer_create(runtime_source.content, optimisations);
+        syntactic_analyzer_build_tree(&(runtime.analyzer));
+        assert(runtime.analyzer.syntactic_tree != NULL);
+        assert(runtime.analyzer.nb_errors == 0);
+        if (bump_malloc->count > 0)
+            select_bump_allocator(runtime.analyzer.syntactic_tree);
+
+        source_buffer_free(&runtime_source);
+
+        semantic_analysis(runtime.analyzer.syntactic_tree, &(runtime.table));
+        assert(runtime.table.nb_errors == 0);
+    }
+
+    return runtime;
+}
+
+void compile_file(SourceBuffer* usercode_source, int verbose, optimization_t optimisations, FILE* out_file, AnalysedRuntime* runtime, int nb_jobs)
+{
+    // The analysis of the program continues the one of the runtime
+    SymbolTable table = runtime->table;
+    SyntacticAnalyzer runtime_analyzer = runtime->analyzer;
 
     if(verbose)
-        printf("File content :\n\n%s\n", usercode_content);
+        printf("File content :\n\n%s\n", usercode_source->content);
 
-    SyntacticAnalyzer usercode_analyzer = syntactic_analyzer_create(usercode_content, optimisations);
+    SyntacticAnalyzer usercode_analyzer = syntactic_analyzer_create(usercode_source->content, optimisations);
     syntactic_analyzer_build_tree(&usercode_analyzer);
-    free(usercode_content);
+    source_buffer_free(usercode_source);
 
     if (usercode_analyzer.syntactic_tree == NULL)
     {
@@ -263,6 +664,7 @@ void compile_file(FILE* in_file, int verbose, unsigned char optimisations, FILE*
             }
 
             semantic_analysis(usercode_analyzer.syntactic_tree, &table);
+            semantic_analysis_check_definitions(&table);
 
             if (verbose)
             {
@@ -280,79 +682,761 @@ void compile_file(FILE* in_file, int verbose, unsigned char optimisations, FILE*
             }
             else
             {
+                Optimizer optimizer = optimizer_create(optimisations, table.nb_glob_variables);
+                if (runtime_analyzer.syntactic_tree != NULL)
+                    optimize_tree(&optimizer, runtime_analyzer.syntactic_tree);
+                optimize_tree(&optimizer, usercode_analyzer.syntactic_tree);
+                optimizer_free(&optimizer);
+
                 if (verbose)
-                    printf("\nGenerated code :\n\n");
+                {
+                    printf("\nSyntactic tree after optimization : \n\n");
+                    syntactic_node_display_tree(usercode_analyzer.syntactic_tree, 0, out_file);
+                }
 
-                SyntacticNode** global_declarations = malloc(table.nb_glob_variables * sizeof(SyntacticNode*));
+                SyntacticNode** global_declarations = calloc(table.nb_glob_variables + (size_t) 1, sizeof(SyntacticNode*));
                 if (global_declarations == NULL)
                 {
                     perror("Failed to allocate memory for the global_declarations array");
                     exit(EXIT_FAILURE);
                 }
 
-                if(runtime_file != NULL)
-                    generate_code(runtime_analyzer.syntactic_tree, out_file, NO_LOOP, table.nb_glob_variables, global_declarations);
+                if (verbose)
+                    printf("\nGenerated code :\n\n");
+
+                // The instruction stream is optimized once the whole program is generated
+                FILE* code_file = out_file;
+                if (is_opti_enabled(optimisations, OPTI_JUMP_THREADING) || is_opti_enabled(optimisations, OPTI_STACK_SCHEDULING))
+                {
+                    code_file = tmpfile();
+                    if (code_file == NULL)
+                    {
+                        perror("Failed to create the temporary file of the generated code");
+                        exit(EXIT_FAILURE);
+                    }
+                }
+
+                if(runtime_analyzer.syntactic_tree != NULL)
+                    generate_code_parallel(runtime_analyzer.syntactic_tree, code_file, table.nb_glob_variables, global_declarations, optimisations, nb_jobs);
 
-                generate_program(usercode_analyzer.syntactic_tree, out_file, no_runtime->count == 0, table.nb_glob_variables, global_declarations);
+                generate_program(usercode_analyzer.syntactic_tree, code_file, no_runtime->count == 0, table.nb_glob_variables, global_declarations, optimisations, nb_jobs);
+
+                if (code_file != out_file)
+                {
+                    rewind(code_file);
+                    peephole_optimize(code_file, out_file, NULL, optimisations);
+                    fclose(code_file);
+                }
             }
         }
     }
 }
 
-void syntactic_analysis_on_file(FILE* in_file, int verbose, unsigned char optimisations, FILE* out_file)
+Sha256 hash_compilation_options(FILE* runtime_file, optimization_t optimisations)
 {
-    char* usercode_content = load_file_content_and_close(in_file);
+    // The build ID stands for the compiler, whose generated code changes with any of its sources without a new version
+    const char* compiler = RCC_VERSION " " RCC_BUILD_ID;
+    int options[] = { (int) optimisations, bump_malloc->count > 0, runtime_file != NULL };
+
+    Sha256 hash;
+    sha256_init(&hash);
+    sha256_update(&hash, compiler, strlen(compiler) + 1);
+    sha256_update(&hash, options, sizeof(options));
+    if (runtime_file != NULL)
+    {
+        // The runtime is hashed on its own, so that its bytes can't be mistaken for the ones of the source
+        Sha256 runtime_hash;
+        sha256_init(&runtime_hash);
+        sha256_update_file(&runtime_hash, runtime_file);
+        unsigned char runtime_digest[SHA256_DIGEST_SIZE];
+        sha256_final(&runtime_hash, runtime_digest);
+        sha256_update(&hash, runtime_digest, sizeof(runtime_digest));
+    }
+    return hash;
+}
 
-    if (verbose)
-        fprintf(out_file, "File content :\n\n%s\n\n", usercode_content);
+uint64_t options_fingerprint(const Sha256* options_hash)
+{
+    Sha256 hash = *options_hash;
+    unsigned char digest[SHA256_DIGEST_SIZE];
+    sha256_final(&hash, digest);
+
+    uint64_t fingerprint = 0;
+    for (int i = 0; i < 8; i++)
+        fingerprint = (fingerprint << 8) | digest[i];
+    return fingerprint;
+}
 
-    SyntacticAnalyzer usercode_analyzer = syntactic_analyzer_create(usercode_content, optimisations);
-    syntactic_analyzer_build_tree(&usercode_analyzer);
-    free(usercode_content);
+void compile_file_to_cache(SourceBuffer* usercode_source, optimization_t optimisations, FILE* out_file, AnalysedRuntime* runtime, int nb_jobs,
+                           const CompileCache* cache, const CacheKey* key)
+{
+    FILE* code_file = tmpfile();
+    if (code_file == NULL)
+    {
+        perror("Failed to create the temporary file of the generated code");
+        exit(EXIT_FAILURE);
+    }
 
-    if (usercode_analyzer.syntactic_tree == NULL)
+    // A compilation that fails exits before its code is stored
+    compile_file(usercode_source, 0, optimisations, code_file, runtime, nb_jobs);
+    if (ftell(code_file) > 0)
+        compile_cache_store(cache, key, code_file);
+
+    rewind(code_file);
+    char chunk[BUFSIZ];
+    size_t nb_read;
+    while ((nb_read = fread(chunk, sizeof(char), sizeof(chunk), code_file)) > 0)
+        fwrite(chunk, sizeof(char), nb_read, out_file);
+    fclose(code_file);
+}
+
+#ifdef BATCH_ENABLED
+typedef struct BatchFile_s BatchFile;
+struct BatchFile_s
+{
+    const char* filename;
+    char*       output_filename;
+    FILE*       diagnostics;      // Standard and error outputs of the compilation
+    pid_t       pid;
+    int         is_done;
+    int         status;           // Status returned by waitpid()
+};
+
+// <outdir>/<name>.msm where name is the file name of the source without its directory and its '.c' extension
+static char* batch_output_filename(const char* outdir_name, const char* filename)
+{
+    const char* name = strrchr(filename, '/');
+    name = (name == NULL) ? filename : name + 1;
+    size_t name_length = strlen(name);
+    if (name_length > 2 && strcmp(name + name_length - 2, ".c") == 0)
+        name_length -= 2;
+
+    size_t outdir_length = strlen(outdir_name);
+    char* output_filename = malloc(outdir_length + 1 + name_length + sizeof(MSM_EXTENSION));
+    if (output_filename == NULL)
     {
-        fprintf(stderr, "%s: error. The source file is empty\n", RCC_NAME);
+        perror("Failed to allocate memory for the output file name");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(output_filename, outdir_name, outdir_length);
+    output_filename[outdir_length] = '/';
+    memcpy(output_filename + outdir_length + 1, name, name_length);
+    strcpy(output_filename + outdir_length + 1 + name_length, MSM_EXTENSION);
+    return output_filename;
+}
+
+static int compare_output_filenames(const void* a, const void* b)
+{
+    return strcmp((*(const BatchFile* const*) a)->output_filename, (*(const BatchFile* const*) b)->output_filename);
+}
+
+// Compiles the file in a child process, whose outputs are written in the diagnostics of the file
+static void batch_start(BatchFile* file, int verbose, optimization_t optimisations, AnalysedRuntime* runtime, const CompileCache* cache, const Sha256* options_hash)
+{
+    file->diagnostics = tmpfile();
+    if (file->diagnostics == NULL)
+    {
+        perror("Failed to create the temporary file of the diagnostics");
+        exit(EXIT_FAILURE);
+    }
+
+    // Nothing buffered before the fork must be written twice
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == -1)
+    {
+        perror("Failed to start a compilation");
+        exit(EXIT_FAILURE);
+    }
+    if (pid == 0)
+    {
+        dup2(fileno(file->diagnostics), STDOUT_FILENO);
+        dup2(fileno(file->diagnostics), STDERR_FILENO);
+
+        SourceBuffer usercode_source = source_buffer_load(open_source_file(file->filename));
+        FILE* output_file = fopen(file->output_filename, "w");
+        if (output_file == NULL)
+        {
+            fprintf(stderr, "%s: error. Failed to open the output file \"%s\"\n", RCC_NAME, file->output_filename);
+            exit(EXIT_FAILURE);
+        }
+        if (cache == NULL)
+            compile_file(&usercode_source, verbose, optimisations, output_file, runtime, 1);
+        else
+        {
+            CacheKey key = compile_cache_key(options_hash, usercode_source.content, usercode_source.size);
+            if (compile_cache_fetch(cache, &key, output_file))
+                source_buffer_free(&usercode_source);
+            else
+                compile_file_to_cache(&usercode_source, optimisations, output_file, runtime, 1, cache, &key);
+        }
+        fclose(output_file);
+        exit(EXIT_SUCCESS);
+    }
+
+    file->pid     = pid;
+    file->is_done = 0;
+}
+
+// Writes the diagnostics of the compilation, returns true if it failed
+static bool batch_report(BatchFile* file)
+{
+    rewind(file->diagnostics);
+    int c = fgetc(file->diagnostics);
+    if (c != EOF)
+    {
+        fprintf(stderr, "%s: %s :\n", RCC_NAME, file->filename);
+        for (; c != EOF; c = fgetc(file->diagnostics))
+            fputc(c, stderr);
     }
+    fclose(file->diagnostics);
+    file->diagnostics = NULL;
+
+    if (WIFEXITED(file->status) && WEXITSTATUS(file->status) == EXIT_SUCCESS)
+        return false;
+
+    if (WIFEXITED(file->status))
+        printf("%s: %s : compilation failed (exit status %d)\n", RCC_NAME, file->filename, WEXITSTATUS(file->status));
     else
+        printf("%s: %s : compilation failed (signal %d)\n", RCC_NAME, file->filename, WTERMSIG(file->status));
+    return true;
+}
+
+int compile_batch(const char** filenames, int nb_files, const char* outdir_name, int verbose, optimization_t optimisations, FILE* runtime_file, int nb_jobs,
+                  const CompileCache* cache, const Sha256* options_hash)
+{
+    struct STAT_S outdir_status;
+    if (STAT(outdir_name, &outdir_status) == -1)
     {
-        if (verbose)
-            fprintf(out_file, "\n\nSyntactic tree : \n\n");
+        if (mkdir(outdir_name, 0777) == -1)
+        {
+            fprintf(stderr, "%s: error. Failed to create the output directory \"%s\"\n", RCC_NAME, outdir_name);
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if ( ! S_ISDIR(outdir_status.st_mode))
+    {
+        fprintf(stderr, "%s: error. %s : Not a directory\n", RCC_NAME, outdir_name);
+        exit(EXIT_FAILURE);
+    }
 
-        syntactic_node_display_tree(usercode_analyzer.syntactic_tree, 0, out_file);
+    BatchFile* files = malloc(sizeof(BatchFile) * nb_files);
+    BatchFile** sorted_files = malloc(sizeof(BatchFile*) * nb_files);
+    if (files == NULL || sorted_files == NULL)
+    {
+        perror("Failed to allocate memory for the batch compilation");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < nb_files; i++)
+    {
+        if (strcmp(filenames[i], STDIN_FILENAME) == 0)
+        {
+            fprintf(stderr, "%s: invalid option. The standard input can't be compiled with the \"--%s\" option.\n", RCC_NAME, outdir->hdr.longopts);
+            exit(EXIT_FAILURE);
+        }
+        files[i].filename        = filenames[i];
+        files[i].output_filename = batch_output_filename(outdir_name, filenames[i]);
+        files[i].diagnostics     = NULL;
+        files[i].is_done         = 0;
+        sorted_files[i]          = files + i;
+    }
+
+    // Two sources with the same name would overwrite the code of each other
+    qsort(sorted_files, nb_files, sizeof(BatchFile*), compare_output_filenames);
+    for (int i = 1; i < nb_files; i++)
+    {
+        if (strcmp(sorted_files[i - 1]->output_filename, sorted_files[i]->output_filename) == 0)
+        {
+            fprintf(stderr, "%s: error. %s and %s are both compiled in %s\n",
+                    RCC_NAME, sorted_files[i - 1]->filename, sorted_files[i]->filename, sorted_files[i]->output_filename);
+            exit(EXIT_FAILURE);
+        }
+    }
+    free(sorted_files);
+
+    AnalysedRuntime runtime = analyse_runtime(runtime_file, optimisations);
+
+    // Each compilation that ends is replaced by the next one, the files are reported in their order
+    int nb_started  = 0;
+    int nb_running  = 0;
+    int nb_reported = 0;
+    int nb_failed   = 0;
+    while (nb_reported < nb_files)
+    {
+        while (nb_running < nb_jobs && nb_started < nb_files)
+        {
+            batch_start(files + nb_started, verbose, optimisations, &runtime, cache, options_hash);
+            nb_started++;
+            nb_running++;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Failed to wait for a compilation");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = nb_reported; i < nb_started; i++)
+        {
+            if ( ! files[i].is_done && files[i].pid == pid)
+            {
+                files[i].is_done = 1;
+                files[i].status  = status;
+                nb_running--;
+                break;
+            }
+        }
+
+        while (nb_reported < nb_started && files[nb_reported].is_done)
+        {
+            if (batch_report(files + nb_reported))
+                nb_failed++;
+            nb_reported++;
+        }
+    }
+
+    printf("%s: %d of %d files compiled, %d failed\n", RCC_NAME, nb_files - nb_failed, nb_files, nb_failed);
+
+    for (int i = 0; i < nb_files; i++)
+        free(files[i].output_filename);
+    free(files);
+
+    return (nb_failed > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+#else
+int compile_batch(const char** filenames, int nb_files, const char* outdir_name, int verbose, optimization_t optimisations, FILE* runtime_file, int nb_jobs,
+                  const CompileCache* cache, const Sha256* options_hash)
+{
+    (void) filenames; (void) nb_files; (void) outdir_name; (void) verbose; (void) optimisations; (void) runtime_file; (void) nb_jobs;
+    (void) cache; (void) options_hash;
+
+    fprintf(stderr, "%s: invalid option. \"--%s\" option isn't supported on this platform.\n", RCC_NAME, outdir->hdr.longopts);
+    return EXIT_FAILURE;
+}
+#endif
+
+int serve_compilations(const char* socket_path, const char* runtime_path, FILE* runtime_file, optimization_t optimisations)
+{
+#ifdef DAEMON_ENABLED
+    if (runtime_file != NULL)
+    {
+        // The requests that don't give a runtime use the one of the daemon, whatever their working directory
+        char* absolute_path = realpath(runtime_path, NULL);
+        if (absolute_path != NULL)
+        {
+            setenv(RCC_RUNTIME_ENV_VAR, absolute_path, 1);
+            free(absolute_path);
+        }
+
+        struct stat file_status;
+        bool has_file_status = fstat(fileno(runtime_file), &file_status) == 0;
+        warm_runtime.runtime        = analyse_runtime(runtime_file, optimisations);
+        warm_runtime.file_status    = file_status;
+        warm_runtime.optimizations  = optimisations;
+        warm_runtime.is_bump_malloc = (bump_malloc->count > 0);
+        warm_runtime.is_set         = has_file_status;
+    }
+#else
+    (void) runtime_path; (void) runtime_file; (void) optimisations;
+#endif
+
+    return daemon_serve(socket_path, RCC_RUNTIME_ENV_VAR, rcc_main);
+}
+
+typedef struct StreamedCompilation_s StreamedCompilation;
+struct StreamedCompilation_s
+{
+    optimization_t  optimizations;
+    SymbolTable     table;
+    Optimizer       optimizer;
+    SyntacticNode*  globals;                      // Global variables and emptied functions, referenced by the symbol table
+    SyntacticNode** global_declarations;          // Deferred initializations of the global variables, indexed by their offset
+    int             global_declarations_capacity;
+    FILE*           code_file;                    // Generated functions, the globals are addressed by relocations
+    FILE*           function_file;                // Reused for the code of each function before its peephole optimization
+    FILE*           relocatable_file;             // Reused for the code of each function kept by an incremental compilation
+    IncrementalDatabase* database;                // NULL unless the compilation is incremental
+};
+
+// Empties a temporary file reused by the declarations
+static void empty_file(FILE* file)
+{
+    rewind(file);
+    if (TRUNCATE(file) != 0)
+    {
+        perror("Failed to empty the temporary file of the generated code");
+        exit(EXIT_FAILURE);
     }
 }
 
-void semantic_analysis_on_file(FILE* in_file, int verbose, unsigned char optimisations, FILE* out_file, FILE * runtime_file)
+// Generates the function with relative labels, then keeps its code in the database of the incremental compilation
+static void generate_relocatable_function_code(StreamedCompilation* compilation, SyntacticNode* function, uint64_t fingerprint, bool is_inlinable)
 {
-    SymbolTable table = symbol_table_create();
+    FILE* function_file = compilation->function_file;
+    FILE* relocatable_file = compilation->relocatable_file;
+    empty_file(function_file);
+    int nb_labels = generate_relocatable_function(function, function_file, compilation->optimizations);
+    fflush(function_file);
+    rewind(function_file);
+    if (is_opti_enabled(compilation->optimizations, OPTI_JUMP_THREADING) || is_opti_enabled(compilation->optimizations, OPTI_STACK_SCHEDULING))
+    {
+        empty_file(relocatable_file);
+        peephole_optimize(function_file, relocatable_file, function->value.str_val, compilation->optimizations);
+        fflush(relocatable_file);
+        rewind(relocatable_file);
+    }
+    else
+        relocatable_file = function_file;
 
-    // ** Runtime ** //
-    SyntacticAnalyzer runtime_analyzer = { 0 };
+    fseek(relocatable_file, 0, SEEK_END);
+    size_t code_size = (size_t) ftell(relocatable_file);
+    rewind(relocatable_file);
+    char* code = malloc(code_size + 1);
+    if (code == NULL || fread(code, sizeof(char), code_size, relocatable_file) != code_size)
+    {
+        perror("Failed to read the code of the function");
+        exit(EXIT_FAILURE);
+    }
+
+    write_relocatable_function(code, code_size, nb_labels, compilation->code_file);
+    incremental_database_add(compilation->database, function->value.str_val, fingerprint, nb_labels, is_inlinable, code, code_size, true);
+}
+
+// Analyses, optimizes and generates a global declaration, then frees what isn't needed by the following declarations
+// An incremental compilation gives the hash of the source of the declaration, the code of an unchanged function is reused
+void compile_declaration(StreamedCompilation* compilation, SyntacticNode* declaration, uint64_t source_hash)
+{
+    SymbolTable* table = &(compilation->table);
+    IncrementalDatabase* database = compilation->database;
+
+    // The declarations are kept in a program, as when the whole tree is analysed
+    syntactic_node_add_child(compilation->globals, declaration);
+
+    bool is_function_definition = declaration->type == NODE_FUNCTION && ! syntactic_node_is_flag_set(declaration, EXTERN_FLAG);
+    uint64_t fingerprint = source_hash;
+    if (database != NULL && is_function_definition)
+    {
+        fingerprint = incremental_database_fingerprint(database, declaration, source_hash);
+        const IncrementalFunction* reused = incremental_database_find(database, declaration->value.str_val, fingerprint);
+        // An inlinable function is optimized again, so that its body can be inlined in the following functions
+        if (reused != NULL && ! reused->is_inlinable)
+        {
+            semantic_analysis_declare_function(declaration, table);
+            if (table->nb_errors == 0)
+            {
+                write_relocatable_function(reused->code, reused->code_size, reused->nb_labels, compilation->code_file);
+                incremental_database_add(database, declaration->value.str_val, fingerprint, reused->nb_labels, false, reused->code, reused->code_size, false);
+                incremental_database_sign(database, declaration, fingerprint, false);
+            }
+            syntactic_node_free_children(declaration);
+            return;
+        }
+    }
+
+    semantic_analysis(declaration, table);
+
+    // After an error, the following declarations are only analysed
+    if (table->nb_errors > 0)
+    {
+        if (declaration->type == NODE_FUNCTION)
+            syntactic_node_free_children(declaration);
+        return;
+    }
+
+    optimizer_reserve_globals(&(compilation->optimizer), table->nb_glob_variables);
+    int nb_inlinable_functions = compilation->optimizer.nb_functions;
+    optimize_declaration(&(compilation->optimizer), declaration);
+    bool is_inlinable = compilation->optimizer.nb_functions > nb_inlinable_functions;
+    if (database != NULL)
+        incremental_database_sign(database, declaration, fingerprint, is_inlinable);
+
+    if (declaration->type == NODE_FUNCTION)
+    {
+        if (database != NULL && is_function_definition)
+            generate_relocatable_function_code(compilation, declaration, fingerprint, is_inlinable);
+        else if (is_opti_enabled(compilation->optimizations, OPTI_JUMP_THREADING) || is_opti_enabled(compilation->optimizations, OPTI_STACK_SCHEDULING))
+        {
+            FILE* function_file = compilation->function_file;
+            empty_file(function_file);
+            generate_code(declaration, function_file, NO_LOOP, UNKNOWN_NB_GLOBALS, NULL, compilation->optimizations);
+            fflush(function_file);
+            rewind(function_file);
+            peephole_optimize(function_file, compilation->code_file, declaration->value.str_val, compilation->optimizations);
+        }
+        else
+            generate_code(declaration, compilation->code_file, NO_LOOP, UNKNOWN_NB_GLOBALS, NULL, compilation->optimizations);
+
+        // The symbol table only needs the name of the function
+        syntactic_node_free_children(declaration);
+    }
+    else
+    {
+        if (table->nb_glob_variables >= compilation->global_declarations_capacity)
+        {
+            int capacity = compilation->global_declarations_capacity;
+            while (table->nb_glob_variables >= capacity)
+                capacity = (capacity == 0) ? 64 : 2 * capacity;
+            SyntacticNode** reallocated_declarations = realloc(compilation->global_declarations, sizeof(SyntacticNode*) * capacity);
+            if (reallocated_declarations == NULL)
+            {
+                perror("Failed to allocate memory for the global_declarations array");
+                exit(EXIT_FAILURE);
+            }
+            for (int i = compilation->global_declarations_capacity; i < capacity; i++)
+                reallocated_declarations[i] = NULL;
+            compilation->global_declarations          = reallocated_declarations;
+            compilation->global_declarations_capacity = capacity;
+        }
+        // Only records the declarations, their initializations are generated at start
+        generate_code(declaration, compilation->code_file, NO_LOOP, UNKNOWN_NB_GLOBALS, compilation->global_declarations, compilation->optimizations);
+    }
+}
+
+static StreamedCompilation streamed_compilation_create(optimization_t optimisations, IncrementalDatabase* database)
+{
+    StreamedCompilation compilation;
+    compilation.optimizations                = optimisations;
+    compilation.table                        = symbol_table_create();
+    compilation.optimizer                    = optimizer_create(optimisations, 0);
+    compilation.globals                      = syntactic_node_create(NODE_PROGRAM, 0, 0);
+    compilation.global_declarations          = NULL;
+    compilation.global_declarations_capacity = 0;
+    compilation.code_file                    = tmpfile();
+    compilation.function_file                = tmpfile();
+    compilation.relocatable_file             = (database != NULL) ? tmpfile() : NULL;
+    compilation.database                     = database;
+    if (compilation.code_file == NULL || compilation.function_file == NULL || (database != NULL && compilation.relocatable_file == NULL))
+    {
+        perror("Failed to create the temporary file of the generated code");
+        exit(EXIT_FAILURE);
+    }
+    return compilation;
+}
+
+static void streamed_compilation_free(StreamedCompilation* compilation)
+{
+    fclose(compilation->code_file);
+    fclose(compilation->function_file);
+    if (compilation->relocatable_file != NULL)
+        fclose(compilation->relocatable_file);
+    free(compilation->global_declarations);
+    syntactic_node_free_tree(compilation->globals);
+    optimizer_free(&(compilation->optimizer));
+    symbol_table_free(&(compilation->table));
+}
+
+// Compiles the declarations of the source then reports the errors, the process exits after an error
+// Returns false if the source is empty. The symbols left undefined are errors unless they are imported by an object file
+static bool compile_source_declarations(StreamedCompilation* compilation, FILE* in_file, bool is_object)
+{
+    SourceBuffer usercode_source = source_buffer_load(in_file);
+    SyntacticAnalyzer usercode_analyzer = syntactic_analyzer_create(usercode_source.content, compilation->optimizations);
+
+    int nb_declarations = 0;
+    SyntacticNode* declaration = NULL;
+    while ((declaration = syntactic_analyzer_next_declaration(&usercode_analyzer)) != NULL)
+    {
+        nb_declarations++;
+        // After a syntax error, the rest of the source is only parsed
+        if (usercode_analyzer.nb_errors > 0)
+            syntactic_node_free_tree(declaration);
+        else
+        {
+            uint64_t source_hash = 0;
+            if (compilation->database != NULL)
+                source_hash = cache_hash_bytes(CACHE_HASH_INIT, usercode_source.content + usercode_analyzer.declaration_start,
+                                               (size_t) (usercode_analyzer.declaration_end - usercode_analyzer.declaration_start));
+            compile_declaration(compilation, declaration, source_hash);
+        }
+    }
+    source_buffer_free(&usercode_source);
+
+    if (nb_declarations > 0 && usercode_analyzer.nb_errors == 0 && ! is_object)
+        semantic_analysis_check_definitions(&(compilation->table));
 
+    if (nb_declarations == 0)
+    {
+        fprintf(stderr, "%s: error. The source file is empty\n", RCC_NAME);
+        return false;
+    }
+    else if (usercode_analyzer.nb_errors > 0)
+    {
+        if(usercode_analyzer.nb_errors == 1)
+            fprintf(stderr, "%s: error. 1 error found during syntactical analysis : compilation aborted\n", RCC_NAME);
+        else
+            fprintf(stderr, "%s: error. %d errors found during syntactical analysis : compilation aborted\n", RCC_NAME, usercode_analyzer.nb_errors);
+
+        exit(EXIT_FAILURE);
+    }
+    else if (compilation->table.nb_errors > 0)
+    {
+        if(compilation->table.nb_errors == 1)
+            fprintf(stderr, "%s: error. 1 error found during semantic analysis : compilation aborted\n", RCC_NAME);
+        else
+            fprintf(stderr, "%s: error. %d errors found during semantic analysis : compilation aborted\n", RCC_NAME, compilation->table.nb_errors);
+
+        exit(EXIT_FAILURE);
+    }
+    return true;
+}
+
+void compile_file_streamed(FILE* in_file, optimization_t optimisations, FILE* out_file, FILE* runtime_file, IncrementalDatabase* database)
+{
+    StreamedCompilation compilation = streamed_compilation_create(optimisations, database);
+
+    // ** Runtime ** //
     if (runtime_file != NULL)
     {
-        char* runtime_content = load_file_content_and_close(runtime_file);
-        runtime_analyzer = syntactic_analyzer_create(runtime_content, optimisations);
+        SourceBuffer runtime_source = source_buffer_load(runtime_file);
+        SyntacticAnalyzer runtime_analyzer = syntactic_analyzer_create(runtime_source.content, optimisations);
         syntactic_analyzer_build_tree(&runtime_analyzer);
         assert(runtime_analyzer.syntactic_tree != NULL);
         assert(runtime_analyzer.nb_errors == 0);
+        if (bump_malloc->count > 0)
+            select_bump_allocator(runtime_analyzer.syntactic_tree);
 
-        free(runtime_content);
+        source_buffer_free(&runtime_source);
 
-        semantic_analysis(runtime_analyzer.syntactic_tree, &table);
-        assert(table.nb_errors == 0);
+        SyntacticNode* runtime_tree = runtime_analyzer.syntactic_tree;
+        // The declarations are moved to the compilation
+        for (int i = 0; i < runtime_tree->nb_children; i++)
+        {
+            runtime_tree->children[i]->parent = NULL;
+            // The database is only reused with the same runtime, its declarations are told apart by their index
+            compile_declaration(&compilation, runtime_tree->children[i], cache_hash_bytes(CACHE_HASH_INIT, &i, sizeof(i)));
+        }
+        assert(compilation.table.nb_errors == 0);
+        runtime_tree->nb_children = 0;
+        syntactic_node_free(runtime_tree);
     }
     // ************ //
 
-    char* usercode_content = load_file_content_and_close(in_file);
+    if (compile_source_declarations(&compilation, in_file, false))
+    {
+        // The number of global variables is finally known
+        rewind(compilation.code_file);
+        resolve_global_relocations(compilation.code_file, out_file, compilation.table.nb_glob_variables);
+        generate_entry_point(out_file, no_runtime->count == 0, compilation.table.nb_glob_variables, compilation.global_declarations, optimisations);
+
+        if (database != NULL)
+        {
+            incremental_database_save(database);
+            if (verb->count > 0)
+                printf("Incremental compilation : %d functions reused, %d compiled\n", database->nb_reused, database->nb_functions - database->nb_reused);
+        }
+    }
+
+    streamed_compilation_free(&compilation);
+}
+
+void compile_object(FILE* in_file, optimization_t optimisations, FILE* out_file)
+{
+    StreamedCompilation compilation = streamed_compilation_create(optimisations, NULL);
+    if (compile_source_declarations(&compilation, in_file, true))
+    {
+        const SymbolTable* table = &(compilation.table);
+        fprintf(out_file, OBJECT_FILE_MAGIC "\n");
+        fprintf(out_file, OBJECT_FILE_GLOBALS " %d\n", table->nb_glob_variables);
+        // The global symbols follow the primitive functions, a function defined after its prototype has the definition
+        for (int i = NB_PRIMITIVE_FUNCTIONS; i < table->nb_symbols; i++)
+        {
+            const Symbol* symbol = table->symbols + i;
+            bool is_extern = syntactic_node_is_flag_set(symbol->declaration, EXTERN_FLAG);
+            if (symbol->declaration->type == NODE_DECL)
+                fprintf(out_file, "%s %s %d\n", is_extern ? OBJECT_FILE_EXTERN : OBJECT_FILE_GLOBAL, symbol->declaration->value.str_val, symbol->stack_offset);
+            else
+                fprintf(out_file, "%s %s %d\n", is_extern ? OBJECT_FILE_IMPORT : OBJECT_FILE_EXPORT, symbol->declaration->value.str_val, symbol->nb_params);
+        }
+
+        fprintf(out_file, OBJECT_FILE_INIT "\n");
+        generate_global_initializations(out_file, table->nb_glob_variables, UNKNOWN_NB_GLOBALS, compilation.global_declarations, optimisations);
+
+        fprintf(out_file, OBJECT_FILE_CODE "\n");
+        rewind(compilation.code_file);
+        char chunk[BUFSIZ];
+        size_t nb_read;
+        while ((nb_read = fread(chunk, sizeof(char), sizeof(chunk), compilation.code_file)) > 0)
+            fwrite(chunk, sizeof(char), nb_read, out_file);
+    }
+    streamed_compilation_free(&compilation);
+}
+
+void select_bump_allocator(SyntacticNode* runtime_tree)
+{
+    const char* replaced_names[] = { "malloc", "free", "realloc" };
+    const char* bump_names[]     = { "_bump_malloc", "_bump_free", "_bump_realloc" };
+
+    for (int i = 0; i < 3; i++)
+    {
+        int replaced = -1;
+        int bump = -1;
+        for (int j = 0; j < runtime_tree->nb_children; j++)
+        {
+            SyntacticNode* declaration = runtime_tree->children[j];
+            if (declaration->type != NODE_FUNCTION)
+                continue;
+            if (strcmp(declaration->value.str_val, replaced_names[i]) == 0)
+                replaced = j;
+            else if (strcmp(declaration->value.str_val, bump_names[i]) == 0)
+                bump = j;
+        }
+        if (replaced == -1 || bump == -1)
+        {
+            fprintf(stderr, "%s: the runtime doesn't define both '%s' and '%s'\n", RCC_NAME, replaced_names[i], bump_names[i]);
+            exit(EXIT_FAILURE);
+        }
+
+        // The bump allocator takes the name of the removed function
+        char* name = runtime_tree->children[replaced]->value.str_val;
+        runtime_tree->children[replaced]->value.str_val = runtime_tree->children[bump]->value.str_val;
+        runtime_tree->children[bump]->value.str_val = name;
+
+        syntactic_node_free_tree(runtime_tree->children[replaced]);
+        for (int j = replaced; j < runtime_tree->nb_children - 1; j++)
+            runtime_tree->children[j] = runtime_tree->children[j + 1];
+        runtime_tree->nb_children--;
+    }
+}
+
+void syntactic_analysis_on_file(FILE* in_file, int verbose, optimization_t optimisations, FILE* out_file)
+{
+    SourceBuffer usercode_source = source_buffer_load(in_file);
 
     if (verbose)
-        printf("File content :\n\n%s\n", usercode_content);
+        fprintf(out_file, "File content :\n\n%s\n\n", usercode_source.content);
 
-    SyntacticAnalyzer usercode_analyzer = syntactic_analyzer_create(usercode_content, optimisations);
+    SyntacticAnalyzer usercode_analyzer = syntactic_analyzer_create(usercode_source.content, optimisations);
     syntactic_analyzer_build_tree(&usercode_analyzer);
-    free(usercode_content);
+    source_buffer_free(&usercode_source);
+
+    if (usercode_analyzer.syntactic_tree == NULL)
+    {
+        fprintf(stderr, "%s: error. The source file is empty\n", RCC_NAME);
+    }
+    else
+    {
+        if (verbose)
+            fprintf(out_file, "\n\nSyntactic tree : \n\n");
+
+        syntactic_node_display_tree(usercode_analyzer.syntactic_tree, 0, out_file);
+    }
+}
+
+void semantic_analysis_on_file(FILE* in_file, int verbose, optimization_t optimisations, FILE* out_file, FILE * runtime_file)
+{
+    SymbolTable table = analyse_runtime(runtime_file, optimisations).table;
+
+    SourceBuffer usercode_source = source_buffer_load(in_file);
+
+    if (verbose)
+        printf("File content :\n\n%s\n", usercode_source.content);
+
+    SyntacticAnalyzer usercode_analyzer = syntactic_analyzer_create(usercode_source.content, optimisations);
+    syntactic_analyzer_build_tree(&usercode_analyzer);
+    source_buffer_free(&usercode_source);
 
     if (usercode_analyzer.syntactic_tree == NULL)
     {
@@ -377,50 +1461,19 @@ void semantic_analysis_on_file(FILE* in_file, int verbose, unsigned char optimis
 
 void lexical_analysis_on_file(FILE* in_file, int verbose, FILE* out_file)
 {
-    char* usercode_content = load_file_content_and_close(in_file);
+    SourceBuffer usercode_source = source_buffer_load(in_file);
 
     if (verbose)
     {
-        printf("File content :\n\n%s\n", usercode_content);
+        printf("File content :\n\n%s\n", usercode_source.content);
         printf("\nToken list : \n");
     }
-    Tokenizer tokenizer = tokenizer_create(usercode_content);
+    Tokenizer tokenizer = tokenizer_create(usercode_source.content);
     while (tokenizer.next.type != TOK_EOF)
     {
         tokenizer_step(&tokenizer);
         token_display(tokenizer.current, out_file);
     }
 
-    free(usercode_content);
+    source_buffer_free(&usercode_source);
 }
-
-char* load_file_content_and_close(FILE* file)
-{
-    size_t file_size;
-    fseek(file, 0, SEEK_END);
-    file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    char* file_content = malloc(sizeof(char) * file_size + 1);
-    if (file_content == NULL)
-    {
-        perror("Failed to allocate the buffer for the file content");
-        exit(EXIT_FAILURE);
-    }
-    else
-    {
-        size_t nb_char_loaded = fread(file_content, sizeof(char), file_size, file);
-        // May be different from file_size, e.g. if line breaks are CRLF instead of LF
-
-        if (ferror(file))
-        {
-            fprintf(stderr, "%s: error. Failed to read content from the file\n", RCC_NAME);
-            exit(EXIT_FAILURE);
-        }
-        fclose(file);
-
-        file_content[nb_char_loaded] = '\0';
-    }
-
-    return file_content;
-}
\ No newline at end of file
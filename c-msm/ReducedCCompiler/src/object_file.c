@@ -0,0 +1,95 @@
+#include "object_file.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define CALL_INIT \
+    "        prep _Init"  "\n" \
+    "        call 0"
+
+#define CALL_MAIN \
+    "        prep main"   "\n" \
+    "        call 0"
+
+#define PUTCHAR_PRIMITIVE \
+    ".putchar"            "\n" \
+    "        send"        "\n" \
+    "        push 0"      "\n" \
+    "        ret"
+
+#define GETCHAR_PRIMITIVE \
+    ".getchar"            "\n" \
+    "        recv"        "\n" \
+    "        ret"
+
+// memset(ptr, value, n) and memcpy(destination, source, n) return their first argument,
+// the copy is done as if through a temporary buffer so the blocks may overlap
+#define MEMSET_PRIMITIVE \
+    ".memset"             "\n" \
+    "        get 0"       "\n" \
+    "        get 2"       "\n" \
+    "        get 1"       "\n" \
+    "        fill"        "\n" \
+    "        get 0"       "\n" \
+    "        ret"
+
+#define MEMCPY_PRIMITIVE \
+    ".memcpy"             "\n" \
+    "        get 0"       "\n" \
+    "        get 1"       "\n" \
+    "        get 2"       "\n" \
+    "        copy"        "\n" \
+    "        get 0"       "\n" \
+    "        ret"
+
+#define INIT_DATA_SEGMENT \
+    "        push 0"      "\n" \
+    "        read"        "\n" \
+    "        push %d"     "\n" \
+    "        add"         "\n" \
+    "        push 0"      "\n" \
+    "        write"
+
+void object_file_write_entry_start(FILE* stream, int nb_global_variables)
+{
+    assert(stream != NULL && nb_global_variables >= 0);
+
+    fprintf(stream, "." ENTRY_POINT_LABEL "\n");
+    fprintf(stream, INIT_DATA_SEGMENT    "\n", nb_global_variables);
+}
+
+void object_file_write_entry_end(FILE* stream, bool is_init_called)
+{
+    assert(stream != NULL);
+
+    if (is_init_called)
+        fprintf(stream, CALL_INIT            "\n");
+    fprintf(stream, CALL_MAIN            "\n");
+    fprintf(stream, "        halt"       "\n");
+    fprintf(stream, PUTCHAR_PRIMITIVE    "\n" "\n");
+    fprintf(stream, GETCHAR_PRIMITIVE    "\n" "\n");
+    fprintf(stream, MEMSET_PRIMITIVE     "\n" "\n");
+    fprintf(stream, MEMCPY_PRIMITIVE     "\n");
+}
+
+bool object_file_is_entry_label(const char* label)
+{
+    static const char* entry_labels[] = { ENTRY_POINT_LABEL, "putchar", "getchar", "memset", "memcpy" };
+    for (size_t i = 0; i < sizeof(entry_labels) / sizeof(entry_labels[0]); i++)
+    {
+        if (strcmp(label, entry_labels[i]) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool object_file_has_label_operand(const char* opcode)
+{
+    static const char* opcodes[] = { "jump", "jumpt", "jumpf", "jeq", "jne", "jlt", "jle", "jgt", "jge", "prep" };
+    for (size_t i = 0; i < sizeof(opcodes) / sizeof(opcodes[0]); i++)
+    {
+        if (strcmp(opcode, opcodes[i]) == 0)
+            return true;
+    }
+    return false;
+}
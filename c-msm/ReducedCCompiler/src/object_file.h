@@ -0,0 +1,53 @@
+#ifndef OBJECT_FILE_H
+#define OBJECT_FILE_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/*
+* An object file is a module compiled by 'rcc --object', the linker msmld links the object files into a program.
+* It is a text file : the directives describing the symbols of the module, then the code initializing its global
+* variables and the code of its functions.
+*
+*   #rcc-object 1
+*   #globals <number of global variables>
+*   #global <name> <offset>       Global variable defined by the module
+*   #extern <name> <offset>       Global variable defined by another module, the offset only stands for it
+*   #export <name> <nb params>    Function defined by the module
+*   #import <name> <nb params>    Function defined by another module
+*   #init
+*   <code initializing the global variables>
+*   #code
+*   <code of the functions>
+*
+* The global variables are addressed by relocations 'push @globals-<offset>' whose offsets are the ones of the module.
+* The linker lays out the global variables of all the modules in the data segment and renames the labels
+* that aren't functions, so that the labels of two modules can't clash.
+*/
+
+#define GLOBAL_RELOCATION      "@globals-"
+
+#define OBJECT_FILE_MAGIC      "#rcc-object 1"
+#define OBJECT_FILE_GLOBALS    "#globals"
+#define OBJECT_FILE_GLOBAL     "#global"
+#define OBJECT_FILE_EXTERN     "#extern"
+#define OBJECT_FILE_EXPORT     "#export"
+#define OBJECT_FILE_IMPORT     "#import"
+#define OBJECT_FILE_INIT       "#init"
+#define OBJECT_FILE_CODE       "#code"
+
+#define ENTRY_POINT_LABEL      "start"
+
+/*
+* The code run at start is written by the compiler for a whole program, and by the linker for the object files :
+* the start extends the data segment by the global variables, which are then initialized,
+* the end calls _Init() and main() then stops the machine, it is followed by the primitive functions.
+*/
+void object_file_write_entry_start(FILE* stream, int nb_global_variables);
+void object_file_write_entry_end(FILE* stream, bool is_init_called);
+// True for the labels of the primitive functions and of the entry point, which every module can reference
+bool object_file_is_entry_label(const char* label);
+// True for the instructions whose operand is a label
+bool object_file_has_label_operand(const char* opcode);
+
+#endif // OBJECT_FILE_H
@@ -0,0 +1,1127 @@
+#include "optimization.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INLINE_MAX_SIZE 16 // Maximum number of nodes of an inlined expression
+
+SyntacticNode* opti_fold_node(Optimizer* optimizer, SyntacticNode* node);
+SyntacticNode* opti_inline_calls(Optimizer* optimizer, SyntacticNode* function, SyntacticNode* node);
+void opti_eliminate_tail_calls(SyntacticNode* function);
+void opti_move_loop_invariants(Optimizer* optimizer, SyntacticNode* function);
+SyntacticNode* opti_inlinable_expression(const SyntacticNode* function);
+
+
+Optimizer optimizer_create(optimization_t optimizations, int nb_glob_variables)
+{
+    Optimizer optimizer;
+    optimizer.optimizations      = optimizations;
+    optimizer.nb_glob_variables  = nb_glob_variables;
+    // One more element to never request a zero-sized block
+    optimizer.is_const_global    = calloc(nb_glob_variables + (size_t) 1, sizeof(bool));
+    optimizer.const_global_value = calloc(nb_glob_variables + (size_t) 1, sizeof(int));
+    if (optimizer.is_const_global == NULL || optimizer.const_global_value == NULL)
+    {
+        perror("Failed to allocate memory for the optimizer's global variables");
+        exit(EXIT_FAILURE);
+    }
+    optimizer.functions          = NULL;
+    optimizer.nb_functions       = 0;
+
+    return optimizer;
+}
+
+void optimizer_reserve_globals(Optimizer* optimizer, int nb_glob_variables)
+{
+    assert(optimizer != NULL);
+
+    if (nb_glob_variables <= optimizer->nb_glob_variables)
+        return;
+
+    bool* reallocated_is_const  = realloc(optimizer->is_const_global, sizeof(bool) * (nb_glob_variables + (size_t) 1));
+    if (reallocated_is_const == NULL)
+    {
+        perror("Failed to allocate memory for the optimizer's global variables");
+        exit(EXIT_FAILURE);
+    }
+    optimizer->is_const_global = reallocated_is_const;
+    int* reallocated_values     = realloc(optimizer->const_global_value, sizeof(int) * (nb_glob_variables + (size_t) 1));
+    if (reallocated_values == NULL)
+    {
+        perror("Failed to allocate memory for the optimizer's global variables");
+        exit(EXIT_FAILURE);
+    }
+    optimizer->const_global_value = reallocated_values;
+
+    for (int i = optimizer->nb_glob_variables + 1; i <= nb_glob_variables; i++)
+    {
+        optimizer->is_const_global[i]    = false;
+        optimizer->const_global_value[i] = 0;
+    }
+    optimizer->nb_glob_variables = nb_glob_variables;
+}
+
+void optimizer_free(Optimizer* optimizer)
+{
+    assert(optimizer != NULL);
+
+    free(optimizer->is_const_global);
+    free(optimizer->const_global_value);
+    for (int i = 0; i < optimizer->nb_functions; i++)
+        syntactic_node_free_tree(optimizer->functions[i]);
+    free(optimizer->functions);
+    optimizer->is_const_global    = NULL;
+    optimizer->const_global_value = NULL;
+    optimizer->functions          = NULL;
+    optimizer->nb_functions       = 0;
+}
+
+void optimizer_register_function(Optimizer* optimizer, SyntacticNode* function)
+{
+    assert(function->type == NODE_FUNCTION);
+
+    SyntacticNode** reallocated_functions = realloc(optimizer->functions, sizeof(SyntacticNode*) * (optimizer->nb_functions + (size_t) 1));
+    if (reallocated_functions == NULL)
+    {
+        perror("Failed to allocate memory for the optimizer's functions");
+        exit(EXIT_FAILURE);
+    }
+    optimizer->functions = reallocated_functions;
+    optimizer->functions[optimizer->nb_functions++] = function;
+}
+
+SyntacticNode* optimizer_find_function(const Optimizer* optimizer, const char* name)
+{
+    for (int i = optimizer->nb_functions - 1; i >= 0; i--)
+    {
+        if (strcmp(optimizer->functions[i]->value.str_val, name) == 0)
+            return optimizer->functions[i];
+    }
+    return NULL;
+}
+
+void optimize_tree(Optimizer* optimizer, SyntacticNode* tree)
+{
+    assert(optimizer != NULL);
+    assert(tree != NULL && tree->type == NODE_PROGRAM);
+
+    // Functions are optimized in declaration order, so a callee is always optimized before its callers
+    for (int i = 0; i < tree->nb_children; i++)
+        optimize_declaration(optimizer, tree->children[i]);
+}
+
+void optimize_declaration(Optimizer* optimizer, SyntacticNode* global_decl)
+{
+    assert(optimizer != NULL && global_decl != NULL);
+
+    // A prototype has no body, calls to its function are never inlined
+    if (global_decl->type == NODE_FUNCTION && syntactic_node_is_flag_set(global_decl, EXTERN_FLAG))
+        return;
+
+    if (global_decl->type == NODE_FUNCTION && is_opti_enabled(optimizer->optimizations, OPTI_INLINE))
+        opti_inline_calls(optimizer, global_decl, global_decl);
+
+    if (is_opti_enabled(optimizer->optimizations, OPTI_CONST_FOLD))
+    {
+        SyntacticNode* folded = opti_fold_node(optimizer, global_decl);
+        assert(folded == global_decl); // Functions and global declarations can't be folded
+        (void) folded;
+    }
+
+    if (global_decl->type == NODE_FUNCTION && is_opti_enabled(optimizer->optimizations, OPTI_TAIL_CALL))
+        opti_eliminate_tail_calls(global_decl);
+
+    if (global_decl->type == NODE_FUNCTION && is_opti_enabled(optimizer->optimizations, OPTI_LICM))
+        opti_move_loop_invariants(optimizer, global_decl);
+
+    // Only the functions that can be inlined are needed later, a copy is kept so the optimized tree can be freed
+    if (global_decl->type == NODE_FUNCTION && is_opti_enabled(optimizer->optimizations, OPTI_INLINE)
+        && opti_inlinable_expression(global_decl) != NULL)
+        optimizer_register_function(optimizer, syntactic_node_copy_tree(global_decl));
+}
+
+// Helpers
+
+// True if evaluating the node may modify the state of the program
+bool opti_has_side_effects(const SyntacticNode* node)
+{
+    if (node->type == NODE_CALL || node->type == NODE_ASSIGNMENT || node->type == NODE_COMPOUND)
+        return true;
+
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        if (opti_has_side_effects(node->children[i]))
+            return true;
+    }
+    return false;
+}
+
+// True if the node can only be evaluated to 0 or 1
+bool opti_is_boolean(const SyntacticNode* node)
+{
+    switch (node->type)
+    {
+        case NODE_NEGATION:
+        case NODE_AND:
+        case NODE_OR:
+        case NODE_EQUAL:
+        case NODE_NOT_EQUAL:
+        case NODE_LESS:
+        case NODE_LESS_OR_EQUAL:
+        case NODE_GREATER:
+        case NODE_GREATER_OR_EQUAL:
+            return true;
+        case NODE_CONSTANT:
+            return node->value.int_val == 0 || node->value.int_val == 1;
+        default:
+            return false;
+    }
+}
+
+// Detaches the child at the given index and frees the rest of the subtree
+SyntacticNode* opti_extract_child(SyntacticNode* node, int index)
+{
+    assert(0 <= index && index < node->nb_children);
+
+    SyntacticNode* child = node->children[index];
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        if (i != index)
+            syntactic_node_free_tree(node->children[i]);
+    }
+    child->parent = NULL;
+    syntactic_node_free(node);
+
+    return child;
+}
+
+SyntacticNode* opti_replace_by_constant(SyntacticNode* node, int value)
+{
+    SyntacticNode* constant = syntactic_node_create_with_value(NODE_CONSTANT, node->line, node->col, value);
+    syntactic_node_free_tree(node);
+
+    return constant;
+}
+
+SyntacticNode* opti_replace_by_empty_sequence(SyntacticNode* node)
+{
+    SyntacticNode* sequence = syntactic_node_create(NODE_SEQUENCE, node->line, node->col);
+    syntactic_node_free_tree(node);
+
+    return sequence;
+}
+
+// Converts a value to 0 or 1 as '&&' and '||' do
+SyntacticNode* opti_to_boolean(SyntacticNode* node)
+{
+    if (opti_is_boolean(node))
+        return node;
+
+    SyntacticNode* not_equal = syntactic_node_create(NODE_NOT_EQUAL, node->line, node->col);
+    syntactic_node_add_child(not_equal, node);
+    syntactic_node_add_child(not_equal, syntactic_node_create_with_value(NODE_CONSTANT, node->line, node->col, 0));
+
+    return not_equal;
+}
+
+static inline bool is_int(long long value)
+{
+    return INT_MIN <= value && value <= INT_MAX;
+}
+
+// Computes the result of a binary operation on constants, returns false if it can't be folded (overflow, division by zero)
+bool opti_compute_binary(int node_type, int op1_val, int op2_val, int* result)
+{
+    long long value;
+    switch (node_type)
+    {
+        case NODE_EQUAL:            value = op1_val == op2_val; break;
+        case NODE_NOT_EQUAL:        value = op1_val != op2_val; break;
+        case NODE_LESS:             value = op1_val <  op2_val; break;
+        case NODE_LESS_OR_EQUAL:    value = op1_val <= op2_val; break;
+        case NODE_GREATER:          value = op1_val >  op2_val; break;
+        case NODE_GREATER_OR_EQUAL: value = op1_val >= op2_val; break;
+        case NODE_ADD:              value = (long long) op1_val + op2_val; break;
+        case NODE_SUB:              value = (long long) op1_val - op2_val; break;
+        case NODE_MUL:              value = (long long) op1_val * op2_val; break;
+        case NODE_BITWISE_OR:       value = op1_val | op2_val; break;
+        case NODE_BITWISE_XOR:      value = op1_val ^ op2_val; break;
+        case NODE_BITWISE_AND:      value = op1_val & op2_val; break;
+        // The shift count is taken modulo 32 as the msm 'shl' and 'shr' instructions do
+        case NODE_LEFT_SHIFT:       value = (int) ((unsigned) op1_val << (op2_val & 31)); break;
+        case NODE_RIGHT_SHIFT:      value = op1_val >> (op2_val & 31); break;
+        case NODE_DIV:
+        case NODE_MOD:
+        {
+            if (op2_val == 0 || (op1_val == INT_MIN && op2_val == -1))
+                return false;
+            value = (node_type == NODE_DIV) ? op1_val / op2_val : op1_val % op2_val;
+            break;
+        }
+        default:
+            return false;
+    }
+
+    if ( ! is_int(value))
+        return false;
+
+    *result = (int) value;
+    return true;
+}
+
+// Folding
+
+SyntacticNode* opti_fold_arithmetic(SyntacticNode* node)
+{
+    assert(node->nb_children == 2);
+
+    SyntacticNode* lhs = node->children[0];
+    SyntacticNode* rhs = node->children[1];
+
+    if (lhs->type == NODE_CONSTANT && rhs->type == NODE_CONSTANT)
+    {
+        int value;
+        if (opti_compute_binary(node->type, lhs->value.int_val, rhs->value.int_val, &value))
+            return opti_replace_by_constant(node, value);
+
+        return node;
+    }
+
+    // Constants are moved on the right side of commutative operators to ease the reassociation
+    if ((node->type == NODE_ADD || node->type == NODE_MUL || node->type == NODE_BITWISE_OR
+         || node->type == NODE_BITWISE_XOR || node->type == NODE_BITWISE_AND) && lhs->type == NODE_CONSTANT)
+    {
+        node->children[0] = rhs;
+        node->children[1] = lhs;
+        lhs = node->children[0];
+        rhs = node->children[1];
+    }
+
+    if (rhs->type != NODE_CONSTANT)
+        return node;
+
+    const int constant = rhs->value.int_val;
+
+    // (x + c1) + c2 ----> x + (c1 + c2)
+    // (x - c1) + c2 ----> x + (c2 - c1)
+    // (x + c1) - c2 ----> x + (c1 - c2)
+    // (x - c1) - c2 ----> x + (-c1 - c2)
+    if ((node->type == NODE_ADD || node->type == NODE_SUB)
+        && (lhs->type == NODE_ADD || lhs->type == NODE_SUB)
+        && lhs->children[1]->type == NODE_CONSTANT)
+    {
+        const int inner_constant = lhs->children[1]->value.int_val;
+        long long value = (lhs->type  == NODE_ADD ? (long long) inner_constant : - (long long) inner_constant)
+                        + (node->type == NODE_ADD ? (long long) constant       : - (long long) constant);
+        if (is_int(value))
+        {
+            lhs->type = NODE_ADD;
+            lhs->children[1]->value.int_val = (int) value;
+            return opti_fold_arithmetic(opti_extract_child(node, 0));
+        }
+    }
+
+    // (x * c1) * c2 ----> x * (c1 * c2)
+    if (node->type == NODE_MUL && lhs->type == NODE_MUL && lhs->children[1]->type == NODE_CONSTANT)
+    {
+        long long value = (long long) lhs->children[1]->value.int_val * constant;
+        if (is_int(value))
+        {
+            lhs->children[1]->value.int_val = (int) value;
+            return opti_fold_arithmetic(opti_extract_child(node, 0));
+        }
+    }
+
+    // Algebraic identities
+    switch (node->type)
+    {
+        case NODE_ADD:
+        case NODE_SUB:
+        {
+            if (constant == 0) // x + 0, x - 0
+                return opti_extract_child(node, 0);
+            break;
+        }
+        case NODE_MUL:
+        {
+            if (constant == 1) // x * 1
+                return opti_extract_child(node, 0);
+            if (constant == 0 && ! opti_has_side_effects(lhs)) // x * 0
+                return opti_replace_by_constant(node, 0);
+            break;
+        }
+        case NODE_DIV:
+        {
+            if (constant == 1) // x / 1
+                return opti_extract_child(node, 0);
+            break;
+        }
+        case NODE_MOD:
+        {
+            if ((constant == 1 || constant == -1) && ! opti_has_side_effects(lhs)) // x % 1
+                return opti_replace_by_constant(node, 0);
+            break;
+        }
+        case NODE_BITWISE_OR:
+        case NODE_BITWISE_XOR:
+        case NODE_LEFT_SHIFT:
+        case NODE_RIGHT_SHIFT:
+        {
+            if (constant == 0) // x | 0, x ^ 0, x << 0, x >> 0
+                return opti_extract_child(node, 0);
+            break;
+        }
+        case NODE_BITWISE_AND:
+        {
+            if (constant == -1) // x & -1
+                return opti_extract_child(node, 0);
+            if (constant == 0 && ! opti_has_side_effects(lhs)) // x & 0
+                return opti_replace_by_constant(node, 0);
+            break;
+        }
+    }
+
+    return node;
+}
+
+SyntacticNode* opti_fold_logical(SyntacticNode* node)
+{
+    assert(node->nb_children == 2);
+    assert(node->type == NODE_AND || node->type == NODE_OR);
+
+    SyntacticNode* lhs = node->children[0];
+    SyntacticNode* rhs = node->children[1];
+
+    // The value that makes the result known whatever the other operand is
+    const bool absorbing = (node->type == NODE_OR);
+
+    if (lhs->type == NODE_CONSTANT)
+    {
+        // 0 && x ----> 0    1 || x ----> 1    (x is never evaluated)
+        if ((lhs->value.int_val != 0) == absorbing)
+            return opti_replace_by_constant(node, absorbing);
+        // 1 && x ----> x != 0    0 || x ----> x != 0
+        return opti_to_boolean(opti_extract_child(node, 1));
+    }
+    if (rhs->type == NODE_CONSTANT)
+    {
+        // x && 0 ----> 0    x || 1 ----> 1    (only if evaluating x does nothing else)
+        if ((rhs->value.int_val != 0) == absorbing)
+        {
+            if ( ! opti_has_side_effects(lhs))
+                return opti_replace_by_constant(node, absorbing);
+            return node;
+        }
+        // x && 1 ----> x != 0    x || 0 ----> x != 0
+        return opti_to_boolean(opti_extract_child(node, 0));
+    }
+
+    return node;
+}
+
+SyntacticNode* opti_fold_condition(SyntacticNode* node)
+{
+    assert(node->nb_children == 2 || node->nb_children == 3);
+
+    SyntacticNode* condition = node->children[0];
+    if (condition->type != NODE_CONSTANT)
+        return node;
+
+    // NODE_CONDITION executes its first instruction if the condition is true
+    // NODE_INVERTED_CONDITION executes its first instruction if the condition is false
+    bool first_branch_taken = (condition->value.int_val != 0) == (node->type == NODE_CONDITION);
+    if (first_branch_taken)
+        return opti_extract_child(node, 1);
+    else if (node->nb_children == 3)
+        return opti_extract_child(node, 2);
+    else
+        return opti_replace_by_empty_sequence(node);
+}
+
+void opti_fold_children(Optimizer* optimizer, SyntacticNode* node)
+{
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        SyntacticNode* folded = opti_fold_node(optimizer, node->children[i]);
+        if (folded != node->children[i])
+        {
+            node->children[i] = folded;
+            folded->parent = node;
+        }
+    }
+}
+
+SyntacticNode* opti_fold_node(Optimizer* optimizer, SyntacticNode* node)
+{
+    assert(node != NULL);
+
+    // The operation of a compound assignment holds the assigned operand, so only its operands are folded,
+    // e.g. 'x *= 1' must not become 'x'
+    if (node->type == NODE_COMPOUND)
+    {
+        opti_fold_children(optimizer, node->children[0]);
+        return node;
+    }
+    opti_fold_children(optimizer, node);
+
+    SyntacticNode* folded = node;
+    switch (node->type)
+    {
+        case NODE_DECL:
+        {
+            // Global initializers are always constant, so 'const' globals can be replaced by their value
+            if (syntactic_node_is_flag_set(node, GLOBAL_FLAG) && syntactic_node_is_flag_set(node, CONST_FLAG)
+                && node->nb_children == 1 && node->children[0]->children[1]->type == NODE_CONSTANT)
+            {
+                assert(0 <= node->stack_offset && node->stack_offset < optimizer->nb_glob_variables);
+                optimizer->is_const_global[node->stack_offset]    = true;
+                optimizer->const_global_value[node->stack_offset] = node->children[0]->children[1]->value.int_val;
+            }
+            break;
+        }
+        case NODE_REF:
+        {
+            bool is_assigned = node->parent->type == NODE_ASSIGNMENT && node->parent->children[0] == node;
+            if (syntactic_node_is_flag_set(node, GLOBAL_FLAG) && syntactic_node_is_flag_set(node, CONST_FLAG)
+                && optimizer->is_const_global[node->stack_offset]
+                && node->parent->type != NODE_ADDRESS && ! is_assigned)
+            {
+                folded = opti_replace_by_constant(node, optimizer->const_global_value[node->stack_offset]);
+            }
+            break;
+        }
+        case NODE_UNARY_MINUS:
+        {
+            SyntacticNode* operand = node->children[0];
+            if (operand->type == NODE_CONSTANT && operand->value.int_val != INT_MIN)
+                folded = opti_replace_by_constant(node, - operand->value.int_val);
+            break;
+        }
+        case NODE_NEGATION:
+        {
+            SyntacticNode* operand = node->children[0];
+            if (operand->type == NODE_CONSTANT)
+                folded = opti_replace_by_constant(node, ! operand->value.int_val);
+            break;
+        }
+        case NODE_BITWISE_NOT:
+        {
+            SyntacticNode* operand = node->children[0];
+            if (operand->type == NODE_CONSTANT)
+                folded = opti_replace_by_constant(node, ~ operand->value.int_val);
+            break;
+        }
+        case NODE_EQUAL:
+        case NODE_NOT_EQUAL:
+        case NODE_LESS:
+        case NODE_LESS_OR_EQUAL:
+        case NODE_GREATER:
+        case NODE_GREATER_OR_EQUAL:
+        case NODE_ADD:
+        case NODE_SUB:
+        case NODE_MUL:
+        case NODE_DIV:
+        case NODE_MOD:
+        case NODE_BITWISE_OR:
+        case NODE_BITWISE_XOR:
+        case NODE_BITWISE_AND:
+        case NODE_LEFT_SHIFT:
+        case NODE_RIGHT_SHIFT:
+        {
+            folded = opti_fold_arithmetic(node);
+            break;
+        }
+        case NODE_AND:
+        case NODE_OR:
+        {
+            folded = opti_fold_logical(node);
+            break;
+        }
+        case NODE_CONDITION:
+        case NODE_INVERTED_CONDITION:
+        {
+            folded = opti_fold_condition(node);
+            break;
+        }
+        case NODE_INLINED_CALL:
+        {
+            // All the arguments have been substituted
+            if (node->children[0]->nb_children == 0)
+                folded = opti_extract_child(node, 1);
+            break;
+        }
+        case NODE_DROP:
+        {
+            // The value is computed only to be dropped
+            if ( ! opti_has_side_effects(node->children[0]))
+                folded = opti_replace_by_empty_sequence(node);
+            break;
+        }
+    }
+
+    return folded;
+}
+
+// Inlining
+
+int opti_tree_size(const SyntacticNode* node)
+{
+    int size = 1;
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        size += opti_tree_size(node->children[i]);
+    }
+    return size;
+}
+
+bool opti_calls_function(const SyntacticNode* node, const char* name)
+{
+    if (node->type == NODE_CALL && strcmp(node->value.str_val, name) == 0)
+        return true;
+
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        if (opti_calls_function(node->children[i], name))
+            return true;
+    }
+    return false;
+}
+
+static inline bool is_param_ref(const SyntacticNode* node, int param_offset)
+{
+    return node->type == NODE_REF && ! syntactic_node_is_flag_set(node, GLOBAL_FLAG) && node->stack_offset == param_offset;
+}
+
+int opti_count_param_uses(const SyntacticNode* node, int param_offset)
+{
+    int nb_uses = is_param_ref(node, param_offset) ? 1 : 0;
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        nb_uses += opti_count_param_uses(node->children[i], param_offset);
+    }
+    return nb_uses;
+}
+
+// True if the parameter is assigned or if its address is taken, so it needs its own variable
+bool opti_is_param_modified(const SyntacticNode* node, int param_offset)
+{
+    if ((node->type == NODE_ASSIGNMENT && is_param_ref(node->children[0], param_offset))
+        || (node->type == NODE_COMPOUND && is_param_ref(node->children[0]->children[0], param_offset))
+        || (node->type == NODE_ADDRESS && is_param_ref(node->children[0], param_offset)))
+        return true;
+
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        if (opti_is_param_modified(node->children[i], param_offset))
+            return true;
+    }
+    return false;
+}
+
+// Returns the expression returned by the function if it can be inlined, NULL otherwise
+SyntacticNode* opti_inlinable_expression(const SyntacticNode* function)
+{
+    assert(function->type == NODE_FUNCTION && function->nb_children == 2);
+
+    SyntacticNode* body = function->children[1];
+    if (body->nb_children != 1 || body->children[0]->type != NODE_RETURN || body->children[0]->nb_children != 1)
+        return NULL;
+
+    SyntacticNode* expression = body->children[0]->children[0];
+    if (opti_tree_size(expression) > INLINE_MAX_SIZE || opti_calls_function(expression, function->value.str_val))
+        return NULL;
+
+    return expression;
+}
+
+// The variables of the inlined function other than its parameters bind the arguments of the calls inlined in it,
+// they are moved to the variables of the caller from 'first_local'
+SyntacticNode* opti_substitute_params(SyntacticNode* node, SyntacticNode** substitutes, int nb_params, int nb_locals, int first_local)
+{
+    if (node->type == NODE_REF && ! syntactic_node_is_flag_set(node, GLOBAL_FLAG))
+    {
+        assert(0 <= node->stack_offset && node->stack_offset < nb_params + nb_locals);
+        if (node->stack_offset >= nb_params)
+        {
+            node->stack_offset = first_local + node->stack_offset - nb_params;
+            return node;
+        }
+
+        assert(substitutes[node->stack_offset] != NULL);
+        SyntacticNode* substitute = syntactic_node_copy_tree(substitutes[node->stack_offset]);
+        syntactic_node_free(node);
+        return substitute;
+    }
+
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        SyntacticNode* substituted = opti_substitute_params(node->children[i], substitutes, nb_params, nb_locals, first_local);
+        if (substituted != node->children[i])
+        {
+            node->children[i] = substituted;
+            substituted->parent = node;
+        }
+    }
+    return node;
+}
+
+SyntacticNode* opti_inline_call(SyntacticNode* function, SyntacticNode* call, const SyntacticNode* callee, const SyntacticNode* expression)
+{
+    SyntacticNode* params = callee->children[0];
+    SyntacticNode* args   = call->children[0];
+    const int nb_params   = params->nb_children;
+    assert(args->nb_children == nb_params);
+
+    // Arguments can only be moved inside the expression if doing so doesn't change the order of the side effects
+    bool can_substitute = ! opti_has_side_effects(expression) && ! opti_has_side_effects(args);
+
+    SyntacticNode* inlined = syntactic_node_create(NODE_INLINED_CALL, call->line, call->col);
+    inlined->value.str_val = callee->value.str_val;
+    SyntacticNode* bindings = syntactic_node_create(NODE_SEQUENCE, call->line, call->col);
+    syntactic_node_add_child(inlined, bindings);
+
+    SyntacticNode** substitutes = calloc(nb_params + (size_t) 1, sizeof(SyntacticNode*));
+    if (substitutes == NULL)
+    {
+        perror("Failed to allocate memory for the substitutes of the inlined parameters");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < nb_params; i++)
+    {
+        SyntacticNode* arg = args->children[i];
+        const int nb_uses = opti_count_param_uses(expression, i);
+
+        if ( ! opti_is_param_modified(expression, i)
+             && (arg->type == NODE_CONSTANT
+                 || (can_substitute && nb_uses <= 1)
+                 || (can_substitute && arg->type == NODE_REF && ! syntactic_node_is_flag_set(arg, GLOBAL_FLAG))))
+        {
+            substitutes[i] = arg;
+        }
+        else
+        { // The argument is stored in a new variable of the caller
+            SyntacticNode* variable = syntactic_node_create(NODE_REF, arg->line, arg->col);
+            variable->value.str_val = params->children[i]->value.str_val;
+            variable->stack_offset  = function->children[0]->nb_children + function->nb_var;
+            function->nb_var++;
+
+            SyntacticNode* drop       = syntactic_node_create(NODE_DROP, arg->line, arg->col);
+            SyntacticNode* assignment = syntactic_node_create(NODE_ASSIGNMENT, arg->line, arg->col);
+            syntactic_node_add_child(assignment, syntactic_node_copy_tree(variable));
+            syntactic_node_add_child(assignment, syntactic_node_copy_tree(arg));
+            syntactic_node_add_child(drop, assignment);
+            syntactic_node_add_child(bindings, drop);
+
+            substitutes[i] = variable;
+        }
+    }
+
+    // The callee may itself hold inlined calls whose arguments are bound to its variables
+    const int first_local = function->children[0]->nb_children + function->nb_var;
+    function->nb_var += callee->nb_var;
+    SyntacticNode* body = opti_substitute_params(syntactic_node_copy_tree(expression), substitutes, nb_params, callee->nb_var, first_local);
+    syntactic_node_add_child(inlined, body);
+
+    for (int i = 0; i < nb_params; i++)
+    {
+        if (substitutes[i] != args->children[i])
+            syntactic_node_free(substitutes[i]);
+    }
+    free(substitutes);
+    syntactic_node_free_tree(call);
+
+    return inlined;
+}
+
+SyntacticNode* opti_inline_calls(Optimizer* optimizer, SyntacticNode* function, SyntacticNode* node)
+{
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        SyntacticNode* inlined = opti_inline_calls(optimizer, function, node->children[i]);
+        if (inlined != node->children[i])
+        {
+            node->children[i] = inlined;
+            inlined->parent = node;
+        }
+    }
+
+    if (node->type == NODE_CALL)
+    {
+        // The function being optimized isn't registered yet, so it can't be inlined in itself
+        const SyntacticNode* callee = optimizer_find_function(optimizer, node->value.str_val);
+        if (callee != NULL)
+        {
+            const SyntacticNode* expression = opti_inlinable_expression(callee);
+            if (expression != NULL)
+                return opti_inline_call(function, node, callee, expression);
+        }
+    }
+
+    return node;
+}
+
+// Tail calls
+
+bool opti_takes_local_address(const SyntacticNode* node)
+{
+    if (node->type == NODE_ADDRESS && ! syntactic_node_is_flag_set(node->children[0], GLOBAL_FLAG))
+        return true;
+    // The elements of a local array are accessed through their address
+    if (node->type == NODE_DECL && syntactic_node_is_flag_set(node, ARRAY_FLAG) && ! syntactic_node_is_flag_set(node, GLOBAL_FLAG))
+        return true;
+
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        if (opti_takes_local_address(node->children[i]))
+            return true;
+    }
+    return false;
+}
+
+SyntacticNode* opti_replace_tail_calls(SyntacticNode* function, SyntacticNode* node)
+{
+    if (node->type == NODE_RETURN && node->nb_children == 1
+        && node->children[0]->type == NODE_CALL
+        && strcmp(node->children[0]->value.str_val, function->value.str_val) == 0)
+    {
+        SyntacticNode* call = node->children[0];
+        assert(call->children[0]->nb_children == function->children[0]->nb_children);
+
+        SyntacticNode* tail_call = syntactic_node_create(NODE_TAIL_CALL, node->line, node->col);
+        tail_call->value.str_val = call->value.str_val;
+        syntactic_node_add_child(tail_call, opti_extract_child(call, 0));
+        syntactic_node_free(node);
+        syntactic_node_set_flag(function, TAIL_CALL_FLAG);
+
+        return tail_call;
+    }
+
+    // A 'return' can't be found inside an expression
+    if (node->type == NODE_FUNCTION || node->type == NODE_SEQUENCE || node->type == NODE_BLOCK
+        || node->type == NODE_CONDITION || node->type == NODE_INVERTED_CONDITION || node->type == NODE_LOOP)
+    {
+        for (int i = 0; i < node->nb_children; i++)
+        {
+            SyntacticNode* replaced = opti_replace_tail_calls(function, node->children[i]);
+            if (replaced != node->children[i])
+            {
+                node->children[i] = replaced;
+                replaced->parent = node;
+            }
+        }
+    }
+    return node;
+}
+
+void opti_eliminate_tail_calls(SyntacticNode* function)
+{
+    assert(function->type == NODE_FUNCTION);
+
+    // Pointers to the frame must stay valid during the call
+    if ( ! opti_takes_local_address(function))
+        opti_replace_tail_calls(function, function);
+}
+
+// Loop-invariant code motion
+
+typedef struct LoopInfo_s LoopInfo;
+struct LoopInfo_s
+{
+    SyntacticNode* function;
+    int            nb_locals;
+    bool*          is_local_modified;      // Indexed by the local's stack offset
+    bool*          is_global_modified;     // Indexed by the global's offset
+    const bool*    is_local_address_taken; // Locals that may be modified through a pointer
+    int            nb_addressable_locals;  // Locals created by the motion come after them and never have their address taken
+    bool           has_call;               // The called functions may modify any global and any local whose address is taken
+    bool           has_store;              // Assignment through a pointer
+    SyntacticNode* hoisted;                // Assignments of the hoisted expressions to their variables
+};
+
+void opti_find_address_taken(const SyntacticNode* node, bool* is_local_address_taken)
+{
+    if (node->type == NODE_ADDRESS && ! syntactic_node_is_flag_set(node->children[0], GLOBAL_FLAG))
+        is_local_address_taken[node->children[0]->stack_offset] = true;
+
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        opti_find_address_taken(node->children[i], is_local_address_taken);
+    }
+}
+
+void opti_mark_modified(LoopInfo* info, const SyntacticNode* target)
+{
+    if (target->type == NODE_REF)
+    {
+        if (syntactic_node_is_flag_set(target, GLOBAL_FLAG))
+            info->is_global_modified[target->stack_offset] = true;
+        else
+            info->is_local_modified[target->stack_offset] = true;
+    }
+    else
+    {
+        info->has_store = true;
+    }
+}
+
+void opti_find_loop_effects(LoopInfo* info, const SyntacticNode* node)
+{
+    switch (node->type)
+    {
+        case NODE_ASSIGNMENT: opti_mark_modified(info, node->children[0]);              break;
+        case NODE_COMPOUND:   opti_mark_modified(info, node->children[0]->children[0]); break;
+        case NODE_CALL:
+        case NODE_TAIL_CALL:  info->has_call = true;                                    break;
+        case NODE_DECL:
+        {
+            // A variable declared inside the loop gets a new value on each iteration
+            if ( ! syntactic_node_is_flag_set(node, GLOBAL_FLAG))
+                info->is_local_modified[node->stack_offset] = true;
+            break;
+        }
+        default: break;
+    }
+
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        opti_find_loop_effects(info, node->children[i]);
+    }
+}
+
+bool opti_is_loop_invariant(const LoopInfo* info, const SyntacticNode* node)
+{
+    switch (node->type)
+    {
+        case NODE_CONSTANT:
+            return true;
+        case NODE_REF:
+        {
+            if (syntactic_node_is_flag_set(node, GLOBAL_FLAG))
+                return ! info->is_global_modified[node->stack_offset] && ! info->has_call && ! info->has_store;
+
+            bool is_address_taken = node->stack_offset < info->nb_addressable_locals && info->is_local_address_taken[node->stack_offset];
+            return ! info->is_local_modified[node->stack_offset] && ! (is_address_taken && (info->has_call || info->has_store));
+        }
+        case NODE_ADDRESS:
+            // The address of a variable doesn't change during the execution of the function
+            return node->children[0]->type == NODE_REF;
+        case NODE_DIV:
+        case NODE_MOD:
+        {
+            // Computing it before the loop must not trap when the loop wouldn't have computed it
+            const SyntacticNode* divisor = node->children[1];
+            if (divisor->type != NODE_CONSTANT || divisor->value.int_val == 0 || divisor->value.int_val == -1)
+                return false;
+        }
+        // fall through
+        case NODE_UNARY_MINUS:
+        case NODE_NEGATION:
+        case NODE_BITWISE_NOT:
+        case NODE_OR:
+        case NODE_AND:
+        case NODE_EQUAL:
+        case NODE_NOT_EQUAL:
+        case NODE_GREATER:
+        case NODE_GREATER_OR_EQUAL:
+        case NODE_LESS:
+        case NODE_LESS_OR_EQUAL:
+        case NODE_MUL:
+        case NODE_ADD:
+        case NODE_SUB:
+        case NODE_BITWISE_OR:
+        case NODE_BITWISE_XOR:
+        case NODE_BITWISE_AND:
+        case NODE_LEFT_SHIFT:
+        case NODE_RIGHT_SHIFT:
+        {
+            for (int i = 0; i < node->nb_children; i++)
+            {
+                if ( ! opti_is_loop_invariant(info, node->children[i]))
+                    return false;
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool opti_trees_equal(const SyntacticNode* tree1, const SyntacticNode* tree2)
+{
+    if (tree1->type != tree2->type || tree1->nb_children != tree2->nb_children || tree1->flags != tree2->flags)
+        return false;
+    if (tree1->type == NODE_CONSTANT && tree1->value.int_val != tree2->value.int_val)
+        return false;
+    if (tree1->type == NODE_REF && tree1->stack_offset != tree2->stack_offset)
+        return false;
+
+    for (int i = 0; i < tree1->nb_children; i++)
+    {
+        if ( ! opti_trees_equal(tree1->children[i], tree2->children[i]))
+            return false;
+    }
+    return true;
+}
+
+// Replaces the expression by a reference to the variable holding its value before the loop
+SyntacticNode* opti_hoist_expression(LoopInfo* info, SyntacticNode* expression)
+{
+    SyntacticNode* variable = NULL;
+    for (int i = 0; i < info->hoisted->nb_children && variable == NULL; i++)
+    {
+        SyntacticNode* assignment = info->hoisted->children[i]->children[0];
+        if (opti_trees_equal(assignment->children[1], expression))
+            variable = assignment->children[0];
+    }
+
+    if (variable == NULL)
+    {
+        variable = syntactic_node_create(NODE_REF, expression->line, expression->col);
+        variable->value.str_val = "<invariant>";
+        variable->stack_offset  = info->function->children[0]->nb_children + info->function->nb_var;
+        info->function->nb_var++;
+
+        SyntacticNode* drop       = syntactic_node_create(NODE_DROP, expression->line, expression->col);
+        SyntacticNode* assignment = syntactic_node_create(NODE_ASSIGNMENT, expression->line, expression->col);
+        syntactic_node_add_child(assignment, variable);
+        syntactic_node_add_child(assignment, syntactic_node_copy_tree(expression));
+        syntactic_node_add_child(drop, assignment);
+        syntactic_node_add_child(info->hoisted, drop);
+    }
+
+    SyntacticNode* reference = syntactic_node_copy_tree(variable);
+    syntactic_node_free_tree(expression);
+    return reference;
+}
+
+SyntacticNode* opti_hoist_invariants(LoopInfo* info, SyntacticNode* node);
+
+// Only the address computation of an assigned memory location can be hoisted
+void opti_hoist_from_target(LoopInfo* info, SyntacticNode* target)
+{
+    if (target->type == NODE_DEREF)
+    {
+        SyntacticNode* hoisted = opti_hoist_invariants(info, target->children[0]);
+        target->children[0] = hoisted;
+        hoisted->parent = target;
+    }
+}
+
+SyntacticNode* opti_hoist_invariants(LoopInfo* info, SyntacticNode* node)
+{
+    // Constants and local variables are already as cheap as the hoisted variable
+    bool is_trivial = node->type == NODE_CONSTANT || (node->type == NODE_REF && ! syntactic_node_is_flag_set(node, GLOBAL_FLAG));
+    if ( ! is_trivial && opti_is_loop_invariant(info, node))
+        return opti_hoist_expression(info, node);
+
+    int first_child = 0;
+    switch (node->type)
+    {
+        case NODE_ADDRESS:
+            return node;
+        case NODE_ASSIGNMENT:
+        {
+            opti_hoist_from_target(info, node->children[0]);
+            first_child = 1;
+            break;
+        }
+        case NODE_COMPOUND:
+        {
+            SyntacticNode* operation = node->children[0];
+            opti_hoist_from_target(info, operation->children[0]);
+            SyntacticNode* hoisted = opti_hoist_invariants(info, operation->children[1]);
+            operation->children[1] = hoisted;
+            hoisted->parent = operation;
+            return node;
+        }
+        default: break;
+    }
+
+    for (int i = first_child; i < node->nb_children; i++)
+    {
+        SyntacticNode* hoisted = opti_hoist_invariants(info, node->children[i]);
+        if (hoisted != node->children[i])
+        {
+            node->children[i] = hoisted;
+            hoisted->parent = node;
+        }
+    }
+    return node;
+}
+
+SyntacticNode* opti_move_invariants_out_of(Optimizer* optimizer, SyntacticNode* function, const bool* is_local_address_taken, int nb_addressable_locals, SyntacticNode* node)
+{
+    SyntacticNode* replacement = node;
+    if (node->type == NODE_LOOP)
+    {
+        LoopInfo info;
+        info.function               = function;
+        info.nb_locals              = function->children[0]->nb_children + function->nb_var;
+        info.is_local_modified      = calloc(info.nb_locals + (size_t) 1, sizeof(bool));
+        info.is_global_modified     = calloc(optimizer->nb_glob_variables + (size_t) 1, sizeof(bool));
+        info.is_local_address_taken = is_local_address_taken;
+        info.nb_addressable_locals  = nb_addressable_locals;
+        info.has_call               = false;
+        info.has_store              = false;
+        info.hoisted                = syntactic_node_create(NODE_SEQUENCE, node->line, node->col);
+        if (info.is_local_modified == NULL || info.is_global_modified == NULL)
+        {
+            perror("Failed to allocate memory for the loop-invariant code motion");
+            exit(EXIT_FAILURE);
+        }
+
+        opti_find_loop_effects(&info, node);
+        opti_hoist_invariants(&info, node);
+
+        if (info.hoisted->nb_children > 0)
+        {
+            replacement  = info.hoisted;
+            node->parent = NULL;
+            syntactic_node_add_child(replacement, node);
+        }
+        else
+        {
+            syntactic_node_free(info.hoisted);
+        }
+        free(info.is_local_modified);
+        free(info.is_global_modified);
+    }
+
+    // Inner loops
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        SyntacticNode* moved = opti_move_invariants_out_of(optimizer, function, is_local_address_taken, nb_addressable_locals, node->children[i]);
+        if (moved != node->children[i])
+        {
+            node->children[i] = moved;
+            moved->parent = node;
+        }
+    }
+    return replacement;
+}
+
+void opti_move_loop_invariants(Optimizer* optimizer, SyntacticNode* function)
+{
+    assert(function->type == NODE_FUNCTION);
+
+    const int nb_locals = function->children[0]->nb_children + function->nb_var;
+    bool* is_local_address_taken = calloc(nb_locals + (size_t) 1, sizeof(bool));
+    if (is_local_address_taken == NULL)
+    {
+        perror("Failed to allocate memory for the loop-invariant code motion");
+        exit(EXIT_FAILURE);
+    }
+    opti_find_address_taken(function, is_local_address_taken);
+
+    for (int i = 0; i < function->nb_children; i++)
+    {
+        SyntacticNode* moved = opti_move_invariants_out_of(optimizer, function, is_local_address_taken, nb_locals, function->children[i]);
+        assert(moved == function->children[i]);
+        (void) moved;
+    }
+    free(is_local_address_taken);
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <stdbool.h>
+
+#include "syntactic_node.h"
+
 #define NO_OPTIMIZATION 0
 
 /*
@@ -10,12 +14,137 @@
 * ----> 4 + 7 - 1
 * ----> 4 + 6
 * ----> 10
+*
+* After the semantic analysis, the whole tree is folded again :
+*   - 'const' global variables are replaced by their value
+*   - constants are reassociated                 (x + 1 + 2 ----> x + 3)
+*   - algebraic identities are simplified        (x * 1 ----> x, x + 0 ----> x, x * 0 ----> 0)
+*   - branches with a constant condition are pruned (if (0), while (1))
 */
 #define OPTI_CONST_FOLD (1 << 0)
 
-typedef unsigned char optimization_t;
+/*
+* Enables the inlining of small functions whose body is a single 'return' statement.
+* The call is replaced by the returned expression, the parameters that can't be
+* substituted by their argument are stored in new variables of the caller's frame.
+* Ex:
+*       int data_to_block_size(int data_size) { return data_size + 2; }
+*       ... data_to_block_size(size) ...
+* ----> ... size + 2 ...
+*/
+#define OPTI_INLINE (1 << 1)
+
+/*
+* Enables the elimination of self-recursive tail calls.
+* 'return f(...);' inside 'f' stores the arguments in the parameters and jumps back
+* to the entry of 'f' instead of pushing a new frame, so the recursion runs in constant stack.
+* Functions taking the address of a local variable are left untouched.
+*/
+#define OPTI_TAIL_CALL (1 << 2)
+
+/*
+* Enables loop-invariant code motion.
+* Pure expressions whose value can't change inside a loop are computed once before it
+* and stored in new variables of the function's frame.
+* Ex:
+*       while (i < size * 4) { ... }
+* ----> tmp = size * 4; while (i < tmp) { ... }
+* Expressions that may trap (division by a variable) or read memory through a pointer are not moved.
+*/
+#define OPTI_LICM (1 << 3)
+
+/*
+* Enables compare-and-branch instructions in code generation.
+* A comparison directly tested by a condition jumps without pushing a boolean,
+* and the '!' operators on top of a condition invert the jump instead of being computed.
+* Ex:
+*       if (!(a < b)) ...
+* ----> get a, get b, jlt else_0     instead of     get a, get b, cmplt, not, jumpf else_0
+*/
+#define OPTI_FUSED_BRANCH (1 << 4)
+
+/*
+* Enables better code generation for '&&' and '||'.
+* When they are tested by a condition, each operand jumps directly to the targets of the condition
+* instead of computing 0 or 1.
+* Elsewhere, a cheap right operand that has no side effects and can't trap is always evaluated,
+* which avoids the jumps of the short-circuit evaluation.
+*/
+#define OPTI_LOGICAL_BRANCH (1 << 5)
+
+/*
+* Enables jump threading over the generated instruction stream.
+*   - a branch to a 'jump' goes directly to the final destination
+*   - adjacent labels are merged and the unused ones are removed
+*   - a 'jump' to the label that follows it is removed
+*   - a conditional branch over a 'jump' is replaced by the opposite branch to the target of the 'jump'
+*   - the instructions that can't be reached after a 'jump', 'ret' or 'halt' are removed
+*/
+#define OPTI_JUMP_THREADING (1 << 6)
+
+/*
+* Enables the optimizations on the SSA form of the functions (see ssa.h).
+* Each function is translated to a control flow graph in static single assignment form, then
+*   - sparse conditional constant propagation replaces the values that are constant on every executed path
+*     and removes the branches that are never taken
+*   - global value numbering reuses a value already computed by a dominating instruction
+*   - dead code elimination removes the values that aren't needed by a side effect or by the control flow
+* The values are then scheduled on the stack, those used only once are computed where they are needed.
+* Functions taking the address of a local variable are generated from the tree.
+*/
+#define OPTI_SSA (1 << 7)
+
+/*
+* Enables stack scheduling over the generated instruction stream.
+* A value stored in a variable and read right after stays on the stack instead of being reloaded.
+* Ex:
+*       a = b + 1; c = a * 2;
+* ----> ..., dup, set a, drop, get a, push 2, ...     becomes     ..., dup, set a, push 2, ...
+* With the SSA optimizations, a value only copied to a phi at the end of its block is also computed by the copy.
+*/
+#define OPTI_STACK_SCHEDULING (1 << 8)
+
+/*
+* Enables strength reduction of the operations by a power of two.
+*   - a multiplication by 2^k becomes a left shift          (x * 8 ----> x << 3)
+*   - a modulo by 2^k only tested against zero becomes a mask (x % 2 == 0 ----> (x & 1) == 0)
+* Divisions and modulos used for their value are kept : shifting a negative number doesn't round toward zero.
+*/
+#define OPTI_STRENGTH_REDUCTION (1 << 9)
+
+/*
+* Enables the indexed memory instructions for the accesses to 'base[index]'.
+* Ex:
+*       a[i] = x
+* ----> get x, dup, get a, get i, writex     instead of     get x, dup, get a, get i, add, write
+* The elements of a local array are accessed relatively to the frame with 'getx' and 'setx',
+* which also saves the computation of the address of the array.
+*/
+#define OPTI_INDEXED_ACCESS (1 << 10)
+
+typedef unsigned short optimization_t;
 
 static inline int is_opti_enabled(optimization_t optimizations, optimization_t opti_code)
 {
     return (optimizations & opti_code) != 0;
 }
+
+typedef struct Optimizer_s Optimizer;
+struct Optimizer_s
+{
+    optimization_t  optimizations;
+    int             nb_glob_variables;
+    bool*           is_const_global;    // Indexed by the global's offset
+    int*            const_global_value; // Value of the 'const' global, only valid if is_const_global is set
+    SyntacticNode** functions;          // Copies of the inlinable functions already optimized, in declaration order
+    int             nb_functions;
+};
+
+Optimizer optimizer_create(optimization_t optimizations, int nb_glob_variables);
+// Makes room for the global variables declared since the creation of the optimizer
+void optimizer_reserve_globals(Optimizer* optimizer, int nb_glob_variables);
+void optimizer_free(Optimizer* optimizer);
+// Runs the enabled optimizations on a tree that went through the semantic analysis
+void optimize_tree(Optimizer* optimizer, SyntacticNode* tree);
+// Same for a single function or global declaration, the declarations must be optimized in their order in the program
+void optimize_declaration(Optimizer* optimizer, SyntacticNode* global_decl);
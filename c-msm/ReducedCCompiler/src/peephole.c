@@ -0,0 +1,555 @@
+#include "peephole.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LINE_LENGTH 4096    // Same as msm
+#define ENTRY_LABEL     "start" // Where msm starts the execution, it must always be kept
+
+typedef struct Instruction_s Instruction;
+struct Instruction_s
+{
+    char* label;      // Label defined by the line, NULL for an instruction
+    char* opcode;
+    char* operand;    // NULL if the instruction has no operand
+    bool  is_removed;
+};
+
+typedef struct Code_s Code;
+struct Code_s
+{
+    Instruction* lines;
+    int          nb_lines;
+    int          capacity;
+    int*         label_table;      // Open addressing hash table of the lines defining the labels
+    int          label_table_size; // Power of 2
+    const char*  kept_label;       // Label referenced from outside of the code, NULL if the code is the whole program
+};
+
+// Helpers
+
+char* peephole_copy_string(const char* string)
+{
+    size_t length = strlen(string);
+    char* copy = malloc(length + 1);
+    if (copy == NULL)
+    {
+        perror("Failed to allocate memory for the instruction stream");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(copy, string, length + 1);
+    return copy;
+}
+
+void code_append(Code* code, Instruction instruction)
+{
+    if (code->nb_lines == code->capacity)
+    {
+        code->capacity = (code->capacity == 0) ? 256 : 2 * code->capacity;
+        Instruction* reallocated_lines = realloc(code->lines, sizeof(Instruction) * code->capacity);
+        if (reallocated_lines == NULL)
+        {
+            perror("Failed to allocate memory for the instruction stream");
+            exit(EXIT_FAILURE);
+        }
+        code->lines = reallocated_lines;
+    }
+    code->lines[code->nb_lines++] = instruction;
+}
+
+Code code_read(FILE* in_stream)
+{
+    Code code = { NULL, 0, 0, NULL, 0, NULL };
+    char buffer[MAX_LINE_LENGTH];
+
+    while (fgets(buffer, sizeof(buffer), in_stream) != NULL)
+    {
+        char* tokens[3];
+        int nb_tokens = 0;
+        for (char* token = strtok(buffer, " \t\r\n"); token != NULL && token[0] != ';'; token = strtok(NULL, " \t\r\n"))
+        {
+            if (nb_tokens == 0 && token[0] == '.')
+            {
+                Instruction label = { peephole_copy_string(token + 1), NULL, NULL, false };
+                code_append(&code, label);
+            }
+            else if (nb_tokens < 3)
+            {
+                tokens[nb_tokens++] = token;
+            }
+        }
+
+        if (nb_tokens > 0)
+        {
+            Instruction instruction = { NULL, peephole_copy_string(tokens[0]), NULL, false };
+            if (nb_tokens > 1)
+                instruction.operand = peephole_copy_string(tokens[1]);
+            code_append(&code, instruction);
+        }
+    }
+    return code;
+}
+
+void code_write(const Code* code, FILE* out_stream)
+{
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        const Instruction* line = &code->lines[i];
+        if (line->is_removed)
+            continue;
+
+        if (line->label != NULL)
+            fprintf(out_stream, ".%s\n", line->label);
+        else if (line->operand != NULL)
+            fprintf(out_stream, "        %s %s\n", line->opcode, line->operand);
+        else
+            fprintf(out_stream, "        %s\n", line->opcode);
+    }
+}
+
+void code_free(Code* code)
+{
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        free(code->lines[i].label);
+        free(code->lines[i].opcode);
+        free(code->lines[i].operand);
+    }
+    free(code->lines);
+    free(code->label_table);
+    code->lines       = NULL;
+    code->nb_lines    = 0;
+    code->capacity    = 0;
+    code->label_table = NULL;
+}
+
+// FNV-1a
+unsigned long peephole_hash(const char* string)
+{
+    unsigned long hash = 2166136261UL;
+    for (; *string != '\0'; string++)
+    {
+        hash ^= (unsigned char) *string;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+void code_index_labels(Code* code)
+{
+    code->label_table_size = 16;
+    while (code->label_table_size < 2 * code->nb_lines)
+        code->label_table_size *= 2;
+
+    code->label_table = malloc(sizeof(int) * code->label_table_size);
+    if (code->label_table == NULL)
+    {
+        perror("Failed to allocate memory for the label table");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < code->label_table_size; i++)
+        code->label_table[i] = -1;
+
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        if (code->lines[i].label == NULL)
+            continue;
+
+        unsigned long slot = peephole_hash(code->lines[i].label) & (code->label_table_size - 1);
+        while (code->label_table[slot] != -1)
+            slot = (slot + 1) & (code->label_table_size - 1);
+        code->label_table[slot] = i;
+    }
+}
+
+// Returns the index of the line defining the label, -1 if it isn't defined
+int code_find_label(const Code* code, const char* label)
+{
+    unsigned long slot = peephole_hash(label) & (code->label_table_size - 1);
+    while (code->label_table[slot] != -1)
+    {
+        if (strcmp(code->lines[code->label_table[slot]].label, label) == 0)
+            return code->label_table[slot];
+        slot = (slot + 1) & (code->label_table_size - 1);
+    }
+    return -1;
+}
+
+static inline bool is_instruction(const Instruction* line)
+{
+    return ! line->is_removed && line->label == NULL;
+}
+
+static inline bool is_label(const Instruction* line)
+{
+    return ! line->is_removed && line->label != NULL;
+}
+
+bool is_branch(const char* opcode)
+{
+    static const char* branches[] = { "jump", "jumpt", "jumpf", "jeq", "jne", "jlt", "jle", "jgt", "jge" };
+    for (size_t i = 0; i < sizeof(branches) / sizeof(branches[0]); i++)
+    {
+        if (strcmp(opcode, branches[i]) == 0)
+            return true;
+    }
+    return false;
+}
+
+static inline bool has_label_operand(const Instruction* line)
+{
+    return is_instruction(line) && (is_branch(line->opcode) || strcmp(line->opcode, "prep") == 0);
+}
+
+// The execution never continues to the next line
+static inline bool is_unconditional(const Instruction* line)
+{
+    return is_instruction(line)
+        && (strcmp(line->opcode, "jump") == 0 || strcmp(line->opcode, "ret") == 0 || strcmp(line->opcode, "halt") == 0);
+}
+
+// Returns the index of the first instruction after the line, skipping the labels
+int code_next_instruction(const Code* code, int index)
+{
+    for (index = index + 1; index < code->nb_lines; index++)
+    {
+        if (is_instruction(&code->lines[index]))
+            break;
+    }
+    return index;
+}
+
+void instruction_set_operand(Instruction* instruction, const char* operand)
+{
+    char* copy = (operand != NULL) ? peephole_copy_string(operand) : NULL;
+    free(instruction->operand);
+    instruction->operand = copy;
+}
+
+// Passes
+
+// Jumps to one of the adjacent labels use the first one
+bool peephole_coalesce_labels(Code* code)
+{
+    bool has_changed = false;
+    const char** canonical_labels = calloc(code->nb_lines + (size_t) 1, sizeof(char*));
+    if (canonical_labels == NULL)
+    {
+        perror("Failed to allocate memory for the label coalescing");
+        exit(EXIT_FAILURE);
+    }
+
+    const char* first_label = NULL;
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        const Instruction* line = &code->lines[i];
+        if (is_label(line))
+        {
+            if (first_label == NULL)
+                first_label = line->label;
+            canonical_labels[i] = first_label;
+        }
+        else if (is_instruction(line))
+        {
+            first_label = NULL;
+        }
+    }
+
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        Instruction* line = &code->lines[i];
+        if ( ! has_label_operand(line))
+            continue;
+
+        int definition = code_find_label(code, line->operand);
+        if (definition != -1 && canonical_labels[definition] != NULL && strcmp(canonical_labels[definition], line->operand) != 0)
+        {
+            instruction_set_operand(line, canonical_labels[definition]);
+            has_changed = true;
+        }
+    }
+
+    free(canonical_labels);
+    return has_changed;
+}
+
+// A branch to a 'jump' goes directly to the final destination
+bool peephole_thread_jumps(Code* code)
+{
+    bool has_changed = false;
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        Instruction* line = &code->lines[i];
+        if ( ! is_instruction(line) || ! is_branch(line->opcode))
+            continue;
+
+        const char* target = line->operand;
+        for (int nb_hops = 0; nb_hops < code->nb_lines; nb_hops++) // Bounded because of infinite loops
+        {
+            int definition = code_find_label(code, target);
+            if (definition == -1)
+                break;
+
+            int next = code_next_instruction(code, definition);
+            if (next == code->nb_lines || strcmp(code->lines[next].opcode, "jump") != 0
+                || strcmp(code->lines[next].operand, target) == 0)
+                break;
+
+            target = code->lines[next].operand;
+        }
+
+        if (strcmp(target, line->operand) != 0)
+        {
+            instruction_set_operand(line, target);
+            has_changed = true;
+        }
+    }
+    return has_changed;
+}
+
+// A branch to the label that directly follows it has no effect on the control flow
+bool peephole_remove_jumps_to_next(Code* code)
+{
+    bool has_changed = false;
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        Instruction* line = &code->lines[i];
+        bool is_jump     = is_instruction(line) && strcmp(line->opcode, "jump") == 0;
+        bool is_pop_jump = is_instruction(line) && (strcmp(line->opcode, "jumpt") == 0 || strcmp(line->opcode, "jumpf") == 0);
+        if ( ! is_jump && ! is_pop_jump)
+            continue;
+
+        int next = code_next_instruction(code, i);
+        bool is_target_next = false;
+        for (int j = i + 1; j < next && ! is_target_next; j++)
+        {
+            is_target_next = is_label(&code->lines[j]) && strcmp(code->lines[j].label, line->operand) == 0;
+        }
+
+        if (is_target_next)
+        {
+            if (is_jump)
+            {
+                line->is_removed = true;
+            }
+            else
+            { // The tested value must still be popped
+                free(line->opcode);
+                line->opcode = peephole_copy_string("drop");
+                instruction_set_operand(line, NULL);
+            }
+            has_changed = true;
+        }
+    }
+    return has_changed;
+}
+
+const char* inverted_branch(const char* opcode)
+{
+    static const char* inverses[][2] =
+    {
+        { "jumpt", "jumpf" }, { "jeq", "jne" }, { "jlt", "jge" }, { "jle", "jgt" },
+    };
+    for (size_t i = 0; i < sizeof(inverses) / sizeof(inverses[0]); i++)
+    {
+        if (strcmp(opcode, inverses[i][0]) == 0)
+            return inverses[i][1];
+        if (strcmp(opcode, inverses[i][1]) == 0)
+            return inverses[i][0];
+    }
+    return NULL;
+}
+
+// A conditional branch over a 'jump' becomes the opposite branch to the target of the 'jump'
+bool peephole_invert_branches_over_jumps(Code* code)
+{
+    bool has_changed = false;
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        Instruction* line = &code->lines[i];
+        if ( ! is_instruction(line) || inverted_branch(line->opcode) == NULL)
+            continue;
+
+        // The 'jump' must directly follow the branch, without a label that other branches could target
+        int next = i + 1;
+        while (next < code->nb_lines && code->lines[next].is_removed)
+            next++;
+        if (next == code->nb_lines || ! is_instruction(&code->lines[next]) || strcmp(code->lines[next].opcode, "jump") != 0)
+            continue;
+
+        int after_jump = code_next_instruction(code, next);
+        bool is_target_after_jump = false;
+        for (int j = next + 1; j < after_jump && ! is_target_after_jump; j++)
+        {
+            is_target_after_jump = is_label(&code->lines[j]) && strcmp(code->lines[j].label, line->operand) == 0;
+        }
+
+        if (is_target_after_jump)
+        {
+            char* opcode = peephole_copy_string(inverted_branch(line->opcode));
+            free(line->opcode);
+            line->opcode = opcode;
+            instruction_set_operand(line, code->lines[next].operand);
+            code->lines[next].is_removed = true;
+            has_changed = true;
+        }
+    }
+    return has_changed;
+}
+
+// Instructions between an unconditional jump and the next label can't be reached
+bool peephole_remove_unreachable(Code* code)
+{
+    bool has_changed = false;
+    bool is_reachable = true;
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        Instruction* line = &code->lines[i];
+        if (is_label(line))
+        {
+            is_reachable = true;
+        }
+        else if (is_instruction(line))
+        {
+            if ( ! is_reachable)
+            {
+                line->is_removed = true;
+                has_changed = true;
+            }
+            else if (is_unconditional(line))
+            {
+                is_reachable = false;
+            }
+        }
+    }
+    return has_changed;
+}
+
+bool peephole_remove_unused_labels(Code* code)
+{
+    bool has_changed = false;
+    int* nb_references = calloc(code->nb_lines + (size_t) 1, sizeof(int));
+    if (nb_references == NULL)
+    {
+        perror("Failed to allocate memory for the label references");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        if (has_label_operand(&code->lines[i]))
+        {
+            int definition = code_find_label(code, code->lines[i].operand);
+            if (definition != -1)
+                nb_references[definition]++;
+        }
+    }
+
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        Instruction* line = &code->lines[i];
+        if (is_label(line) && nb_references[i] == 0 && strcmp(line->label, ENTRY_LABEL) != 0
+            && (code->kept_label == NULL || strcmp(line->label, code->kept_label) != 0))
+        {
+            line->is_removed = true;
+            has_changed = true;
+        }
+    }
+
+    free(nb_references);
+    return has_changed;
+}
+
+static inline bool is_opcode(const Instruction* line, const char* opcode)
+{
+    return line != NULL && is_instruction(line) && strcmp(line->opcode, opcode) == 0;
+}
+
+// Returns the line that directly follows the line in the straight-line code, NULL if it is a label or the end of the code
+Instruction* code_following_instruction(Code* code, int index)
+{
+    for (index = index + 1; index < code->nb_lines && code->lines[index].is_removed; index++)
+        ;
+    if (index == code->nb_lines || ! is_instruction(&code->lines[index]))
+        return NULL;
+    return &code->lines[index];
+}
+
+// Values stored then read again stay on the stack, values pushed only to be dropped aren't pushed
+bool peephole_schedule_stack(Code* code)
+{
+    bool has_changed = false;
+    for (int i = 0; i < code->nb_lines; i++)
+    {
+        Instruction* line = &code->lines[i];
+        if ( ! is_instruction(line))
+            continue;
+
+        Instruction* next = code_following_instruction(code, i);
+        if (next == NULL)
+            continue;
+
+        if (is_opcode(line, "set") && is_opcode(next, "get") && strcmp(line->operand, next->operand) == 0)
+        {
+            // set k, get k ----> dup, set k
+            free(line->opcode);
+            line->opcode = peephole_copy_string("dup");
+            instruction_set_operand(line, NULL);
+            free(next->opcode);
+            next->opcode = peephole_copy_string("set");
+            has_changed = true;
+        }
+        else if (is_opcode(next, "drop")
+                 && (is_opcode(line, "dup") || is_opcode(line, "push") || is_opcode(line, "get")))
+        {
+            // The pushed value is dropped right away
+            line->is_removed = true;
+            next->is_removed = true;
+            has_changed = true;
+        }
+        else if (is_opcode(line, "dup") && is_opcode(next, "set"))
+        {
+            // dup, set k, drop ----> set k
+            Instruction* after_set = code_following_instruction(code, (int) (next - code->lines));
+            if (is_opcode(after_set, "drop"))
+            {
+                line->is_removed      = true;
+                after_set->is_removed = true;
+                has_changed = true;
+            }
+        }
+    }
+    return has_changed;
+}
+
+void peephole_optimize(FILE* in_stream, FILE* out_stream, const char* kept_label, optimization_t optimizations)
+{
+    assert(in_stream != NULL && out_stream != NULL);
+
+    Code code = code_read(in_stream);
+    code.kept_label = kept_label;
+    code_index_labels(&code);
+
+    bool has_changed = true;
+    while (has_changed)
+    {
+        has_changed = false;
+        if (is_opti_enabled(optimizations, OPTI_JUMP_THREADING))
+        {
+            has_changed |= peephole_coalesce_labels(&code);
+            has_changed |= peephole_thread_jumps(&code);
+            has_changed |= peephole_remove_jumps_to_next(&code);
+            has_changed |= peephole_invert_branches_over_jumps(&code);
+            has_changed |= peephole_remove_unreachable(&code);
+            has_changed |= peephole_remove_unused_labels(&code);
+        }
+        if (is_opti_enabled(optimizations, OPTI_STACK_SCHEDULING))
+            has_changed |= peephole_schedule_stack(&code);
+    }
+
+    code_write(&code, out_stream);
+    code_free(&code);
+}
@@ -0,0 +1,12 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <stdio.h>
+
+#include "optimization.h"
+
+// Reads the generated msm code, runs the enabled optimizations on the instruction stream and writes the result.
+// The code can be a single function : its entry 'kept_label' is kept even if nothing in the code references it.
+void peephole_optimize(FILE* in_stream, FILE* out_stream, const char* kept_label, optimization_t optimizations);
+
+#endif // PEEPHOLE_H
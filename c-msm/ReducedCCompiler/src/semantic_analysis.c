@@ -12,11 +12,19 @@ void end_scope(SymbolTable* table);
 Symbol* declare(SymbolTable* table, SyntacticNode* declaration);
 Symbol* search(SymbolTable* table, char* name);
 Symbol symbol_create(int stack_offset, SyntacticNode* decl);
+// Declares the function or completes its prototype, returns its symbol if the node defines the function, NULL for a prototype or after an error
+static Symbol* declare_function(SyntacticNode* node, SymbolTable* table);
+// Adds the symbol to the current scope, the pointers to the symbols returned before are invalidated
+Symbol* symbol_table_append(SymbolTable* table, Symbol symbol);
 
 
 SymbolTable symbol_table_create()
 {
     SymbolTable table;
+    table.symbols           = NULL;
+    table.symbols_capacity  = 0;
+    table.global_index      = NULL;
+    table.global_index_size = 0;
     table.scopes[0]         = 0;
     table.nb_symbols        = 0;
     table.nb_glob_variables = 0;
@@ -25,20 +33,121 @@ SymbolTable symbol_table_create()
     table.nb_errors         = 0;
     table.nb_warnings       = 0;
 
-    // Fake nodes that hold the two I/O primitive functions
-    SyntacticNode* putchar_function = syntactic_node_create(NODE_FUNCTION, 0, 0); 
+    // Fake nodes that hold the I/O and memory primitive functions
+    SyntacticNode* putchar_function = syntactic_node_create(NODE_FUNCTION, 0, 0);
     putchar_function->value.str_val = "putchar";
-    table.symbols[table.nb_symbols] = symbol_create(NO_STACK_OFFSET, putchar_function);
-    table.symbols[table.nb_symbols++].nb_params = 1;
+    symbol_table_append(&table, symbol_create(NO_STACK_OFFSET, putchar_function))->nb_params = 1;
 
     SyntacticNode* getchar_function = syntactic_node_create(NODE_FUNCTION, 0, 0);
     getchar_function->value.str_val = "getchar";
-    table.symbols[table.nb_symbols] = symbol_create(NO_STACK_OFFSET, getchar_function);
-    table.symbols[table.nb_symbols++].nb_params = 0;
+    symbol_table_append(&table, symbol_create(NO_STACK_OFFSET, getchar_function))->nb_params = 0;
+
+    SyntacticNode* memset_function = syntactic_node_create(NODE_FUNCTION, 0, 0);
+    memset_function->value.str_val = "memset";
+    symbol_table_append(&table, symbol_create(NO_STACK_OFFSET, memset_function))->nb_params = 3;
+
+    SyntacticNode* memcpy_function = syntactic_node_create(NODE_FUNCTION, 0, 0);
+    memcpy_function->value.str_val = "memcpy";
+    symbol_table_append(&table, symbol_create(NO_STACK_OFFSET, memcpy_function))->nb_params = 3;
 
     return table;
 }
 
+void symbol_table_free(SymbolTable* table)
+{
+    assert(table != NULL);
+
+    // The primitive functions are the only declarations owned by the table
+    for (int i = 0; i < NB_PRIMITIVE_FUNCTIONS; i++)
+        syntactic_node_free(table->symbols[i].declaration);
+    free(table->symbols);
+    free(table->global_index);
+    table->symbols           = NULL;
+    table->symbols_capacity  = 0;
+    table->global_index      = NULL;
+    table->global_index_size = 0;
+    table->nb_symbols        = 0;
+}
+
+// FNV-1a
+static unsigned long symbol_hash(const char* name)
+{
+    unsigned long hash = 2166136261UL;
+    for (; *name != '\0'; name++)
+    {
+        hash ^= (unsigned char) *name;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// Returns the index of the global symbol with this name, -1 if there is none
+static int global_index_find(const SymbolTable* table, const char* name)
+{
+    if (table->global_index_size == 0)
+        return -1;
+
+    unsigned long slot = symbol_hash(name) & (table->global_index_size - 1);
+    while (table->global_index[slot] != -1)
+    {
+        int index = table->global_index[slot];
+        if (strcmp(name, table->symbols[index].declaration->value.str_val) == 0)
+            return index;
+        slot = (slot + 1) & (table->global_index_size - 1);
+    }
+    return -1;
+}
+
+static void global_index_insert(int* global_index, int global_index_size, const SymbolTable* table, int index)
+{
+    unsigned long slot = symbol_hash(table->symbols[index].declaration->value.str_val) & (global_index_size - 1);
+    while (global_index[slot] != -1)
+        slot = (slot + 1) & (global_index_size - 1);
+    global_index[slot] = index;
+}
+
+Symbol* symbol_table_append(SymbolTable* table, Symbol symbol)
+{
+    if (table->nb_symbols == table->symbols_capacity)
+    {
+        table->symbols_capacity = (table->symbols_capacity == 0) ? 64 : 2 * table->symbols_capacity;
+        Symbol* reallocated_symbols = realloc(table->symbols, sizeof(Symbol) * table->symbols_capacity);
+        if (reallocated_symbols == NULL)
+        {
+            perror("Failed to allocate memory for the symbol table");
+            exit(EXIT_FAILURE);
+        }
+        table->symbols = reallocated_symbols;
+    }
+    int index = table->nb_symbols++;
+    table->symbols[index] = symbol;
+
+    if (table->current_scope == 0)
+    {
+        // The index is kept at most half full, the global symbols are never removed
+        if (2 * table->nb_symbols > table->global_index_size)
+        {
+            int new_size = (table->global_index_size == 0) ? 64 : 2 * table->global_index_size;
+            int* new_index = malloc(sizeof(int) * new_size);
+            if (new_index == NULL)
+            {
+                perror("Failed to allocate memory for the symbol table");
+                exit(EXIT_FAILURE);
+            }
+            for (int i = 0; i < new_size; i++)
+                new_index[i] = -1;
+            for (int i = 0; i < index; i++)
+                global_index_insert(new_index, new_size, table, i);
+            free(table->global_index);
+            table->global_index      = new_index;
+            table->global_index_size = new_size;
+        }
+        global_index_insert(table->global_index, table->global_index_size, table, index);
+    }
+
+    return table->symbols + index;
+}
+
 Symbol symbol_create(int stack_offset, SyntacticNode* decl)
 {
     assert(decl != NULL);
@@ -95,6 +204,9 @@ void semantic_analysis(SyntacticNode* node, SymbolTable* table)
             else
             {
                 node->stack_offset = var_symbol->stack_offset;
+                // The elements of an array are not tracked, its storage exists as soon as it is declared
+                if (syntactic_node_is_flag_set(node, ARRAY_FLAG))
+                    symbol_set_flag(var_symbol, SET);
             }
 
             if (node->nb_children == 1)
@@ -129,7 +241,17 @@ void semantic_analysis(SyntacticNode* node, SymbolTable* table)
                     {
                         node->flags = ref_symbol->declaration->flags;
                         node->stack_offset = ref_symbol->stack_offset;
-                        if (node->parent->type == NODE_ASSIGNMENT && node->parent->children[0] == node) // node is the variable to which is assigned a value
+                        if (syntactic_node_is_flag_set(node, ARRAY_FLAG))
+                        {
+                            if (node->parent->type == NODE_ASSIGNMENT && node->parent->children[0] == node)
+                            {
+                                fprintf(stderr, "(%d:%d):error: assignment to array '%s'\n",
+                                    node->parent->line, node->parent->col, node->value.str_val);
+                                symbol_table_inc_error(table);
+                            }
+                            symbol_set_flag(ref_symbol, READ);
+                        }
+                        else if (node->parent->type == NODE_ASSIGNMENT && node->parent->children[0] == node) // node is the variable to which is assigned a value
                         {
                             if ( ! syntactic_node_is_flag_set(node, GLOBAL_FLAG))
                             {
@@ -204,18 +326,10 @@ void semantic_analysis(SyntacticNode* node, SymbolTable* table)
         }
         case NODE_FUNCTION :
         {
-            Symbol* function_symbol = declare(table, node);
-            if (function_symbol == NULL)
+            Symbol* function_symbol = declare_function(node, table);
+            if (function_symbol != NULL)
             {
-                fprintf(stderr, "(%d:%d):error: Redeclaration of symbol \"%s\".\n", node->line, node->col, node->value.str_val);
-                symbol_table_inc_error(table);
-            }
-            else
-            {
-                // NODE_FUNCTION always has a NODE_SEQUENCE for parameters at index 0
-                assert(node->children[0]->type == NODE_SEQUENCE);
                 int nb_parameters = node->children[0]->nb_children;
-                function_symbol->nb_params = nb_parameters;
                 table->nb_variables = 0;
                 start_scope(table);
 
@@ -287,7 +401,13 @@ void semantic_analysis(SyntacticNode* node, SymbolTable* table)
                 assert(ref_symbol != NULL);
                 assert(ref_symbol->declaration->type == NODE_DECL);
                 
-                if ( ! syntactic_node_is_flag_set(ref_node, CONST_FLAG))
+                if (syntactic_node_is_flag_set(ref_node, ARRAY_FLAG))
+                {
+                    fprintf(stderr, "(%d:%d):error: assignment to array '%s'\n",
+                        node->line, node->col, ref_node->value.str_val);
+                    symbol_table_inc_error(table);
+                }
+                else if ( ! syntactic_node_is_flag_set(ref_node, CONST_FLAG))
                     symbol_set_flag(ref_symbol, SET);
                 else
                 {
@@ -309,6 +429,69 @@ void semantic_analysis(SyntacticNode* node, SymbolTable* table)
     }
 }
 
+void semantic_analysis_declare_function(SyntacticNode* function, SymbolTable* table)
+{
+    assert(function != NULL && function->type == NODE_FUNCTION && table != NULL && table->current_scope == 0);
+
+    declare_function(function, table);
+}
+
+void semantic_analysis_check_definitions(SymbolTable* table)
+{
+    assert(table != NULL && table->current_scope == 0);
+
+    for (int i = NB_PRIMITIVE_FUNCTIONS; i < table->nb_symbols; i++)
+    {
+        const SyntacticNode* declaration = table->symbols[i].declaration;
+        if (syntactic_node_is_flag_set(declaration, EXTERN_FLAG))
+        {
+            fprintf(stderr, "(%d:%d):error: Symbol \"%s\" is declared but not defined, only an object file can import it.\n",
+                    declaration->line, declaration->col, declaration->value.str_val);
+            symbol_table_inc_error(table);
+        }
+    }
+}
+
+static Symbol* declare_function(SyntacticNode* node, SymbolTable* table)
+{
+    // NODE_FUNCTION always has a NODE_SEQUENCE for parameters at index 0
+    assert(node->children[0]->type == NODE_SEQUENCE);
+    int nb_parameters = node->children[0]->nb_children;
+    bool is_prototype = syntactic_node_is_flag_set(node, EXTERN_FLAG);
+
+    Symbol* function_symbol = declare(table, node);
+    if (function_symbol == NULL)
+    {
+        // A function can have several prototypes, a prototype is completed by the definition of its function
+        Symbol* declared_symbol = search(table, node->value.str_val);
+        bool is_declared_prototype = syntactic_node_is_flag_set(declared_symbol->declaration, EXTERN_FLAG);
+        if (declared_symbol->declaration->type == NODE_FUNCTION && (is_prototype || is_declared_prototype))
+        {
+            if (declared_symbol->nb_params != nb_parameters)
+            {
+                fprintf(stderr, "(%d:%d):error: Conflicting declaration of function \"%s()\", declared with %d parameters but %d given.\n",
+                        node->line, node->col, node->value.str_val, declared_symbol->nb_params, nb_parameters);
+                symbol_table_inc_error(table);
+                return NULL;
+            }
+            if (is_prototype)
+                return NULL;
+            declared_symbol->declaration = node;
+            function_symbol = declared_symbol;
+        }
+    }
+    if (function_symbol == NULL)
+    {
+        fprintf(stderr, "(%d:%d):error: Redeclaration of symbol \"%s\".\n", node->line, node->col, node->value.str_val);
+        symbol_table_inc_error(table);
+        return NULL;
+    }
+
+    // The parameters of a prototype are only counted
+    function_symbol->nb_params = nb_parameters;
+    return is_prototype ? NULL : function_symbol;
+}
+
 void start_scope(SymbolTable* table)
 {
     assert(table != NULL);
@@ -360,43 +543,63 @@ Symbol* declare(SymbolTable* table, SyntacticNode* declaration)
     assert(table != NULL && declaration != NULL);
 
     Symbol* declared_symbol = NULL;
-    int index = table->scopes[table->current_scope];
     bool found = false;
-    while (index < table->nb_symbols && !found)
+    if (table->current_scope == 0)
     {
-        found = strcmp(declaration->value.str_val, table->symbols[index].declaration->value.str_val) == 0;
-        index++;
+        found = global_index_find(table, declaration->value.str_val) != -1;
+    }
+    else
+    {
+        int index = table->scopes[table->current_scope];
+        while (index < table->nb_symbols && !found)
+        {
+            found = strcmp(declaration->value.str_val, table->symbols[index].declaration->value.str_val) == 0;
+            index++;
+        }
     }
     if (!found)
     {
-        declared_symbol = table->symbols + table->nb_symbols;
         switch (declaration->type)
         {
             case NODE_DECL:
             {
+                // The elements of an array are contiguous, its offset is the one of its lowest address :
+                // the first element for a global, the last one for a local since locals go down the stack
+                int nb_slots = syntactic_node_is_flag_set(declaration, ARRAY_FLAG) ? declaration->nb_var : 1;
+                // An extern variable only has an offset, which the linker replaces by the one of the definition
+                if (syntactic_node_is_flag_set(declaration, EXTERN_FLAG))
+                    nb_slots = 1;
+                int* nb_variables = syntactic_node_is_flag_set(declaration, GLOBAL_FLAG) ? &(table->nb_glob_variables) : &(table->nb_variables);
+                // Only the declaration whose variables overflow the memory reports it
+                if (*nb_variables <= MACHINE_MEMORY_SIZE && *nb_variables + nb_slots > MACHINE_MEMORY_SIZE)
+                {
+                    fprintf(stderr, "(%d:%d):error: %s variables exceed the %d cells of the memory with '%s'\n", declaration->line, declaration->col,
+                            syntactic_node_is_flag_set(declaration, GLOBAL_FLAG) ? "global" : "local", MACHINE_MEMORY_SIZE, declaration->value.str_val);
+                    symbol_table_inc_error(table);
+                }
+
                 if (syntactic_node_is_flag_set(declaration, GLOBAL_FLAG))
                 {
                     int offset = table->nb_glob_variables;
-                    *declared_symbol = symbol_create(offset, declaration);
-                    table->nb_glob_variables++;
+                    declared_symbol = symbol_table_append(table, symbol_create(offset, declaration));
+                    table->nb_glob_variables += nb_slots;
                 }
                 else
                 {
-                    int stack_offset = table->nb_variables;
-                    *declared_symbol = symbol_create(stack_offset, declaration);
-                    table->nb_variables++;
+                    int stack_offset = table->nb_variables + nb_slots - 1;
+                    declared_symbol = symbol_table_append(table, symbol_create(stack_offset, declaration));
+                    table->nb_variables += nb_slots;
                 }
                 break;
             }
             case NODE_FUNCTION:
             {
-                *declared_symbol = symbol_create(NO_STACK_OFFSET, declaration);
+                declared_symbol = symbol_table_append(table, symbol_create(NO_STACK_OFFSET, declaration));
                 break;
             }
             default: // Invalid type
                 assert(false); // Should never be reached
         }
-        table->nb_symbols++;
     }
 
     return declared_symbol;
@@ -406,18 +609,16 @@ Symbol* search(SymbolTable* table, char* name)
 {
     assert(table != NULL && name != NULL);
 
-    Symbol* symbol = NULL;
-    int index = table->nb_symbols - 1;
-    int found = 0;
-    while (index >= 0 && !found)
+    // The symbols of the opened scopes hide the global ones
+    if (table->current_scope > 0)
     {
-        found = strcmp(name, table->symbols[index].declaration->value.str_val) == 0;
-        index--;
-    }
-    if (found)
-    {
-        symbol = table->symbols + index + 1;
+        for (int index = table->nb_symbols - 1; index >= table->scopes[1]; index--)
+        {
+            if (strcmp(name, table->symbols[index].declaration->value.str_val) == 0)
+                return table->symbols + index;
+        }
     }
 
-    return symbol;
+    int global = global_index_find(table, name);
+    return (global == -1) ? NULL : table->symbols + global;
 }
@@ -30,25 +30,34 @@ static inline bool symbol_is_flag_set(Symbol* symbol, uint8_t flag)
     return (symbol->flags & flag) != 0;
 }
 
-#define MAX_SYMBOLS 500
+#define NB_PRIMITIVE_FUNCTIONS 4 // putchar, getchar, memset and memcpy, the first symbols of the table
 #define MAX_SCOPES  20
 #define MAX_SEMANTIC_ERROR 3 // If there are more than MAX_SEMANTIC_ERROR, we stop the semantic analysis
 
 typedef struct SymbolTable_s SymbolTable;
 struct SymbolTable_s
 {
-    Symbol symbols[MAX_SYMBOLS];
-    int    scopes[MAX_SCOPES + 1];
-    int    nb_symbols;
-    int    nb_glob_variables;
-    int    nb_variables;
-    int    current_scope;
-    int    nb_errors;
-    int    nb_warnings;
+    Symbol* symbols;            // The global symbols come first, then the symbols of the opened scopes
+    int     symbols_capacity;
+    int*    global_index;       // Open addressing hash table of the global symbols
+    int     global_index_size;  // Power of 2
+    int     scopes[MAX_SCOPES + 1];
+    int     nb_symbols;
+    int     nb_glob_variables;
+    int     nb_variables;
+    int     current_scope;
+    int     nb_errors;
+    int     nb_warnings;
 };
 
 SymbolTable symbol_table_create();
+void symbol_table_free(SymbolTable* table);
+// Analyses a whole program, or a single function or global declaration when the program is compiled one declaration at a time
 void semantic_analysis(SyntacticNode* tree, SymbolTable* table);
+// Declares the function without analysing its body, whose code is already generated
+void semantic_analysis_declare_function(SyntacticNode* function, SymbolTable* table);
+// Reports the prototypes and extern variables left undefined by a whole program, only an object file can import them
+void semantic_analysis_check_definitions(SymbolTable* table);
 void semantic_analysis_report_and_exit(const SymbolTable* table);
 
 #endif // SEMANTIC_ANALYSIS_H
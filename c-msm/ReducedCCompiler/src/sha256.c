@@ -0,0 +1,130 @@
+#include "sha256.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define READ_CHUNK_SIZE 65536
+
+static const uint32_t ROUND_CONSTANTS[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t rotate_right(uint32_t value, int count)
+{
+    return (value >> count) | (value << (32 - count));
+}
+
+static void sha256_compress(Sha256* sha, const unsigned char block[SHA256_BLOCK_SIZE])
+{
+    uint32_t schedule[64];
+    for (int i = 0; i < 16; i++)
+    {
+        schedule[i] = ((uint32_t) block[4 * i] << 24) | ((uint32_t) block[4 * i + 1] << 16)
+                    | ((uint32_t) block[4 * i + 2] << 8) | (uint32_t) block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = rotate_right(schedule[i - 15], 7) ^ rotate_right(schedule[i - 15], 18) ^ (schedule[i - 15] >> 3);
+        uint32_t s1 = rotate_right(schedule[i - 2], 17) ^ rotate_right(schedule[i - 2], 19) ^ (schedule[i - 2] >> 10);
+        schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+    }
+
+    uint32_t a = sha->state[0], b = sha->state[1], c = sha->state[2], d = sha->state[3];
+    uint32_t e = sha->state[4], f = sha->state[5], g = sha->state[6], h = sha->state[7];
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t s1     = rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25);
+        uint32_t choice = (e & f) ^ (~e & g);
+        uint32_t t1     = h + s1 + choice + ROUND_CONSTANTS[i] + schedule[i];
+        uint32_t s0     = rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22);
+        uint32_t major  = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2     = s0 + major;
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    sha->state[0] += a; sha->state[1] += b; sha->state[2] += c; sha->state[3] += d;
+    sha->state[4] += e; sha->state[5] += f; sha->state[6] += g; sha->state[7] += h;
+}
+
+void sha256_init(Sha256* sha)
+{
+    assert(sha != NULL);
+
+    static const uint32_t INITIAL_STATE[8] =
+    {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(sha->state, INITIAL_STATE, sizeof(INITIAL_STATE));
+    sha->length     = 0;
+    sha->block_size = 0;
+}
+
+void sha256_update(Sha256* sha, const void* bytes, size_t size)
+{
+    assert(sha != NULL && (bytes != NULL || size == 0));
+
+    const unsigned char* data = bytes;
+    sha->length += size;
+    if (sha->block_size > 0)
+    {
+        size_t nb_copied = SHA256_BLOCK_SIZE - sha->block_size;
+        if (nb_copied > size)
+            nb_copied = size;
+        memcpy(sha->block + sha->block_size, data, nb_copied);
+        sha->block_size += nb_copied;
+        data += nb_copied;
+        size -= nb_copied;
+        if (sha->block_size < SHA256_BLOCK_SIZE)
+            return;
+        sha256_compress(sha, sha->block);
+        sha->block_size = 0;
+    }
+    for (; size >= SHA256_BLOCK_SIZE; data += SHA256_BLOCK_SIZE, size -= SHA256_BLOCK_SIZE)
+        sha256_compress(sha, data);
+    memcpy(sha->block, data, size);
+    sha->block_size = size;
+}
+
+void sha256_update_file(Sha256* sha, FILE* file)
+{
+    assert(sha != NULL && file != NULL);
+
+    char chunk[READ_CHUNK_SIZE];
+    size_t nb_read;
+    while ((nb_read = fread(chunk, sizeof(char), sizeof(chunk), file)) > 0)
+        sha256_update(sha, chunk, nb_read);
+    rewind(file);
+}
+
+void sha256_final(Sha256* sha, unsigned char digest[SHA256_DIGEST_SIZE])
+{
+    assert(sha != NULL && digest != NULL);
+
+    // A 1 bit, zeros up to 8 bytes before the end of a block, then the length in bits
+    uint64_t bit_length = sha->length * 8;
+    static const unsigned char PADDING[SHA256_BLOCK_SIZE] = { 0x80 };
+    size_t padding_size = (sha->block_size < SHA256_BLOCK_SIZE - 8) ? SHA256_BLOCK_SIZE - 8 - sha->block_size
+                                                                     : 2 * SHA256_BLOCK_SIZE - 8 - sha->block_size;
+    sha256_update(sha, PADDING, padding_size);
+    unsigned char length[8];
+    for (int i = 0; i < 8; i++)
+        length[i] = (unsigned char) (bit_length >> (56 - 8 * i));
+    sha256_update(sha, length, sizeof(length));
+    assert(sha->block_size == 0);
+
+    for (int i = 0; i < 8; i++)
+    {
+        digest[4 * i]     = (unsigned char) (sha->state[i] >> 24);
+        digest[4 * i + 1] = (unsigned char) (sha->state[i] >> 16);
+        digest[4 * i + 2] = (unsigned char) (sha->state[i] >> 8);
+        digest[4 * i + 3] = (unsigned char) sha->state[i];
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+* SHA-256 (FIPS 180-4), the key of the compilation cache : unlike FNV-1a, a collision can't be built,
+* so a hit never gives the code of another program.
+* A context can be copied to hash several messages sharing a prefix.
+*/
+
+#define SHA256_DIGEST_SIZE 32
+#define SHA256_BLOCK_SIZE  64
+
+typedef struct Sha256_s Sha256;
+struct Sha256_s
+{
+    uint32_t      state[8];
+    uint64_t      length;                    // Number of bytes hashed so far
+    unsigned char block[SHA256_BLOCK_SIZE];  // Bytes waiting for a full block
+    size_t        block_size;
+};
+
+void sha256_init(Sha256* sha);
+void sha256_update(Sha256* sha, const void* bytes, size_t size);
+// Hashes the whole file then rewinds it
+void sha256_update_file(Sha256* sha, FILE* file);
+void sha256_final(Sha256* sha, unsigned char digest[SHA256_DIGEST_SIZE]);
+
+#endif // SHA256_H
@@ -0,0 +1,115 @@
+#include "source_buffer.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if !defined(_WIN32) && !defined(WIN32)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+
+    #define MAPPING_ENABLED 1
+    #if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+        #define MAP_ANONYMOUS MAP_ANON
+    #endif
+#endif
+
+#define READ_CHUNK_SIZE 65536
+
+#ifdef MAPPING_ENABLED
+/*
+* The file is mapped over the beginning of an area of zeroed anonymous pages one byte longer than the file :
+* the null terminator always follows the content, even when the size of the file is a multiple of the page size.
+*/
+static bool map_file(FILE* file, SourceBuffer* buffer)
+{
+    int fd = fileno(file);
+    struct stat status;
+    if (fd == -1 || fstat(fd, &status) == -1 || ! S_ISREG(status.st_mode) || status.st_size <= 0)
+        return false;
+
+    size_t size = (size_t) status.st_size;
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    size_t mapping_size = (size / page_size + 1) * page_size;
+
+    char* area = mmap(NULL, mapping_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED)
+        return false;
+    if (mmap(area, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(area, mapping_size);
+        return false;
+    }
+
+    buffer->content      = area;
+    buffer->size         = size;
+    buffer->mapping_size = mapping_size;
+    return true;
+}
+#endif
+
+// Streaming fallback : the content is read by chunks in a growing buffer
+static void read_file(FILE* file, SourceBuffer* buffer)
+{
+    size_t capacity = READ_CHUNK_SIZE;
+    buffer->content      = malloc(capacity + 1);
+    buffer->size         = 0;
+    buffer->mapping_size = 0;
+
+    while (buffer->content != NULL)
+    {
+        size_t nb_char_loaded = fread(buffer->content + buffer->size, sizeof(char), capacity - buffer->size, file);
+        buffer->size += nb_char_loaded;
+        if (buffer->size < capacity)
+            break;
+
+        capacity *= 2;
+        char* content = realloc(buffer->content, capacity + 1);
+        if (content == NULL)
+            free(buffer->content);
+        buffer->content = content;
+    }
+
+    if (buffer->content == NULL)
+    {
+        perror("Failed to allocate the buffer for the file content");
+        exit(EXIT_FAILURE);
+    }
+    if (ferror(file))
+    {
+        perror("Failed to read the content of the file");
+        exit(EXIT_FAILURE);
+    }
+    buffer->content[buffer->size] = '\0';
+}
+
+SourceBuffer source_buffer_load(FILE* file)
+{
+    assert(file != NULL);
+
+    SourceBuffer buffer;
+#ifdef MAPPING_ENABLED
+    if ( ! map_file(file, &buffer))
+#endif
+        read_file(file, &buffer);
+
+    fclose(file);
+    return buffer;
+}
+
+void source_buffer_free(SourceBuffer* buffer)
+{
+    assert(buffer != NULL);
+
+#ifdef MAPPING_ENABLED
+    if (buffer->mapping_size > 0)
+        munmap(buffer->content, buffer->mapping_size);
+    else
+#endif
+        free(buffer->content);
+
+    buffer->content = NULL;
+    buffer->size    = 0;
+}
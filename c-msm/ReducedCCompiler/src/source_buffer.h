@@ -0,0 +1,20 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+typedef struct SourceBuffer_s SourceBuffer;
+struct SourceBuffer_s
+{
+    char*  content;         // Null terminated content of the file
+    size_t size;            // Number of characters before the null terminator
+    size_t mapping_size;    // Size of the memory mapping of the file, 0 if the content is allocated
+};
+
+// Loads the content of the file and closes the FILE*
+// Regular files are mapped in memory without copy, the other streams (e.g. stdin) are read until their end
+SourceBuffer source_buffer_load(FILE* file);
+void source_buffer_free(SourceBuffer* buffer);
+
+#endif // SOURCE_BUFFER_H
@@ -0,0 +1,1040 @@
+#include "ssa.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "code_generation.h"
+
+typedef struct SsaLoop_s SsaLoop;
+struct SsaLoop_s
+{
+    SsaBlock* continue_block;
+    SsaBlock* break_block;
+    bool      is_continue_placed;
+};
+
+// State of the translation of a function from the analysed tree
+typedef struct SsaBuilder_s SsaBuilder;
+struct SsaBuilder_s
+{
+    SsaFunction*   function;
+    SsaBlock*      current;
+    SsaBlock*      tail_call_header; // Target of the self-recursive tail calls, NULL if there isn't any
+    SsaLoop*       loops;            // Enclosing loops, innermost last
+    int            nb_loops;
+    int            loops_capacity;
+    optimization_t optimizations;
+};
+
+SsaInstruction* ssa_build_expression(SsaBuilder* builder, const SyntacticNode* node);
+void ssa_build_statement(SsaBuilder* builder, const SyntacticNode* node);
+
+
+bool ssa_takes_local_address(const SyntacticNode* node)
+{
+    if (node->type == NODE_ADDRESS && ! syntactic_node_is_flag_set(node->children[0], GLOBAL_FLAG))
+        return true;
+    // The elements of a local array are accessed through their address
+    if (node->type == NODE_DECL && syntactic_node_is_flag_set(node, ARRAY_FLAG) && ! syntactic_node_is_flag_set(node, GLOBAL_FLAG))
+        return true;
+
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        if (ssa_takes_local_address(node->children[i]))
+            return true;
+    }
+    return false;
+}
+
+bool ssa_is_function_supported(const SyntacticNode* function)
+{
+    assert(function->type == NODE_FUNCTION);
+
+    // Variables whose address is taken must live in the frame
+    return ! ssa_takes_local_address(function);
+}
+
+// Helpers
+
+bool ssa_is_pure(int opcode)
+{
+    return opcode != SSA_PHI && opcode != SSA_PARAM && opcode != SSA_LOAD && opcode != SSA_STORE
+        && opcode != SSA_CALL && opcode != SSA_PRINT;
+}
+
+bool ssa_is_commutative(int opcode)
+{
+    return opcode == SSA_ADD || opcode == SSA_MUL || opcode == SSA_AND || opcode == SSA_OR
+        || opcode == SSA_BAND || opcode == SSA_BOR || opcode == SSA_BXOR || opcode == SSA_EQ || opcode == SSA_NE;
+}
+
+bool ssa_has_result(int opcode)
+{
+    return opcode != SSA_STORE && opcode != SSA_PRINT;
+}
+
+SsaInstruction* ssa_resolve(SsaInstruction* instruction)
+{
+    while (instruction != NULL && instruction->replacement != NULL)
+        instruction = instruction->replacement;
+    return instruction;
+}
+
+SsaBlock* ssa_new_block(SsaFunction* function)
+{
+    SsaBlock* block = calloc(1, sizeof(SsaBlock));
+    if (block == NULL)
+    {
+        perror("Failed to allocate memory for the SSA form");
+        exit(EXIT_FAILURE);
+    }
+    block->id                  = function->nb_blocks;
+    block->terminator          = SSA_NO_TERMINATOR;
+    block->rpo_index           = -1;
+    block->current_definitions = calloc(function->nb_variables + (size_t) 1, sizeof(SsaInstruction*));
+    block->incomplete_phis     = calloc(function->nb_variables + (size_t) 1, sizeof(SsaInstruction*));
+    if (block->current_definitions == NULL || block->incomplete_phis == NULL)
+    {
+        perror("Failed to allocate memory for the SSA form");
+        exit(EXIT_FAILURE);
+    }
+
+    SSA_APPEND(function->blocks, function->nb_blocks, function->blocks_capacity, block);
+    return block;
+}
+
+SsaInstruction* ssa_new_instruction(SsaFunction* function, SsaBlock* block, int opcode)
+{
+    SsaInstruction* instruction = calloc(1, sizeof(SsaInstruction));
+    if (instruction == NULL)
+    {
+        perror("Failed to allocate memory for the SSA form");
+        exit(EXIT_FAILURE);
+    }
+    instruction->id     = function->nb_instructions;
+    instruction->opcode = opcode;
+    instruction->block  = block;
+    instruction->slot   = -1;
+    SSA_APPEND(function->instructions, function->nb_instructions, function->instructions_capacity, instruction);
+
+    if (opcode == SSA_PHI)
+        SSA_APPEND(block->phis, block->nb_phis, block->phis_capacity, instruction);
+    else
+        SSA_APPEND(block->instructions, block->nb_instructions, block->instructions_capacity, instruction);
+
+    return instruction;
+}
+
+void ssa_add_operand(SsaInstruction* instruction, SsaInstruction* operand)
+{
+    assert(operand != NULL);
+    SSA_APPEND(instruction->operands, instruction->nb_operands, instruction->operands_capacity, operand);
+}
+
+SsaInstruction* ssa_function_add_const(SsaFunction* function, int value)
+{
+    SsaInstruction* constant = ssa_new_instruction(function, function->entry, SSA_CONST);
+    constant->value = value;
+    return constant;
+}
+
+SsaInstruction* ssa_insert_before(SsaFunction* function, SsaInstruction* position, int opcode)
+{
+    SsaBlock* block = position->block;
+    SsaInstruction* instruction = ssa_new_instruction(function, block, opcode);
+    assert(opcode != SSA_PHI && position->opcode != SSA_PHI);
+
+    // The new instruction was appended, the following ones are shifted
+    int index = block->nb_instructions - 1;
+    while (block->instructions[index - 1] != position)
+    {
+        block->instructions[index] = block->instructions[index - 1];
+        index--;
+    }
+    block->instructions[index]     = position;
+    block->instructions[index - 1] = instruction;
+    return instruction;
+}
+
+SsaInstruction* ssa_undef(SsaFunction* function)
+{
+    if (function->undef == NULL)
+        function->undef = ssa_new_instruction(function, function->entry, SSA_UNDEF);
+    return function->undef;
+}
+
+void ssa_add_edge(SsaBlock* from, SsaBlock* to)
+{
+    SSA_APPEND(to->predecessors, to->nb_predecessors, to->predecessors_capacity, from);
+}
+
+void ssa_remove_predecessor(SsaBlock* block, SsaBlock* predecessor)
+{
+    int index = 0;
+    while (index < block->nb_predecessors && block->predecessors[index] != predecessor)
+        index++;
+    assert(index < block->nb_predecessors);
+
+    for (int i = index; i < block->nb_predecessors - 1; i++)
+        block->predecessors[i] = block->predecessors[i + 1];
+    block->nb_predecessors--;
+
+    for (int i = 0; i < block->nb_phis; i++)
+    {
+        SsaInstruction* phi = block->phis[i];
+        assert(phi->nb_operands == block->nb_predecessors + 1);
+        for (int j = index; j < phi->nb_operands - 1; j++)
+            phi->operands[j] = phi->operands[j + 1];
+        phi->nb_operands--;
+    }
+}
+
+// Construction
+
+SsaBlock* ssa_builder_current(SsaBuilder* builder)
+{
+    // Code after a jump can't be reached, it goes to a block without predecessor
+    if (builder->current->terminator != SSA_NO_TERMINATOR)
+    {
+        builder->current = ssa_new_block(builder->function);
+        builder->current->is_sealed = true;
+    }
+    return builder->current;
+}
+
+SsaInstruction* ssa_emit(SsaBuilder* builder, int opcode)
+{
+    return ssa_new_instruction(builder->function, ssa_builder_current(builder), opcode);
+}
+
+SsaInstruction* ssa_emit_binary(SsaBuilder* builder, int opcode, SsaInstruction* lhs, SsaInstruction* rhs)
+{
+    SsaInstruction* instruction = ssa_emit(builder, opcode);
+    ssa_add_operand(instruction, lhs);
+    ssa_add_operand(instruction, rhs);
+    return instruction;
+}
+
+SsaInstruction* ssa_emit_const(SsaBuilder* builder, int value)
+{
+    SsaInstruction* constant = ssa_emit(builder, SSA_CONST);
+    constant->value = value;
+    return constant;
+}
+
+void ssa_jump(SsaBuilder* builder, SsaBlock* target)
+{
+    // Nothing to do if the control flow already left the block
+    if (builder->current->terminator != SSA_NO_TERMINATOR)
+        return;
+
+    builder->current->terminator    = SSA_JUMP;
+    builder->current->successors[0] = target;
+    ssa_add_edge(builder->current, target);
+}
+
+void ssa_branch(SsaBuilder* builder, SsaInstruction* condition, SsaBlock* if_true, SsaBlock* if_false)
+{
+    SsaBlock* block = ssa_builder_current(builder);
+    block->terminator       = SSA_BRANCH;
+    block->terminator_value = condition;
+    block->successors[0]    = if_true;
+    block->successors[1]    = if_false;
+    ssa_add_edge(block, if_true);
+    ssa_add_edge(block, if_false);
+}
+
+void ssa_return(SsaBuilder* builder, SsaInstruction* value)
+{
+    SsaBlock* block = ssa_builder_current(builder);
+    block->terminator       = SSA_RETURN;
+    block->terminator_value = value;
+}
+
+// Variables, see "Simple and Efficient Construction of Static Single Assignment Form" (Braun et al.)
+
+void ssa_write_variable(SsaBlock* block, int variable, SsaInstruction* value)
+{
+    block->current_definitions[variable] = value;
+}
+
+SsaInstruction* ssa_read_variable(SsaFunction* function, SsaBlock* block, int variable);
+
+SsaInstruction* ssa_try_remove_trivial_phi(SsaFunction* function, SsaInstruction* phi)
+{
+    SsaInstruction* same = NULL;
+    for (int i = 0; i < phi->nb_operands; i++)
+    {
+        SsaInstruction* operand = ssa_resolve(phi->operands[i]);
+        if (operand == same || operand == phi)
+            continue;
+        if (same != NULL)
+            return phi; // Merges at least two values
+        same = operand;
+    }
+    if (same == NULL)
+        same = ssa_undef(function); // Unreachable or only refers to itself
+
+    phi->replacement = same;
+    phi->is_removed  = true;
+    return same;
+}
+
+SsaInstruction* ssa_add_phi_operands(SsaFunction* function, int variable, SsaInstruction* phi)
+{
+    for (int i = 0; i < phi->block->nb_predecessors; i++)
+    {
+        ssa_add_operand(phi, ssa_read_variable(function, phi->block->predecessors[i], variable));
+    }
+    return ssa_try_remove_trivial_phi(function, phi);
+}
+
+SsaInstruction* ssa_read_variable(SsaFunction* function, SsaBlock* block, int variable)
+{
+    assert(0 <= variable && variable < function->nb_variables);
+
+    if (block->current_definitions[variable] != NULL)
+        return ssa_resolve(block->current_definitions[variable]);
+
+    SsaInstruction* value;
+    if ( ! block->is_sealed)
+    {
+        value = ssa_new_instruction(function, block, SSA_PHI);
+        block->incomplete_phis[variable] = value;
+    }
+    else if (block->nb_predecessors == 0)
+    {
+        value = ssa_undef(function);
+    }
+    else if (block->nb_predecessors == 1)
+    {
+        value = ssa_read_variable(function, block->predecessors[0], variable);
+    }
+    else
+    {
+        // The phi breaks the cycles of the loops
+        SsaInstruction* phi = ssa_new_instruction(function, block, SSA_PHI);
+        ssa_write_variable(block, variable, phi);
+        value = ssa_add_phi_operands(function, variable, phi);
+    }
+    ssa_write_variable(block, variable, value);
+    return value;
+}
+
+void ssa_seal_block(SsaFunction* function, SsaBlock* block)
+{
+    assert( ! block->is_sealed);
+
+    for (int variable = 0; variable < function->nb_variables; variable++)
+    {
+        if (block->incomplete_phis[variable] != NULL)
+        {
+            ssa_add_phi_operands(function, variable, block->incomplete_phis[variable]);
+            block->incomplete_phis[variable] = NULL;
+        }
+    }
+    block->is_sealed = true;
+}
+
+// Expressions and statements
+
+int ssa_binary_opcode(int node_type)
+{
+    switch (node_type)
+    {
+        case NODE_ADD:              return SSA_ADD;
+        case NODE_SUB:              return SSA_SUB;
+        case NODE_MUL:              return SSA_MUL;
+        case NODE_DIV:              return SSA_DIV;
+        case NODE_MOD:              return SSA_MOD;
+        case NODE_EQUAL:            return SSA_EQ;
+        case NODE_NOT_EQUAL:        return SSA_NE;
+        case NODE_LESS:             return SSA_LT;
+        case NODE_LESS_OR_EQUAL:    return SSA_LE;
+        case NODE_GREATER:          return SSA_GT;
+        case NODE_GREATER_OR_EQUAL: return SSA_GE;
+        case NODE_AND:              return SSA_AND;
+        case NODE_OR:               return SSA_OR;
+        case NODE_BITWISE_OR:       return SSA_BOR;
+        case NODE_BITWISE_XOR:      return SSA_BXOR;
+        case NODE_BITWISE_AND:      return SSA_BAND;
+        case NODE_LEFT_SHIFT:       return SSA_SHL;
+        case NODE_RIGHT_SHIFT:      return SSA_SHR;
+        default:                    return -1;
+    }
+}
+
+// Jumps to 'if_true' or to 'if_false' depending on the value of the condition
+void ssa_build_condition(SsaBuilder* builder, const SyntacticNode* condition, SsaBlock* if_true, SsaBlock* if_false)
+{
+    switch (condition->type)
+    {
+        case NODE_NEGATION:
+        {
+            ssa_build_condition(builder, condition->children[0], if_false, if_true);
+            break;
+        }
+        case NODE_AND:
+        case NODE_OR:
+        {
+            // The right operand is only evaluated if the left one doesn't decide
+            SsaBlock* right_operand = ssa_new_block(builder->function);
+            if (condition->type == NODE_AND)
+                ssa_build_condition(builder, condition->children[0], right_operand, if_false);
+            else
+                ssa_build_condition(builder, condition->children[0], if_true, right_operand);
+            ssa_seal_block(builder->function, right_operand);
+
+            builder->current = right_operand;
+            ssa_build_condition(builder, condition->children[1], if_true, if_false);
+            break;
+        }
+        case NODE_CONSTANT:
+        {
+            ssa_builder_current(builder);
+            ssa_jump(builder, condition->value.int_val ? if_true : if_false);
+            break;
+        }
+        default:
+        {
+            SsaInstruction* value = ssa_build_expression(builder, condition);
+            ssa_branch(builder, value, if_true, if_false);
+            break;
+        }
+    }
+}
+
+void ssa_build_assignment(SsaBuilder* builder, const SyntacticNode* target, SsaInstruction* value)
+{
+    if (target->type == NODE_REF && ! syntactic_node_is_flag_set(target, GLOBAL_FLAG))
+    {
+        ssa_write_variable(ssa_builder_current(builder), target->stack_offset, value);
+    }
+    else
+    {
+        SsaInstruction* address;
+        if (target->type == NODE_REF)
+        {
+            address = ssa_emit(builder, SSA_GLOBAL_ADDR);
+            address->value = target->stack_offset;
+        }
+        else
+        {
+            assert(target->type == NODE_DEREF);
+            address = ssa_build_expression(builder, target->children[0]);
+        }
+        ssa_emit_binary(builder, SSA_STORE, value, address);
+    }
+}
+
+SsaInstruction* ssa_build_expression(SsaBuilder* builder, const SyntacticNode* node)
+{
+    switch (node->type)
+    {
+        case NODE_CONSTANT:
+            return ssa_emit_const(builder, node->value.int_val);
+        case NODE_REF:
+        {
+            if ( ! syntactic_node_is_flag_set(node, GLOBAL_FLAG))
+                return ssa_read_variable(builder->function, ssa_builder_current(builder), node->stack_offset);
+
+            SsaInstruction* address = ssa_emit(builder, SSA_GLOBAL_ADDR);
+            address->value = node->stack_offset;
+            if (syntactic_node_is_flag_set(node, ARRAY_FLAG))
+                return address;
+            SsaInstruction* load = ssa_emit(builder, SSA_LOAD);
+            ssa_add_operand(load, address);
+            return load;
+        }
+        case NODE_ADDRESS:
+        {
+            assert(node->children[0]->type == NODE_REF && syntactic_node_is_flag_set(node->children[0], GLOBAL_FLAG));
+            SsaInstruction* address = ssa_emit(builder, SSA_GLOBAL_ADDR);
+            address->value = node->children[0]->stack_offset;
+            return address;
+        }
+        case NODE_DEREF:
+        case NODE_NEGATION:
+        case NODE_UNARY_MINUS:
+        case NODE_BITWISE_NOT:
+        {
+            SsaInstruction* operand = ssa_build_expression(builder, node->children[0]);
+            int opcode;
+            switch (node->type)
+            {
+                case NODE_DEREF:       opcode = SSA_LOAD; break;
+                case NODE_NEGATION:    opcode = SSA_NOT;  break;
+                case NODE_BITWISE_NOT: opcode = SSA_BNOT; break;
+                default:               opcode = SSA_NEG;  break;
+            }
+            SsaInstruction* instruction = ssa_emit(builder, opcode);
+            ssa_add_operand(instruction, operand);
+            return instruction;
+        }
+        case NODE_AND:
+        case NODE_OR:
+        {
+            if (is_opti_enabled(builder->optimizations, OPTI_LOGICAL_BRANCH) && is_eager_evaluable(node->children[1]))
+            {
+                SsaInstruction* lhs = ssa_build_expression(builder, node->children[0]);
+                SsaInstruction* rhs = ssa_build_expression(builder, node->children[1]);
+                return ssa_emit_binary(builder, ssa_binary_opcode(node->type), lhs, rhs);
+            }
+
+            // Short-circuit evaluation : the value is merged from the two outcomes
+            SsaBlock* if_true  = ssa_new_block(builder->function);
+            SsaBlock* if_false = ssa_new_block(builder->function);
+            SsaBlock* join     = ssa_new_block(builder->function);
+            ssa_build_condition(builder, node, if_true, if_false);
+            ssa_seal_block(builder->function, if_true);
+            ssa_seal_block(builder->function, if_false);
+
+            builder->current = if_true;
+            SsaInstruction* one = ssa_emit_const(builder, 1);
+            ssa_jump(builder, join);
+            builder->current = if_false;
+            SsaInstruction* zero = ssa_emit_const(builder, 0);
+            ssa_jump(builder, join);
+            ssa_seal_block(builder->function, join);
+
+            builder->current = join;
+            SsaInstruction* phi = ssa_new_instruction(builder->function, join, SSA_PHI);
+            for (int i = 0; i < join->nb_predecessors; i++)
+            {
+                ssa_add_operand(phi, (join->predecessors[i] == if_true) ? one : zero);
+            }
+            return phi;
+        }
+        case NODE_ASSIGNMENT:
+        {
+            SsaInstruction* value = ssa_build_expression(builder, node->children[1]);
+            ssa_build_assignment(builder, node->children[0], value);
+            return value;
+        }
+        case NODE_COMPOUND:
+        {
+            SsaInstruction* value = ssa_build_expression(builder, node->children[0]);
+            ssa_build_assignment(builder, node->children[0]->children[0], value);
+            return value;
+        }
+        case NODE_CALL:
+        {
+            const SyntacticNode* args = node->children[0];
+            SsaInstruction** values = calloc(args->nb_children + (size_t) 1, sizeof(SsaInstruction*));
+            if (values == NULL)
+            {
+                perror("Failed to allocate memory for the SSA form");
+                exit(EXIT_FAILURE);
+            }
+            for (int i = 0; i < args->nb_children; i++)
+            {
+                values[i] = ssa_build_expression(builder, args->children[i]);
+            }
+
+            SsaInstruction* call = ssa_emit(builder, SSA_CALL);
+            call->name = node->value.str_val;
+            for (int i = 0; i < args->nb_children; i++)
+            {
+                ssa_add_operand(call, values[i]);
+            }
+            free(values);
+            return call;
+        }
+        case NODE_INLINED_CALL:
+        {
+            ssa_build_statement(builder, node->children[0]);
+            return ssa_build_expression(builder, node->children[1]);
+        }
+        default:
+        {
+            int opcode = ssa_binary_opcode(node->type);
+            assert(opcode != -1 && node->nb_children == 2);
+            SsaInstruction* lhs = ssa_build_expression(builder, node->children[0]);
+            SsaInstruction* rhs = ssa_build_expression(builder, node->children[1]);
+            return ssa_emit_binary(builder, opcode, lhs, rhs);
+        }
+    }
+}
+
+void ssa_build_statement(SsaBuilder* builder, const SyntacticNode* node)
+{
+    SsaFunction* function = builder->function;
+
+    switch (node->type)
+    {
+        case NODE_SEQUENCE:
+        case NODE_BLOCK:
+        {
+            for (int i = 0; i < node->nb_children; i++)
+            {
+                ssa_build_statement(builder, node->children[i]);
+            }
+            break;
+        }
+        case NODE_DECL:
+        {
+            if (node->nb_children == 1)
+                ssa_build_expression(builder, node->children[0]);
+            break;
+        }
+        case NODE_DROP:
+        {
+            ssa_build_expression(builder, node->children[0]);
+            break;
+        }
+        case NODE_PRINT:
+        {
+            SsaInstruction* value = ssa_build_expression(builder, node->children[0]);
+            SsaInstruction* print = ssa_emit(builder, SSA_PRINT);
+            ssa_add_operand(print, value);
+            break;
+        }
+        case NODE_CONDITION:
+        case NODE_INVERTED_CONDITION:
+        {
+            int has_else = (node->nb_children == 3);
+            SsaBlock* then_block = ssa_new_block(function);
+            SsaBlock* end_block  = ssa_new_block(function);
+            SsaBlock* else_block = has_else ? ssa_new_block(function) : end_block;
+
+            // An inverted condition executes its code when the condition is false
+            if (node->type == NODE_CONDITION)
+                ssa_build_condition(builder, node->children[0], then_block, else_block);
+            else
+                ssa_build_condition(builder, node->children[0], else_block, then_block);
+            ssa_seal_block(function, then_block);
+
+            builder->current = then_block;
+            ssa_build_statement(builder, node->children[1]);
+            ssa_jump(builder, end_block);
+
+            if (has_else)
+            {
+                ssa_seal_block(function, else_block);
+                builder->current = else_block;
+                ssa_build_statement(builder, node->children[2]);
+                ssa_jump(builder, end_block);
+            }
+            ssa_seal_block(function, end_block);
+            builder->current = end_block;
+            break;
+        }
+        case NODE_LOOP:
+        {
+            SsaBlock* header = ssa_new_block(function);
+            SsaLoop loop = { ssa_new_block(function), ssa_new_block(function), false };
+            SSA_APPEND(builder->loops, builder->nb_loops, builder->loops_capacity, loop);
+
+            ssa_builder_current(builder);
+            ssa_jump(builder, header);
+            builder->current = header;
+            for (int i = 0; i < node->nb_children; i++)
+            {
+                ssa_build_statement(builder, node->children[i]);
+            }
+
+            loop = builder->loops[--builder->nb_loops];
+            if ( ! loop.is_continue_placed)
+            {
+                ssa_jump(builder, loop.continue_block);
+                builder->current = loop.continue_block;
+            }
+            ssa_jump(builder, header);
+
+            ssa_seal_block(function, loop.continue_block);
+            ssa_seal_block(function, header);
+            ssa_seal_block(function, loop.break_block);
+            builder->current = loop.break_block;
+            break;
+        }
+        case NODE_CONTINUE_LABEL:
+        {
+            SsaLoop* loop = &builder->loops[builder->nb_loops - 1];
+            ssa_jump(builder, loop->continue_block);
+            builder->current = loop->continue_block;
+            loop->is_continue_placed = true;
+            break;
+        }
+        case NODE_BREAK:
+        case NODE_CONTINUE:
+        {
+            assert(builder->nb_loops > 0);
+            SsaLoop* loop = &builder->loops[builder->nb_loops - 1];
+            ssa_builder_current(builder);
+            ssa_jump(builder, (node->type == NODE_BREAK) ? loop->break_block : loop->continue_block);
+            break;
+        }
+        case NODE_RETURN:
+        {
+            SsaInstruction* value = (node->nb_children > 0) ? ssa_build_expression(builder, node->children[0])
+                                                            : ssa_emit_const(builder, 0);
+            ssa_return(builder, value);
+            break;
+        }
+        case NODE_TAIL_CALL:
+        {
+            assert(builder->tail_call_header != NULL);
+            const SyntacticNode* args = node->children[0];
+            SsaInstruction** values = calloc(args->nb_children + (size_t) 1, sizeof(SsaInstruction*));
+            if (values == NULL)
+            {
+                perror("Failed to allocate memory for the SSA form");
+                exit(EXIT_FAILURE);
+            }
+            for (int i = 0; i < args->nb_children; i++)
+            {
+                values[i] = ssa_build_expression(builder, args->children[i]);
+            }
+            // The parameters are only overwritten once all the arguments are evaluated
+            for (int i = 0; i < args->nb_children; i++)
+            {
+                ssa_write_variable(ssa_builder_current(builder), i, values[i]);
+            }
+            free(values);
+            ssa_jump(builder, builder->tail_call_header);
+            break;
+        }
+        default:
+        {
+            ssa_build_expression(builder, node);
+            break;
+        }
+    }
+}
+
+SsaFunction* ssa_function_create(const SyntacticNode* function_node, optimization_t optimizations)
+{
+    assert(function_node->type == NODE_FUNCTION && ssa_is_function_supported(function_node));
+
+    SsaFunction* function = calloc(1, sizeof(SsaFunction));
+    if (function == NULL)
+    {
+        perror("Failed to allocate memory for the SSA form");
+        exit(EXIT_FAILURE);
+    }
+    function->name         = function_node->value.str_val;
+    function->nb_params    = function_node->children[0]->nb_children;
+    function->nb_variables = function->nb_params + function_node->nb_var;
+
+    SsaBuilder builder = { function, NULL, NULL, NULL, 0, 0, optimizations };
+    function->entry = ssa_new_block(function);
+    function->entry->is_sealed = true;
+    builder.current = function->entry;
+
+    for (int i = 0; i < function->nb_params; i++)
+    {
+        SsaInstruction* param = ssa_emit(&builder, SSA_PARAM);
+        param->value = i;
+        ssa_write_variable(function->entry, i, param);
+    }
+
+    // Self-recursive tail calls jump back after the parameters
+    if (syntactic_node_is_flag_set(function_node, TAIL_CALL_FLAG))
+    {
+        builder.tail_call_header = ssa_new_block(function);
+        ssa_jump(&builder, builder.tail_call_header);
+        builder.current = builder.tail_call_header;
+    }
+
+    ssa_build_statement(&builder, function_node->children[1]);
+    if (builder.current->terminator == SSA_NO_TERMINATOR)
+        ssa_return(&builder, ssa_emit_const(&builder, 0));
+
+    if (builder.tail_call_header != NULL)
+        ssa_seal_block(function, builder.tail_call_header);
+
+    for (int i = 0; i < function->nb_blocks; i++)
+    {
+        assert(function->blocks[i]->is_sealed);
+        free(function->blocks[i]->current_definitions);
+        free(function->blocks[i]->incomplete_phis);
+        function->blocks[i]->current_definitions = NULL;
+        function->blocks[i]->incomplete_phis     = NULL;
+    }
+    free(builder.loops);
+
+    ssa_apply_replacements(function);
+    ssa_remove_unreachable_blocks(function);
+    ssa_merge_blocks(function);
+
+    return function;
+}
+
+void ssa_function_free(SsaFunction* function)
+{
+    for (int i = 0; i < function->nb_instructions; i++)
+    {
+        free(function->instructions[i]->operands);
+        free(function->instructions[i]);
+    }
+    for (int i = 0; i < function->nb_blocks; i++)
+    {
+        SsaBlock* block = function->blocks[i];
+        free(block->phis);
+        free(block->instructions);
+        free(block->predecessors);
+        free(block->current_definitions);
+        free(block->incomplete_phis);
+        free(block);
+    }
+    free(function->instructions);
+    free(function->blocks);
+    free(function->rpo);
+    free(function);
+}
+
+// Cleanup
+
+void ssa_compact_instructions(SsaInstruction** instructions, int* nb_instructions)
+{
+    int nb_kept = 0;
+    for (int i = 0; i < *nb_instructions; i++)
+    {
+        if ( ! instructions[i]->is_removed)
+            instructions[nb_kept++] = instructions[i];
+    }
+    *nb_instructions = nb_kept;
+}
+
+void ssa_apply_replacements(SsaFunction* function)
+{
+    for (int i = 0; i < function->nb_blocks; i++)
+    {
+        SsaBlock* block = function->blocks[i];
+        if (block->is_removed)
+            continue;
+
+        for (int j = 0; j < block->nb_phis; j++)
+        {
+            SsaInstruction* phi = block->phis[j];
+            for (int k = 0; k < phi->nb_operands; k++)
+                phi->operands[k] = ssa_resolve(phi->operands[k]);
+        }
+        for (int j = 0; j < block->nb_instructions; j++)
+        {
+            SsaInstruction* instruction = block->instructions[j];
+            for (int k = 0; k < instruction->nb_operands; k++)
+                instruction->operands[k] = ssa_resolve(instruction->operands[k]);
+        }
+        block->terminator_value = ssa_resolve(block->terminator_value);
+
+        ssa_compact_instructions(block->phis, &block->nb_phis);
+        ssa_compact_instructions(block->instructions, &block->nb_instructions);
+    }
+}
+
+void ssa_compute_rpo(SsaFunction* function)
+{
+    free(function->rpo);
+    function->rpo    = malloc(sizeof(SsaBlock*) * (function->nb_blocks + (size_t) 1));
+    function->nb_rpo = 0;
+    // Iterative depth-first search : the stack holds the blocks and the next successor to visit
+    SsaBlock** stack         = malloc(sizeof(SsaBlock*) * (function->nb_blocks + (size_t) 1));
+    int*       next_successor = malloc(sizeof(int) * (function->nb_blocks + (size_t) 1));
+    bool*      is_visited    = calloc(function->nb_blocks + (size_t) 1, sizeof(bool));
+    if (function->rpo == NULL || stack == NULL || next_successor == NULL || is_visited == NULL)
+    {
+        perror("Failed to allocate memory for the SSA form");
+        exit(EXIT_FAILURE);
+    }
+
+    int nb_post_order = 0;
+    int stack_size = 0;
+    stack[stack_size] = function->entry;
+    next_successor[stack_size++] = 0;
+    is_visited[function->entry->id] = true;
+    while (stack_size > 0)
+    {
+        SsaBlock* block = stack[stack_size - 1];
+        int nb_successors = (block->terminator == SSA_BRANCH) ? 2 : (block->terminator == SSA_JUMP) ? 1 : 0;
+        if (next_successor[stack_size - 1] < nb_successors)
+        {
+            SsaBlock* successor = block->successors[next_successor[stack_size - 1]++];
+            if ( ! is_visited[successor->id])
+            {
+                is_visited[successor->id] = true;
+                stack[stack_size] = successor;
+                next_successor[stack_size++] = 0;
+            }
+        }
+        else
+        {
+            function->rpo[nb_post_order++] = block;
+            stack_size--;
+        }
+    }
+
+    // Reversed in place
+    for (int i = 0; i < nb_post_order / 2; i++)
+    {
+        SsaBlock* tmp = function->rpo[i];
+        function->rpo[i] = function->rpo[nb_post_order - 1 - i];
+        function->rpo[nb_post_order - 1 - i] = tmp;
+    }
+    function->nb_rpo = nb_post_order;
+
+    for (int i = 0; i < function->nb_blocks; i++)
+        function->blocks[i]->rpo_index = -1;
+    for (int i = 0; i < function->nb_rpo; i++)
+        function->rpo[i]->rpo_index = i;
+
+    free(stack);
+    free(next_successor);
+    free(is_visited);
+}
+
+void ssa_remove_unreachable_blocks(SsaFunction* function)
+{
+    ssa_compute_rpo(function);
+
+    for (int i = 0; i < function->nb_blocks; i++)
+    {
+        SsaBlock* block = function->blocks[i];
+        if (block->is_removed || block->rpo_index != -1)
+            continue;
+
+        int nb_successors = (block->terminator == SSA_BRANCH) ? 2 : (block->terminator == SSA_JUMP) ? 1 : 0;
+        for (int j = 0; j < nb_successors; j++)
+        {
+            if ( ! block->successors[j]->is_removed)
+                ssa_remove_predecessor(block->successors[j], block);
+        }
+        for (int j = 0; j < block->nb_phis; j++)
+            block->phis[j]->is_removed = true;
+        for (int j = 0; j < block->nb_instructions; j++)
+            block->instructions[j]->is_removed = true;
+        block->nb_phis         = 0;
+        block->nb_instructions = 0;
+        block->is_removed      = true;
+    }
+
+    ssa_remove_trivial_phis(function);
+}
+
+void ssa_remove_trivial_phis(SsaFunction* function)
+{
+    bool has_changed = true;
+    while (has_changed)
+    {
+        has_changed = false;
+        for (int i = 0; i < function->nb_blocks; i++)
+        {
+            SsaBlock* block = function->blocks[i];
+            for (int j = 0; ! block->is_removed && j < block->nb_phis; j++)
+            {
+                SsaInstruction* phi = block->phis[j];
+                if ( ! phi->is_removed && ssa_try_remove_trivial_phi(function, phi) != phi)
+                    has_changed = true;
+            }
+        }
+        ssa_apply_replacements(function);
+    }
+}
+
+// A block entered only from a block that always jumps to it is appended to this block
+void ssa_merge_blocks(SsaFunction* function)
+{
+    for (int i = 0; i < function->nb_blocks; i++)
+    {
+        SsaBlock* block = function->blocks[i];
+        while ( ! block->is_removed && block->terminator == SSA_JUMP)
+        {
+            SsaBlock* successor = block->successors[0];
+            if (successor == block || successor == function->entry || successor->nb_predecessors != 1)
+                break;
+            assert(successor->nb_phis == 0);
+
+            for (int j = 0; j < successor->nb_instructions; j++)
+            {
+                successor->instructions[j]->block = block;
+                SSA_APPEND(block->instructions, block->nb_instructions, block->instructions_capacity, successor->instructions[j]);
+            }
+            block->terminator       = successor->terminator;
+            block->terminator_value = successor->terminator_value;
+            block->successors[0]    = successor->successors[0];
+            block->successors[1]    = successor->successors[1];
+
+            int nb_successors = (block->terminator == SSA_BRANCH) ? 2 : (block->terminator == SSA_JUMP) ? 1 : 0;
+            for (int j = 0; j < nb_successors; j++)
+            {
+                SsaBlock* next = block->successors[j];
+                for (int k = 0; k < next->nb_predecessors; k++)
+                {
+                    if (next->predecessors[k] == successor)
+                    {
+                        next->predecessors[k] = block;
+                        break; // A branch with the same two targets is a predecessor twice
+                    }
+                }
+            }
+
+            successor->nb_instructions = 0;
+            successor->nb_predecessors = 0;
+            successor->terminator      = SSA_NO_TERMINATOR;
+            successor->is_removed      = true;
+        }
+    }
+}
+
+// Display
+
+const char* ssa_opcode_name(int opcode)
+{
+    static const char* names[] =
+    {
+        "const", "undef", "param", "phi", "global_addr",
+        "neg", "not", "bnot", "add", "sub", "mul", "div", "mod", "and", "or",
+        "shl", "shr", "band", "bor", "bxor",
+        "eq", "ne", "lt", "le", "gt", "ge",
+        "load", "store", "call", "print",
+    };
+    return names[opcode];
+}
+
+void ssa_instruction_display(const SsaInstruction* instruction, FILE* out_file)
+{
+    if (ssa_has_result(instruction->opcode))
+        fprintf(out_file, "    v%d = ", instruction->id);
+    else
+        fprintf(out_file, "    ");
+
+    fprintf(out_file, "%s", ssa_opcode_name(instruction->opcode));
+    if (instruction->opcode == SSA_CONST || instruction->opcode == SSA_PARAM || instruction->opcode == SSA_GLOBAL_ADDR)
+        fprintf(out_file, " %d", instruction->value);
+    if (instruction->opcode == SSA_CALL)
+        fprintf(out_file, " %s", instruction->name);
+    for (int i = 0; i < instruction->nb_operands; i++)
+        fprintf(out_file, "%s v%d", (i == 0) ? "" : ",", instruction->operands[i]->id);
+    fprintf(out_file, "\n");
+}
+
+void ssa_function_display(const SsaFunction* function, FILE* out_file)
+{
+    fprintf(out_file, "function %s\n", function->name);
+    for (int i = 0; i < function->nb_blocks; i++)
+    {
+        const SsaBlock* block = function->blocks[i];
+        if (block->is_removed)
+            continue;
+
+        fprintf(out_file, "  block %d (predecessors :", block->id);
+        for (int j = 0; j < block->nb_predecessors; j++)
+            fprintf(out_file, " %d", block->predecessors[j]->id);
+        fprintf(out_file, ")\n");
+
+        for (int j = 0; j < block->nb_phis; j++)
+            ssa_instruction_display(block->phis[j], out_file);
+        for (int j = 0; j < block->nb_instructions; j++)
+            ssa_instruction_display(block->instructions[j], out_file);
+
+        switch (block->terminator)
+        {
+            case SSA_JUMP:   fprintf(out_file, "    jump %d\n", block->successors[0]->id); break;
+            case SSA_BRANCH: fprintf(out_file, "    branch v%d, %d, %d\n", block->terminator_value->id,
+                                     block->successors[0]->id, block->successors[1]->id);      break;
+            case SSA_RETURN: fprintf(out_file, "    return v%d\n", block->terminator_value->id); break;
+            default:         fprintf(out_file, "    <no terminator>\n");                       break;
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#ifndef SSA_H
+#define SSA_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "syntactic_node.h"
+#include "optimization.h"
+
+/*
+* Mid-level representation of a function : a control flow graph of basic blocks
+* whose instructions are in static single assignment form.
+* Local variables are SSA values, phi instructions merge them at the join points,
+* globals and pointed memory are accessed with loads and stores.
+*/
+
+typedef struct SsaInstruction_s SsaInstruction;
+typedef struct SsaBlock_s SsaBlock;
+typedef struct SsaFunction_s SsaFunction;
+
+enum
+{
+    SSA_CONST,          // Integer constant
+    SSA_UNDEF,          // Variable read before being written
+    SSA_PARAM,          // Value of a parameter when the function is entered
+    SSA_PHI,            // Value from the predecessor the block is entered from, one operand per predecessor
+    SSA_GLOBAL_ADDR,    // Address of a global variable
+
+    // Pure operations
+    SSA_NEG,
+    SSA_NOT,
+    SSA_BNOT,
+    SSA_ADD,
+    SSA_SUB,
+    SSA_MUL,
+    SSA_DIV,
+    SSA_MOD,
+    SSA_AND,            // Logical operators whose operands are both evaluated
+    SSA_OR,
+    SSA_SHL,            // Shift count taken modulo 32, 'shr' is arithmetic
+    SSA_SHR,
+    SSA_BAND,           // Bitwise operators
+    SSA_BOR,
+    SSA_BXOR,
+    SSA_EQ,
+    SSA_NE,
+    SSA_LT,
+    SSA_LE,
+    SSA_GT,
+    SSA_GE,
+
+    // Memory and side effects
+    SSA_LOAD,           // Operand : address
+    SSA_STORE,          // Operands : value, address
+    SSA_CALL,           // Operands : arguments
+    SSA_PRINT,          // Operand : printed value
+};
+
+enum
+{
+    SSA_NO_TERMINATOR,  // Block under construction
+    SSA_JUMP,           // Goes to successors[0]
+    SSA_BRANCH,         // Goes to successors[0] if the condition is true, to successors[1] otherwise
+    SSA_RETURN,
+};
+
+struct SsaInstruction_s
+{
+    int              id;
+    int              opcode;
+    int              value;        // Constant value, index of the parameter or offset of the global
+    const char*      name;         // Called function
+    SsaInstruction** operands;
+    int              nb_operands;
+    int              operands_capacity;
+    SsaBlock*        block;
+    SsaInstruction*  replacement;  // Equivalent value that replaces the instruction
+    bool             is_removed;
+
+    // Lowering
+    int              nb_uses;
+    bool             is_sunk;      // Computed where its only use needs it instead of being stored in the frame
+    int              slot;         // Frame slot holding the value
+};
+
+struct SsaBlock_s
+{
+    int              id;
+    SsaInstruction** phis;
+    int              nb_phis;
+    int              phis_capacity;
+    SsaInstruction** instructions;
+    int              nb_instructions;
+    int              instructions_capacity;
+    int              terminator;
+    SsaInstruction*  terminator_value;    // Condition of a branch or returned value
+    SsaBlock*        successors[2];
+    SsaBlock**       predecessors;
+    int              nb_predecessors;
+    int              predecessors_capacity;
+    bool             is_removed;
+
+    // Construction
+    bool             is_sealed;           // All the predecessors are known
+    SsaInstruction** current_definitions; // Indexed by the stack offset of the variable
+    SsaInstruction** incomplete_phis;     // Phis waiting for the block to be sealed, indexed by variable
+
+    // Analysis
+    int              rpo_index;           // Index in reverse post-order, -1 if unreachable
+    SsaBlock*        immediate_dominator;
+};
+
+struct SsaFunction_s
+{
+    const char*      name;
+    int              nb_params;
+    int              nb_variables;        // Parameters and local variables of the analysed tree
+    SsaBlock*        entry;
+    SsaBlock**       blocks;
+    int              nb_blocks;
+    int              blocks_capacity;
+    SsaInstruction** instructions;        // Every instruction ever created, indexed by id
+    int              nb_instructions;
+    int              instructions_capacity;
+    SsaInstruction*  undef;
+    SsaBlock**       rpo;                 // Reachable blocks in reverse post-order
+    int              nb_rpo;
+    int              nb_slots;
+};
+
+#define SSA_APPEND(array, size, capacity, item)                                     \
+    do {                                                                            \
+        if ((size) == (capacity))                                                   \
+        {                                                                           \
+            (capacity) = ((capacity) == 0) ? 4 : 2 * (capacity);                    \
+            void* reallocated = realloc((array), sizeof(*(array)) * (capacity));    \
+            if (reallocated == NULL)                                                \
+            {                                                                       \
+                perror("Failed to allocate memory for the SSA form");               \
+                exit(EXIT_FAILURE);                                                 \
+            }                                                                       \
+            (array) = reallocated;                                                  \
+        }                                                                           \
+        (array)[(size)++] = (item);                                                 \
+    } while (0)
+
+// True if the function can be translated : the address of its local variables must never be taken
+bool ssa_is_function_supported(const SyntacticNode* function);
+// Builds the SSA form of a function that went through the semantic analysis
+SsaFunction* ssa_function_create(const SyntacticNode* function, optimization_t optimizations);
+void ssa_function_free(SsaFunction* function);
+void ssa_function_display(const SsaFunction* function, FILE* out_file);
+
+// Helpers shared by the passes
+bool ssa_is_pure(int opcode);
+bool ssa_is_commutative(int opcode);
+bool ssa_has_result(int opcode);
+SsaInstruction* ssa_resolve(SsaInstruction* instruction);
+// Replaces the operands by their replacement and removes the replaced instructions from the blocks
+void ssa_apply_replacements(SsaFunction* function);
+void ssa_remove_predecessor(SsaBlock* block, SsaBlock* predecessor);
+void ssa_compute_rpo(SsaFunction* function);
+void ssa_remove_unreachable_blocks(SsaFunction* function);
+void ssa_remove_trivial_phis(SsaFunction* function);
+void ssa_merge_blocks(SsaFunction* function);
+SsaInstruction* ssa_function_add_const(SsaFunction* function, int value);
+// Creates an instruction at the end of the block, phis are kept apart at the beginning of the block
+SsaInstruction* ssa_new_instruction(SsaFunction* function, SsaBlock* block, int opcode);
+void ssa_add_operand(SsaInstruction* instruction, SsaInstruction* operand);
+// Creates an instruction of the block of 'position', right before it
+SsaInstruction* ssa_insert_before(SsaFunction* function, SsaInstruction* position, int opcode);
+
+// Sparse conditional constant propagation, global value numbering, strength reduction and dead code elimination
+void ssa_function_optimize(SsaFunction* function, optimization_t optimizations);
+// Generates the msm code of the function
+void ssa_function_lower(SsaFunction* function, FILE* stream, int nb_global_variables, optimization_t optimizations);
+
+#endif // SSA_H
@@ -0,0 +1,600 @@
+#include "ssa.h"
+#include "code_generation.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+* The SSA values are scheduled on the stack : a value used once, by a later instruction of its block,
+* is computed right where it is used, as a subexpression of its user.
+* The other values are stored in a frame slot, the phis are copied on the edges of the graph.
+* Values whose live ranges don't overlap share their slot.
+*/
+
+// Emission of a block, either written to the stream or only recorded to check the order of the side effects
+typedef struct Emission_s Emission;
+struct Emission_s
+{
+    FILE*            stream;
+    int              nb_global_variables;
+    SsaInstruction** effects;       // Instructions with side effects in the order they are emitted
+    int              nb_effects;
+    bool             is_indexed_access;  // Loads and stores at a sunk 'base + index' use 'readx' and 'writex'
+};
+
+void ssa_lower_block(SsaFunction* function, SsaBlock* block, Emission* emission, optimization_t optimizations);
+
+static bool has_effect(int opcode)
+{
+    // Divisions can trap : they are kept in place relatively to the other side effects
+    return opcode == SSA_LOAD || opcode == SSA_STORE || opcode == SSA_CALL || opcode == SSA_PRINT
+        || opcode == SSA_DIV  || opcode == SSA_MOD;
+}
+
+static bool is_rematerialized(int opcode)
+{
+    return opcode == SSA_CONST || opcode == SSA_UNDEF || opcode == SSA_PARAM;
+}
+
+static const char* msm_instruction(int opcode)
+{
+    switch (opcode)
+    {
+        case SSA_ADD:   return "add";
+        case SSA_SUB:   return "sub";
+        case SSA_MUL:   return "mul";
+        case SSA_DIV:   return "div";
+        case SSA_MOD:   return "mod";
+        case SSA_NOT:   return "not";
+        case SSA_BNOT:  return "bnot";
+        case SSA_AND:   return "and";
+        case SSA_OR:    return "or";
+        case SSA_SHL:   return "shl";
+        case SSA_SHR:   return "shr";
+        case SSA_BAND:  return "band";
+        case SSA_BOR:   return "bor";
+        case SSA_BXOR:  return "bxor";
+        case SSA_EQ:    return "cmpeq";
+        case SSA_NE:    return "cmpne";
+        case SSA_LT:    return "cmplt";
+        case SSA_LE:    return "cmple";
+        case SSA_GT:    return "cmpgt";
+        case SSA_GE:    return "cmpge";
+        case SSA_LOAD:  return "read";
+        case SSA_STORE: return "write";
+        case SSA_PRINT: return "dbg";
+        default:        return NULL;
+    }
+}
+
+// Compare and branch instructions that jump when the comparison is false
+static const char* msm_inverted_branch(int opcode)
+{
+    switch (opcode)
+    {
+        case SSA_EQ: return "jne";
+        case SSA_NE: return "jeq";
+        case SSA_LT: return "jge";
+        case SSA_LE: return "jgt";
+        case SSA_GT: return "jle";
+        case SSA_GE: return "jlt";
+        default:     return NULL;
+    }
+}
+
+// Pushes the value of the instruction : computes its tree of sunk operands or reads it from its slot
+void ssa_emit_value(const SsaInstruction* instruction, Emission* emission, bool is_computed)
+{
+    FILE* stream = emission->stream;
+
+    if ( ! is_computed && ! instruction->is_sunk && ! is_rematerialized(instruction->opcode))
+    {
+        if (stream != NULL)
+        {
+            assert(instruction->slot >= 0);
+            fprintf(stream, "        get %d\n", instruction->slot);
+        }
+        return;
+    }
+
+    switch (instruction->opcode)
+    {
+        case SSA_CONST:
+        case SSA_UNDEF:
+        {
+            if (stream != NULL)
+                fprintf(stream, "        push %d\n", (instruction->opcode == SSA_CONST) ? instruction->value : 0);
+            return;
+        }
+        case SSA_PARAM:
+        {
+            if (stream != NULL)
+                fprintf(stream, "        get %d\n", instruction->value);
+            return;
+        }
+        case SSA_GLOBAL_ADDR:
+        {
+            // End of data segment address is stored in memory cell 0
+            if (stream != NULL)
+            {
+                fprintf(stream, "        push 0\n");
+                fprintf(stream, "        read\n");
+                generate_global_distance(stream, emission->nb_global_variables, instruction->value);
+                fprintf(stream, "        sub\n");
+            }
+            return;
+        }
+        case SSA_NEG:
+        {
+            if (stream != NULL)
+                fprintf(stream, "        push 0\n");
+            ssa_emit_value(instruction->operands[0], emission, false);
+            if (stream != NULL)
+                fprintf(stream, "        sub\n");
+            return;
+        }
+        case SSA_CALL:
+        {
+            if (stream != NULL)
+                fprintf(stream, "        prep %s\n", instruction->name);
+            for (int i = 0; i < instruction->nb_operands; i++)
+                ssa_emit_value(instruction->operands[i], emission, false);
+            if (stream != NULL)
+                fprintf(stream, "        call %d\n", instruction->nb_operands);
+            break;
+        }
+        case SSA_LOAD:
+        case SSA_STORE:
+        {
+            // The address is the last operand, the addition computing it is done by the indexed instruction
+            const SsaInstruction* address = instruction->operands[instruction->nb_operands - 1];
+            if (emission->is_indexed_access && address->is_sunk && address->opcode == SSA_ADD)
+            {
+                for (int i = 0; i < instruction->nb_operands - 1; i++)
+                    ssa_emit_value(instruction->operands[i], emission, false);
+                ssa_emit_value(address->operands[0], emission, false);
+                ssa_emit_value(address->operands[1], emission, false);
+                if (stream != NULL)
+                    fprintf(stream, "        %s\n", (instruction->opcode == SSA_LOAD) ? "readx" : "writex");
+                break;
+            }
+        }
+        // fall through
+        default:
+        {
+            assert(msm_instruction(instruction->opcode) != NULL);
+            for (int i = 0; i < instruction->nb_operands; i++)
+                ssa_emit_value(instruction->operands[i], emission, false);
+            if (stream != NULL)
+                fprintf(stream, "        %s\n", msm_instruction(instruction->opcode));
+            break;
+        }
+    }
+
+    if (has_effect(instruction->opcode))
+        emission->effects[emission->nb_effects++] = (SsaInstruction*) instruction;
+}
+
+// Copies the values of the phis of the successor, all the values are read before any of them is written
+void ssa_emit_phi_copies(const SsaBlock* from, const SsaBlock* to, Emission* emission)
+{
+    int predecessor_index = 0;
+    while (to->predecessors[predecessor_index] != from)
+        predecessor_index++;
+
+    for (int i = 0; i < to->nb_phis; i++)
+    {
+        const SsaInstruction* source = to->phis[i]->operands[predecessor_index];
+        if (source != to->phis[i])
+            ssa_emit_value(source, emission, false);
+    }
+    for (int i = to->nb_phis - 1; i >= 0; i--)
+    {
+        if (emission->stream != NULL && to->phis[i]->operands[predecessor_index] != to->phis[i])
+            fprintf(emission->stream, "        set %d\n", to->phis[i]->slot);
+    }
+}
+
+void ssa_lower_block(SsaFunction* function, SsaBlock* block, Emission* emission, optimization_t optimizations)
+{
+    FILE* stream = emission->stream;
+
+    for (int i = 0; i < block->nb_instructions; i++)
+    {
+        SsaInstruction* instruction = block->instructions[i];
+        if (instruction->is_sunk || is_rematerialized(instruction->opcode))
+            continue;
+
+        ssa_emit_value(instruction, emission, true);
+        if (stream != NULL && ssa_has_result(instruction->opcode))
+        {
+            if (instruction->slot >= 0)
+                fprintf(stream, "        set %d\n", instruction->slot);
+            else
+                fprintf(stream, "        drop\n");
+        }
+    }
+
+    switch (block->terminator)
+    {
+        case SSA_RETURN:
+        {
+            ssa_emit_value(block->terminator_value, emission, false);
+            if (stream != NULL)
+                fprintf(stream, "        ret\n");
+            break;
+        }
+        case SSA_JUMP:
+        {
+            ssa_emit_phi_copies(block, block->successors[0], emission);
+            if (stream != NULL)
+                fprintf(stream, "        jump %s.%d\n", function->name, block->successors[0]->id);
+            break;
+        }
+        case SSA_BRANCH:
+        {
+            SsaInstruction* condition = block->terminator_value;
+            const char* compare_and_branch = msm_inverted_branch(condition->opcode);
+            if (condition->is_sunk && compare_and_branch != NULL && is_opti_enabled(optimizations, OPTI_FUSED_BRANCH))
+            {
+                ssa_emit_value(condition->operands[0], emission, false);
+                ssa_emit_value(condition->operands[1], emission, false);
+            }
+            else
+            {
+                ssa_emit_value(condition, emission, false);
+                compare_and_branch = "jumpf";
+            }
+
+            if (stream != NULL)
+            {
+                // The copies of the phis are made on each edge
+                fprintf(stream, "        %s %s.%d.else\n", compare_and_branch, function->name, block->id);
+                ssa_emit_phi_copies(block, block->successors[0], emission);
+                fprintf(stream, "        jump %s.%d\n", function->name, block->successors[0]->id);
+                fprintf(stream, ".%s.%d.else\n", function->name, block->id);
+                ssa_emit_phi_copies(block, block->successors[1], emission);
+                fprintf(stream, "        jump %s.%d\n", function->name, block->successors[1]->id);
+            }
+            break;
+        }
+        default:
+            assert(false);
+    }
+}
+
+// Chooses the values computed where they are used, the side effects must stay in the same order
+void ssa_schedule_block(SsaFunction* function, SsaBlock* block, SsaInstruction** effects, optimization_t optimizations)
+{
+    int nb_original_effects = 0;
+    for (int i = 0; i < block->nb_instructions; i++)
+    {
+        SsaInstruction* instruction = block->instructions[i];
+        if (has_effect(instruction->opcode))
+            nb_original_effects++;
+
+        // The single use is the next instruction of the block that uses a value of the block
+        instruction->is_sunk = false;
+        if (is_rematerialized(instruction->opcode) || instruction->nb_uses != 1 || ! ssa_has_result(instruction->opcode))
+            continue;
+
+        const SsaInstruction* user = NULL;
+        for (int j = i + 1; j < block->nb_instructions && user == NULL; j++)
+        {
+            for (int k = 0; k < block->instructions[j]->nb_operands; k++)
+            {
+                if (block->instructions[j]->operands[k] == instruction)
+                    user = block->instructions[j];
+            }
+        }
+        instruction->is_sunk = (user != NULL || block->terminator_value == instruction);
+
+        // A value only copied to a phi of the next block is computed by the copy
+        if ( ! instruction->is_sunk && block->terminator == SSA_JUMP && is_opti_enabled(optimizations, OPTI_STACK_SCHEDULING))
+        {
+            const SsaBlock* successor = block->successors[0];
+            for (int j = 0; j < successor->nb_predecessors; j++)
+            {
+                for (int k = 0; successor->predecessors[j] == block && k < successor->nb_phis; k++)
+                    instruction->is_sunk |= (successor->phis[k]->operands[j] == instruction);
+            }
+        }
+    }
+
+    bool is_ordered = false;
+    while ( ! is_ordered)
+    {
+        Emission emission = { NULL, 0, effects, 0, false };
+        ssa_lower_block(function, block, &emission, optimizations);
+        assert(emission.nb_effects == nb_original_effects);
+
+        // The first side effect that comes too late was moved into its user, it gets its own slot instead
+        is_ordered = true;
+        int index = 0;
+        for (int i = 0; i < block->nb_instructions && is_ordered; i++)
+        {
+            SsaInstruction* instruction = block->instructions[i];
+            if ( ! has_effect(instruction->opcode))
+                continue;
+
+            if (effects[index++] != instruction)
+            {
+                assert(instruction->is_sunk);
+                instruction->is_sunk = false;
+                is_ordered = false;
+            }
+        }
+    }
+}
+
+// Allocation of the frame slots
+
+typedef struct SlotAllocation_s SlotAllocation;
+struct SlotAllocation_s
+{
+    int*               value_index;      // Index of the stored value of each instruction, -1 if it has no slot
+    SsaInstruction**   values;           // Stored values in the order of their definitions
+    int                nb_values;
+    int                nb_words;         // Words of a set of values
+    uint64_t*          live_in;          // Values live when each block is entered, the phis of the block included
+    int**              interferences;    // Values whose live range overlaps the one of each value
+    int*               nb_interferences;
+    int*               interferences_capacity;
+};
+
+static void* lowering_calloc(size_t nb_items, size_t item_size)
+{
+    void* memory = calloc(nb_items + 1, item_size);
+    if (memory == NULL)
+    {
+        perror("Failed to allocate memory for the lowering");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+static bool is_stored(const SsaInstruction* instruction)
+{
+    return ! instruction->is_sunk && ! is_rematerialized(instruction->opcode) && instruction->nb_uses > 0;
+}
+
+static void set_live(const SlotAllocation* allocation, uint64_t* live, const SsaInstruction* value, bool is_live)
+{
+    int index = allocation->value_index[value->id];
+    assert(index >= 0);
+    if (is_live)
+        live[index / 64] |= (uint64_t) 1 << (index % 64);
+    else
+        live[index / 64] &= ~((uint64_t) 1 << (index % 64));
+}
+
+// Adds the stored values read when the value is pushed, as ssa_emit_value() does
+static void add_reads(const SlotAllocation* allocation, const SsaInstruction* value, bool is_computed, uint64_t* live)
+{
+    if ( ! is_computed && is_stored(value))
+    {
+        set_live(allocation, live, value, true);
+        return;
+    }
+    if ( ! is_computed && ! value->is_sunk)
+        return;
+
+    for (int i = 0; i < value->nb_operands; i++)
+        add_reads(allocation, value->operands[i], false, live);
+}
+
+static void add_interferences(SlotAllocation* allocation, const SsaInstruction* value, const uint64_t* live)
+{
+    int index = allocation->value_index[value->id];
+    for (int word = 0; word < allocation->nb_words; word++)
+    {
+        for (uint64_t bits = live[word]; bits != 0; bits &= bits - 1)
+        {
+            int i = 64 * word;
+            while ( ! ((bits >> (i % 64)) & 1))
+                i++;
+            if (i == index)
+                continue;
+            SSA_APPEND(allocation->interferences[index], allocation->nb_interferences[index], allocation->interferences_capacity[index], i);
+            SSA_APPEND(allocation->interferences[i], allocation->nb_interferences[i], allocation->interferences_capacity[i], index);
+        }
+    }
+}
+
+// Computes the values live when the block is entered from the values live in its successors
+// The slot of a value written while another one is live must differ from the slot of the live one
+static void scan_block(SlotAllocation* allocation, const SsaBlock* block, uint64_t* live, uint64_t* edge_live, bool is_interfering)
+{
+    const int nb_successors = (block->terminator == SSA_JUMP) ? 1 : (block->terminator == SSA_BRANCH) ? 2 : 0;
+    memset(live, 0, sizeof(uint64_t) * allocation->nb_words);
+    for (int i = 0; i < nb_successors; i++)
+    {
+        const SsaBlock* successor = block->successors[i];
+        int predecessor_index = 0;
+        while (successor->predecessors[predecessor_index] != block)
+            predecessor_index++;
+
+        // The phis are written on the edge, once all their operands are read
+        memcpy(edge_live, allocation->live_in + (size_t) successor->rpo_index * allocation->nb_words, sizeof(uint64_t) * allocation->nb_words);
+        for (int j = 0; j < successor->nb_phis; j++)
+        {
+            const SsaInstruction* phi = successor->phis[j];
+            if (phi->operands[predecessor_index] != phi && is_stored(phi))
+                set_live(allocation, edge_live, phi, true);
+        }
+        for (int j = 0; is_interfering && j < successor->nb_phis; j++)
+        {
+            const SsaInstruction* phi = successor->phis[j];
+            if (phi->operands[predecessor_index] != phi && is_stored(phi))
+                add_interferences(allocation, phi, edge_live);
+        }
+        for (int j = 0; j < successor->nb_phis; j++)
+        {
+            const SsaInstruction* phi = successor->phis[j];
+            if (phi->operands[predecessor_index] != phi && is_stored(phi))
+                set_live(allocation, edge_live, phi, false);
+        }
+        for (int j = 0; j < successor->nb_phis; j++)
+        {
+            const SsaInstruction* phi = successor->phis[j];
+            if (phi->operands[predecessor_index] != phi)
+                add_reads(allocation, phi->operands[predecessor_index], false, edge_live);
+        }
+
+        for (int j = 0; j < allocation->nb_words; j++)
+            live[j] |= edge_live[j];
+    }
+
+    if (block->terminator_value != NULL)
+        add_reads(allocation, block->terminator_value, false, live);
+
+    for (int i = block->nb_instructions - 1; i >= 0; i--)
+    {
+        const SsaInstruction* instruction = block->instructions[i];
+        if (instruction->is_sunk || is_rematerialized(instruction->opcode))
+            continue;
+
+        if (is_stored(instruction))
+        {
+            if (is_interfering)
+                add_interferences(allocation, instruction, live);
+            set_live(allocation, live, instruction, false);
+        }
+        add_reads(allocation, instruction, true, live);
+    }
+}
+
+// The parameters keep their slots, the stored values get the first slot left by the values interfering with them
+void ssa_allocate_slots(SsaFunction* function)
+{
+    SlotAllocation allocation = { 0 };
+    allocation.value_index = lowering_calloc(function->nb_instructions, sizeof(int));
+    allocation.values      = lowering_calloc(function->nb_instructions, sizeof(SsaInstruction*));
+    for (int i = 0; i < function->nb_instructions; i++)
+    {
+        function->instructions[i]->slot = -1;
+        allocation.value_index[i] = -1;
+    }
+    for (int i = 0; i < function->nb_rpo; i++)
+    {
+        SsaBlock* block = function->rpo[i];
+        for (int j = 0; j < block->nb_phis + block->nb_instructions; j++)
+        {
+            SsaInstruction* instruction = (j < block->nb_phis) ? block->phis[j] : block->instructions[j - block->nb_phis];
+            if (is_stored(instruction))
+            {
+                allocation.value_index[instruction->id] = allocation.nb_values;
+                allocation.values[allocation.nb_values++] = instruction;
+            }
+        }
+    }
+
+    allocation.nb_words               = (allocation.nb_values + 63) / 64;
+    allocation.live_in                = lowering_calloc((size_t) function->nb_rpo * allocation.nb_words, sizeof(uint64_t));
+    allocation.interferences          = lowering_calloc(allocation.nb_values, sizeof(int*));
+    allocation.nb_interferences       = lowering_calloc(allocation.nb_values, sizeof(int));
+    allocation.interferences_capacity = lowering_calloc(allocation.nb_values, sizeof(int));
+    uint64_t* live      = lowering_calloc(allocation.nb_words, sizeof(uint64_t));
+    uint64_t* edge_live = lowering_calloc(allocation.nb_words, sizeof(uint64_t));
+
+    // Backward liveness, the blocks are visited in post-order until no live set grows
+    bool has_changed = true;
+    while (has_changed)
+    {
+        has_changed = false;
+        for (int i = function->nb_rpo - 1; i >= 0; i--)
+        {
+            scan_block(&allocation, function->rpo[i], live, edge_live, false);
+            uint64_t* live_in = allocation.live_in + (size_t) i * allocation.nb_words;
+            if (memcmp(live_in, live, sizeof(uint64_t) * allocation.nb_words) != 0)
+            {
+                memcpy(live_in, live, sizeof(uint64_t) * allocation.nb_words);
+                has_changed = true;
+            }
+        }
+    }
+    for (int i = 0; i < function->nb_rpo; i++)
+        scan_block(&allocation, function->rpo[i], live, edge_live, true);
+
+    // Slot taken by an interfering value, marked with the index of the value being allocated
+    int* is_taken_by = lowering_calloc(allocation.nb_values, sizeof(int));
+    for (int i = 0; i < allocation.nb_values; i++)
+        is_taken_by[i] = -1;
+    function->nb_slots = function->nb_params;
+    for (int i = 0; i < allocation.nb_values; i++)
+    {
+        for (int j = 0; j < allocation.nb_interferences[i]; j++)
+        {
+            const SsaInstruction* interfering = allocation.values[allocation.interferences[i][j]];
+            if (interfering->slot >= 0)
+                is_taken_by[interfering->slot - function->nb_params] = i;
+        }
+        int slot = 0;
+        while (is_taken_by[slot] == i)
+            slot++;
+        allocation.values[i]->slot = function->nb_params + slot;
+        if (allocation.values[i]->slot >= function->nb_slots)
+            function->nb_slots = allocation.values[i]->slot + 1;
+    }
+
+    for (int i = 0; i < allocation.nb_values; i++)
+        free(allocation.interferences[i]);
+    free(is_taken_by);
+    free(edge_live);
+    free(live);
+    free(allocation.interferences_capacity);
+    free(allocation.nb_interferences);
+    free(allocation.interferences);
+    free(allocation.live_in);
+    free(allocation.values);
+    free(allocation.value_index);
+}
+
+void ssa_function_lower(SsaFunction* function, FILE* stream, int nb_global_variables, optimization_t optimizations)
+{
+    ssa_compute_rpo(function);
+
+    for (int i = 0; i < function->nb_instructions; i++)
+        function->instructions[i]->nb_uses = 0;
+    for (int i = 0; i < function->nb_rpo; i++)
+    {
+        SsaBlock* block = function->rpo[i];
+        for (int j = 0; j < block->nb_phis + block->nb_instructions; j++)
+        {
+            SsaInstruction* instruction = (j < block->nb_phis) ? block->phis[j] : block->instructions[j - block->nb_phis];
+            for (int k = 0; k < instruction->nb_operands; k++)
+                instruction->operands[k]->nb_uses++;
+        }
+        if (block->terminator_value != NULL)
+            block->terminator_value->nb_uses++;
+    }
+
+    SsaInstruction** effects = calloc(function->nb_instructions + (size_t) 1, sizeof(SsaInstruction*));
+    if (effects == NULL)
+    {
+        perror("Failed to allocate memory for the lowering");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < function->nb_rpo; i++)
+        ssa_schedule_block(function, function->rpo[i], effects, optimizations);
+
+    ssa_allocate_slots(function);
+
+    fprintf(stream, ".%s\n", function->name);
+    if (function->nb_slots > function->nb_params)
+        fprintf(stream, "        resn %d\n", function->nb_slots - function->nb_params);
+    for (int i = 0; i < function->nb_rpo; i++)
+    {
+        SsaBlock* block = function->rpo[i];
+        if (block != function->entry)
+            fprintf(stream, ".%s.%d\n", function->name, block->id);
+
+        Emission emission = { stream, nb_global_variables, effects, 0, is_opti_enabled(optimizations, OPTI_INDEXED_ACCESS) };
+        ssa_lower_block(function, block, &emission, optimizations);
+    }
+
+    free(effects);
+}
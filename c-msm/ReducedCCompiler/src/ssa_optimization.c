@@ -0,0 +1,573 @@
+#include "ssa.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define GVN_TABLE_SIZE 1024 // Must be a power of 2
+
+void ssa_propagate_constants(SsaFunction* function);
+void ssa_number_values(SsaFunction* function);
+void ssa_reduce_strength(SsaFunction* function);
+void ssa_eliminate_dead_code(SsaFunction* function);
+
+void ssa_function_optimize(SsaFunction* function, optimization_t optimizations)
+{
+    ssa_propagate_constants(function);
+    ssa_merge_blocks(function);
+    ssa_number_values(function);
+    if (is_opti_enabled(optimizations, OPTI_STRENGTH_REDUCTION))
+        ssa_reduce_strength(function);
+    ssa_eliminate_dead_code(function);
+}
+
+static void* ssa_calloc(size_t nb_items, size_t item_size)
+{
+    void* memory = calloc(nb_items + 1, item_size);
+    if (memory == NULL)
+    {
+        perror("Failed to allocate memory for the SSA optimizations");
+        exit(EXIT_FAILURE);
+    }
+    return memory;
+}
+
+// Sparse conditional constant propagation, see "Constant propagation with conditional branches" (Wegman, Zadeck)
+
+enum { LATTICE_TOP, LATTICE_CONST, LATTICE_BOTTOM };
+
+typedef struct Lattice_s Lattice;
+struct Lattice_s
+{
+    int state;
+    int value;
+};
+
+static inline bool is_int(long long value)
+{
+    return INT_MIN <= value && value <= INT_MAX;
+}
+
+// Computes the result of an operation on constants, returns false if it can't be folded (overflow, division by zero)
+bool ssa_compute(int opcode, const int* operands, int* result)
+{
+    long long value;
+    switch (opcode)
+    {
+        case SSA_NEG: value = - (long long) operands[0];            break;
+        case SSA_NOT: value = ! operands[0];                        break;
+        case SSA_BNOT: value = ~ operands[0];                       break;
+        case SSA_ADD: value = (long long) operands[0] + operands[1]; break;
+        case SSA_SUB: value = (long long) operands[0] - operands[1]; break;
+        case SSA_MUL: value = (long long) operands[0] * operands[1]; break;
+        case SSA_AND: value = operands[0] && operands[1];           break;
+        case SSA_OR:  value = operands[0] || operands[1];           break;
+        case SSA_SHL: value = (int) ((unsigned) operands[0] << (operands[1] & 31)); break;
+        case SSA_SHR: value = operands[0] >> (operands[1] & 31);    break;
+        case SSA_BAND: value = operands[0] & operands[1];           break;
+        case SSA_BOR:  value = operands[0] | operands[1];           break;
+        case SSA_BXOR: value = operands[0] ^ operands[1];           break;
+        case SSA_EQ:  value = operands[0] == operands[1];           break;
+        case SSA_NE:  value = operands[0] != operands[1];           break;
+        case SSA_LT:  value = operands[0] <  operands[1];           break;
+        case SSA_LE:  value = operands[0] <= operands[1];           break;
+        case SSA_GT:  value = operands[0] >  operands[1];           break;
+        case SSA_GE:  value = operands[0] >= operands[1];           break;
+        case SSA_DIV:
+        case SSA_MOD:
+        {
+            if (operands[1] == 0 || (operands[0] == INT_MIN && operands[1] == -1))
+                return false;
+            value = (opcode == SSA_DIV) ? operands[0] / operands[1] : operands[0] % operands[1];
+            break;
+        }
+        default:
+            return false;
+    }
+
+    if ( ! is_int(value))
+        return false;
+
+    *result = (int) value;
+    return true;
+}
+
+Lattice ssa_evaluate(const SsaInstruction* instruction, const Lattice* lattices, bool* const* is_edge_executable)
+{
+    Lattice result = { LATTICE_BOTTOM, 0 };
+    switch (instruction->opcode)
+    {
+        case SSA_CONST:
+        case SSA_UNDEF: // Lowered as 0
+        {
+            result.state = LATTICE_CONST;
+            result.value = (instruction->opcode == SSA_CONST) ? instruction->value : 0;
+            return result;
+        }
+        case SSA_PHI:
+        {
+            // Only the values coming from the executable edges are merged
+            result.state = LATTICE_TOP;
+            for (int i = 0; i < instruction->nb_operands; i++)
+            {
+                if ( ! is_edge_executable[instruction->block->id][i])
+                    continue;
+
+                Lattice operand = lattices[instruction->operands[i]->id];
+                if (operand.state == LATTICE_TOP)
+                    continue;
+                if (operand.state == LATTICE_BOTTOM
+                    || (result.state == LATTICE_CONST && result.value != operand.value))
+                {
+                    result.state = LATTICE_BOTTOM;
+                    return result;
+                }
+                result = operand;
+            }
+            return result;
+        }
+        default:
+        {
+            if ( ! ssa_is_pure(instruction->opcode) || instruction->opcode == SSA_GLOBAL_ADDR)
+                return result;
+
+            int operands[2];
+            assert(instruction->nb_operands <= 2);
+            for (int i = 0; i < instruction->nb_operands; i++)
+            {
+                Lattice operand = lattices[instruction->operands[i]->id];
+                if (operand.state == LATTICE_BOTTOM)
+                    return result;
+                if (operand.state == LATTICE_TOP)
+                    result.state = LATTICE_TOP;
+                operands[i] = operand.value;
+            }
+            if (result.state == LATTICE_TOP)
+                return result;
+
+            if (ssa_compute(instruction->opcode, operands, &result.value))
+                result.state = LATTICE_CONST;
+            return result;
+        }
+    }
+}
+
+bool ssa_mark_edge_executable(SsaBlock* from, SsaBlock* to, bool* const* is_edge_executable, bool* is_block_executable)
+{
+    bool has_changed = ! is_block_executable[to->id];
+    is_block_executable[to->id] = true;
+    for (int i = 0; i < to->nb_predecessors; i++)
+    {
+        if (to->predecessors[i] == from && ! is_edge_executable[to->id][i])
+        {
+            is_edge_executable[to->id][i] = true;
+            has_changed = true;
+        }
+    }
+    return has_changed;
+}
+
+void ssa_propagate_constants(SsaFunction* function)
+{
+    ssa_compute_rpo(function);
+
+    Lattice* lattices           = ssa_calloc(function->nb_instructions, sizeof(Lattice));
+    bool*    is_block_executable = ssa_calloc(function->nb_blocks, sizeof(bool));
+    bool**   is_edge_executable  = ssa_calloc(function->nb_blocks, sizeof(bool*));
+    for (int i = 0; i < function->nb_blocks; i++)
+        is_edge_executable[i] = ssa_calloc(function->blocks[i]->nb_predecessors, sizeof(bool));
+
+    // The lattices only go down, the blocks are visited in reverse post-order until nothing changes
+    is_block_executable[function->entry->id] = true;
+    bool has_changed = true;
+    while (has_changed)
+    {
+        has_changed = false;
+        for (int i = 0; i < function->nb_rpo; i++)
+        {
+            SsaBlock* block = function->rpo[i];
+            if ( ! is_block_executable[block->id])
+                continue;
+
+            for (int j = 0; j < block->nb_phis + block->nb_instructions; j++)
+            {
+                SsaInstruction* instruction = (j < block->nb_phis) ? block->phis[j] : block->instructions[j - block->nb_phis];
+                Lattice lattice = ssa_evaluate(instruction, lattices, is_edge_executable);
+                Lattice* current = &lattices[instruction->id];
+                if (lattice.state != current->state || lattice.value != current->value)
+                {
+                    assert(lattice.state >= current->state);
+                    *current = lattice;
+                    has_changed = true;
+                }
+            }
+
+            if (block->terminator == SSA_JUMP)
+            {
+                has_changed |= ssa_mark_edge_executable(block, block->successors[0], is_edge_executable, is_block_executable);
+            }
+            else if (block->terminator == SSA_BRANCH)
+            {
+                Lattice condition = lattices[block->terminator_value->id];
+                for (int j = 0; j < 2; j++)
+                {
+                    bool is_taken = (condition.state == LATTICE_BOTTOM)
+                                 || (condition.state == LATTICE_CONST && (condition.value != 0) == (j == 0));
+                    if (is_taken)
+                        has_changed |= ssa_mark_edge_executable(block, block->successors[j], is_edge_executable, is_block_executable);
+                }
+            }
+        }
+    }
+
+    // Constant values are replaced, the branches on constants become jumps
+    for (int i = 0; i < function->nb_rpo; i++)
+    {
+        SsaBlock* block = function->rpo[i];
+        if ( ! is_block_executable[block->id])
+            continue;
+
+        // The new constants are added to the entry block, they aren't visited
+        int nb_values = block->nb_phis + block->nb_instructions;
+        for (int j = 0; j < nb_values; j++)
+        {
+            SsaInstruction* instruction = (j < block->nb_phis) ? block->phis[j] : block->instructions[j - block->nb_phis];
+            if (lattices[instruction->id].state == LATTICE_CONST && instruction->opcode != SSA_CONST
+                && (instruction->opcode == SSA_PHI || ssa_is_pure(instruction->opcode)))
+            {
+                instruction->replacement = ssa_function_add_const(function, lattices[instruction->id].value);
+                instruction->is_removed  = true;
+            }
+        }
+
+        Lattice condition = (block->terminator == SSA_BRANCH) ? lattices[block->terminator_value->id]
+                                                              : (Lattice) { LATTICE_BOTTOM, 0 };
+        if (condition.state == LATTICE_CONST)
+        {
+            int taken = (condition.value != 0) ? 0 : 1;
+            ssa_remove_predecessor(block->successors[1 - taken], block);
+            block->successors[0]    = block->successors[taken];
+            block->successors[1]    = NULL;
+            block->terminator       = SSA_JUMP;
+            block->terminator_value = NULL;
+        }
+    }
+
+    for (int i = 0; i < function->nb_blocks; i++)
+        free(is_edge_executable[i]);
+    free(is_edge_executable);
+    free(is_block_executable);
+    free(lattices);
+
+    ssa_apply_replacements(function);
+    ssa_remove_unreachable_blocks(function);
+}
+
+// Global value numbering : a pure instruction is replaced by an equivalent one that dominates it
+
+void ssa_compute_dominators(SsaFunction* function)
+{
+    // See "A Simple, Fast Dominance Algorithm" (Cooper, Harvey, Kennedy)
+    ssa_compute_rpo(function);
+    for (int i = 0; i < function->nb_blocks; i++)
+        function->blocks[i]->immediate_dominator = NULL;
+    function->entry->immediate_dominator = function->entry;
+
+    bool has_changed = true;
+    while (has_changed)
+    {
+        has_changed = false;
+        for (int i = 1; i < function->nb_rpo; i++)
+        {
+            SsaBlock* block = function->rpo[i];
+            SsaBlock* dominator = NULL;
+            for (int j = 0; j < block->nb_predecessors; j++)
+            {
+                SsaBlock* predecessor = block->predecessors[j];
+                if (predecessor->immediate_dominator == NULL)
+                    continue;
+                if (dominator == NULL)
+                {
+                    dominator = predecessor;
+                    continue;
+                }
+
+                // Intersection of the two paths in the dominator tree
+                SsaBlock* finger = predecessor;
+                while (finger != dominator)
+                {
+                    while (finger->rpo_index > dominator->rpo_index)
+                        finger = finger->immediate_dominator;
+                    while (dominator->rpo_index > finger->rpo_index)
+                        dominator = dominator->immediate_dominator;
+                }
+            }
+            if (block->immediate_dominator != dominator)
+            {
+                block->immediate_dominator = dominator;
+                has_changed = true;
+            }
+        }
+    }
+}
+
+bool ssa_dominates(const SsaBlock* dominator, const SsaBlock* block)
+{
+    while (block != dominator && block->immediate_dominator != block)
+        block = block->immediate_dominator;
+    return block == dominator;
+}
+
+// Operands of the commutative operations are ordered to find more equivalences
+void ssa_ordered_operands(const SsaInstruction* instruction, SsaInstruction** operands)
+{
+    operands[0] = instruction->operands[0];
+    operands[1] = (instruction->nb_operands > 1) ? instruction->operands[1] : NULL;
+    if (ssa_is_commutative(instruction->opcode) && operands[0]->id > operands[1]->id)
+    {
+        SsaInstruction* tmp = operands[0];
+        operands[0] = operands[1];
+        operands[1] = tmp;
+    }
+}
+
+uint32_t ssa_value_hash(const SsaInstruction* instruction)
+{
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ (uint32_t) instruction->opcode) * 16777619u;
+    hash = (hash ^ (uint32_t) instruction->value) * 16777619u;
+    if (instruction->nb_operands > 0)
+    {
+        SsaInstruction* operands[2];
+        ssa_ordered_operands(instruction, operands);
+        for (int i = 0; i < instruction->nb_operands; i++)
+            hash = (hash ^ (uint32_t) operands[i]->id) * 16777619u;
+    }
+    return hash;
+}
+
+bool ssa_values_equal(const SsaInstruction* instruction1, const SsaInstruction* instruction2)
+{
+    if (instruction1->opcode != instruction2->opcode || instruction1->nb_operands != instruction2->nb_operands)
+        return false;
+    if ((instruction1->opcode == SSA_CONST || instruction1->opcode == SSA_GLOBAL_ADDR)
+        && instruction1->value != instruction2->value)
+        return false;
+    if (instruction1->nb_operands == 0)
+        return true;
+
+    SsaInstruction* operands1[2];
+    SsaInstruction* operands2[2];
+    ssa_ordered_operands(instruction1, operands1);
+    ssa_ordered_operands(instruction2, operands2);
+    for (int i = 0; i < instruction1->nb_operands; i++)
+    {
+        if (operands1[i] != operands2[i])
+            return false;
+    }
+    return true;
+}
+
+typedef struct ValueEntry_s ValueEntry;
+struct ValueEntry_s
+{
+    SsaInstruction* instruction;
+    ValueEntry*     next;
+};
+
+void ssa_number_values(SsaFunction* function)
+{
+    ssa_compute_dominators(function);
+
+    ValueEntry** table   = ssa_calloc(GVN_TABLE_SIZE, sizeof(ValueEntry*));
+    ValueEntry*  entries = ssa_calloc(function->nb_instructions, sizeof(ValueEntry));
+    int nb_entries = 0;
+
+    // In reverse post-order the dominators are visited first
+    for (int i = 0; i < function->nb_rpo; i++)
+    {
+        SsaBlock* block = function->rpo[i];
+        for (int j = 0; j < block->nb_instructions; j++)
+        {
+            SsaInstruction* instruction = block->instructions[j];
+            if ( ! ssa_is_pure(instruction->opcode) || instruction->opcode == SSA_UNDEF)
+                continue;
+
+            for (int k = 0; k < instruction->nb_operands; k++)
+                instruction->operands[k] = ssa_resolve(instruction->operands[k]);
+
+            uint32_t index = ssa_value_hash(instruction) & (GVN_TABLE_SIZE - 1);
+            SsaInstruction* equivalent = NULL;
+            for (ValueEntry* entry = table[index]; entry != NULL && equivalent == NULL; entry = entry->next)
+            {
+                if (ssa_values_equal(entry->instruction, instruction) && ssa_dominates(entry->instruction->block, block))
+                    equivalent = entry->instruction;
+            }
+
+            if (equivalent != NULL)
+            {
+                instruction->replacement = equivalent;
+                instruction->is_removed  = true;
+            }
+            else
+            {
+                ValueEntry* entry = &entries[nb_entries++];
+                entry->instruction = instruction;
+                entry->next        = table[index];
+                table[index]       = entry;
+            }
+        }
+    }
+
+    free(entries);
+    free(table);
+
+    ssa_apply_replacements(function);
+    ssa_remove_trivial_phis(function);
+}
+
+// Strength reduction : operations by a power of two are replaced by cheaper bitwise ones
+
+// Returns k if the value is the constant 2^k with k >= 1, -1 otherwise
+int ssa_power_of_two_exponent(const SsaInstruction* instruction)
+{
+    if (instruction->opcode != SSA_CONST || instruction->value < 2 || (instruction->value & (instruction->value - 1)) != 0)
+        return -1;
+
+    int exponent = 0;
+    while ((1 << exponent) != instruction->value)
+        exponent++;
+    return exponent;
+}
+
+// Returns 'x & (2^k - 1)' if the value is 'x % 2^k' : both are zero for the same values of x, whatever its sign.
+// The mask is computed before 'position', at the end of the block if it is NULL.
+SsaInstruction* ssa_reduce_tested_value(SsaFunction* function, SsaInstruction* value, SsaBlock* block, SsaInstruction* position)
+{
+    if (value->opcode != SSA_MOD || ssa_power_of_two_exponent(value->operands[1]) == -1)
+        return value;
+
+    SsaInstruction* mask = (position != NULL) ? ssa_insert_before(function, position, SSA_BAND)
+                                              : ssa_new_instruction(function, block, SSA_BAND);
+    ssa_add_operand(mask, value->operands[0]);
+    ssa_add_operand(mask, ssa_function_add_const(function, value->operands[1]->value - 1));
+    return mask;
+}
+
+void ssa_reduce_strength(SsaFunction* function)
+{
+    ssa_compute_rpo(function);
+    for (int i = 0; i < function->nb_rpo; i++)
+    {
+        SsaBlock* block = function->rpo[i];
+        for (int j = 0; j < block->nb_instructions; j++)
+        {
+            SsaInstruction* instruction = block->instructions[j];
+            switch (instruction->opcode)
+            {
+                case SSA_MUL:
+                {
+                    // x * 2^k ----> x << k
+                    for (int k = 0; k < 2; k++)
+                    {
+                        int exponent = ssa_power_of_two_exponent(instruction->operands[k]);
+                        if (exponent != -1)
+                        {
+                            instruction->opcode      = SSA_SHL;
+                            instruction->operands[0] = instruction->operands[1 - k];
+                            instruction->operands[1] = ssa_function_add_const(function, exponent);
+                            break;
+                        }
+                    }
+                    break;
+                }
+                case SSA_EQ:
+                case SSA_NE:
+                {
+                    // x % 2^k == 0 ----> (x & (2^k - 1)) == 0
+                    for (int k = 0; k < 2; k++)
+                    {
+                        SsaInstruction* other = instruction->operands[1 - k];
+                        if (other->opcode == SSA_CONST && other->value == 0)
+                            instruction->operands[k] = ssa_reduce_tested_value(function, instruction->operands[k], block, instruction);
+                    }
+                    break;
+                }
+                case SSA_NOT:
+                {
+                    instruction->operands[0] = ssa_reduce_tested_value(function, instruction->operands[0], block, instruction);
+                    break;
+                }
+            }
+            // The instructions inserted before are skipped
+            while (block->instructions[j] != instruction)
+                j++;
+        }
+
+        if (block->terminator == SSA_BRANCH)
+            block->terminator_value = ssa_reduce_tested_value(function, block->terminator_value, block, NULL);
+    }
+}
+
+// Dead code elimination : only the values needed by the side effects and the control flow are kept
+
+void ssa_eliminate_dead_code(SsaFunction* function)
+{
+    bool*            is_live   = ssa_calloc(function->nb_instructions, sizeof(bool));
+    SsaInstruction** work_list = ssa_calloc(function->nb_instructions, sizeof(SsaInstruction*));
+    int nb_work = 0;
+
+    for (int i = 0; i < function->nb_blocks; i++)
+    {
+        SsaBlock* block = function->blocks[i];
+        if (block->is_removed)
+            continue;
+
+        for (int j = 0; j < block->nb_instructions; j++)
+        {
+            SsaInstruction* instruction = block->instructions[j];
+            bool is_root = instruction->opcode == SSA_STORE || instruction->opcode == SSA_CALL
+                        || instruction->opcode == SSA_PRINT;
+            if (is_root && ! is_live[instruction->id])
+            {
+                is_live[instruction->id] = true;
+                work_list[nb_work++] = instruction;
+            }
+        }
+        SsaInstruction* value = block->terminator_value;
+        if (value != NULL && ! is_live[value->id])
+        {
+            is_live[value->id] = true;
+            work_list[nb_work++] = value;
+        }
+    }
+
+    while (nb_work > 0)
+    {
+        SsaInstruction* instruction = work_list[--nb_work];
+        for (int i = 0; i < instruction->nb_operands; i++)
+        {
+            SsaInstruction* operand = instruction->operands[i];
+            if ( ! is_live[operand->id])
+            {
+                is_live[operand->id] = true;
+                work_list[nb_work++] = operand;
+            }
+        }
+    }
+
+    for (int i = 0; i < function->nb_instructions; i++)
+    {
+        if ( ! is_live[i])
+            function->instructions[i]->is_removed = true;
+    }
+    if (function->undef != NULL && function->undef->is_removed)
+        function->undef = NULL;
+
+    free(work_list);
+    free(is_live);
+
+    ssa_apply_replacements(function);
+}
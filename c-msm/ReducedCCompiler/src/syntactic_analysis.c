@@ -46,7 +46,7 @@ struct OperatorInfo_s
     int associativity;
     int node_type;
 };
-#define NB_BINARY_OPERATORS 19
+#define NB_BINARY_OPERATORS 29
 #define MIN_PRIORITY 0
 OperatorInfo get_operator_info(int token_type)
 {
@@ -65,6 +65,11 @@ OperatorInfo get_operator_info(int token_type)
         case TOK_MUL_EQUAL:
         case TOK_DIV_EQUAL:
         case TOK_MOD_EQUAL:
+        case TOK_2_LESS_EQUAL:
+        case TOK_2_GREATER_EQUAL:
+        case TOK_AMPERSAND_EQUAL:
+        case TOK_PIPE_EQUAL:
+        case TOK_CARET_EQUAL:
         {
             op_info.priority      = 1;
             op_info.associativity = RIGHT_TO_LEFT;
@@ -85,79 +90,114 @@ OperatorInfo get_operator_info(int token_type)
             op_info.node_type     = NODE_AND;
             break;
         }
-        case TOK_2_EQUAL:
+        case TOK_PIPE:
         {
             op_info.priority      = 4;
             op_info.associativity = LEFT_TO_RIGHT;
+            op_info.node_type     = NODE_BITWISE_OR;
+            break;
+        }
+        case TOK_CARET:
+        {
+            op_info.priority      = 5;
+            op_info.associativity = LEFT_TO_RIGHT;
+            op_info.node_type     = NODE_BITWISE_XOR;
+            break;
+        }
+        case TOK_AMPERSAND:
+        {
+            op_info.priority      = 6;
+            op_info.associativity = LEFT_TO_RIGHT;
+            op_info.node_type     = NODE_BITWISE_AND;
+            break;
+        }
+        case TOK_2_EQUAL:
+        {
+            op_info.priority      = 7;
+            op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_EQUAL;
             break;
         }
         case TOK_NOT_EQUAL:
         {
-            op_info.priority      = 4;
+            op_info.priority      = 7;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_NOT_EQUAL;
             break;
         }
         case TOK_GREATER:
         {
-            op_info.priority      = 5;
+            op_info.priority      = 8;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_GREATER;
             break;
         }
         case TOK_GREATER_OR_EQUAL:
         {
-            op_info.priority      = 5;
+            op_info.priority      = 8;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_GREATER_OR_EQUAL;
             break;
         }
         case TOK_LESS:
         {
-            op_info.priority      = 5;
+            op_info.priority      = 8;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_LESS;
             break;
         }
         case TOK_LESS_OR_EQUAL:
         {
-            op_info.priority      = 5;
+            op_info.priority      = 8;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_LESS_OR_EQUAL;
             break;
         }
+        case TOK_2_LESS:
+        {
+            op_info.priority      = 9;
+            op_info.associativity = LEFT_TO_RIGHT;
+            op_info.node_type     = NODE_LEFT_SHIFT;
+            break;
+        }
+        case TOK_2_GREATER:
+        {
+            op_info.priority      = 9;
+            op_info.associativity = LEFT_TO_RIGHT;
+            op_info.node_type     = NODE_RIGHT_SHIFT;
+            break;
+        }
         case TOK_PLUS:
         {
-            op_info.priority      = 6;
+            op_info.priority      = 10;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_ADD;
             break;
         }
         case TOK_MINUS:
         {
-            op_info.priority      = 6;
+            op_info.priority      = 10;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_SUB;
             break;
         }
         case TOK_STAR:
         {
-            op_info.priority      = 7;
+            op_info.priority      = 11;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_MUL;
             break;
         }
         case TOK_SLASH:
         {
-            op_info.priority      = 7;
+            op_info.priority      = 11;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_DIV;
             break;
         }
         case TOK_PERCENT:
         {
-            op_info.priority      = 7;
+            op_info.priority      = 11;
             op_info.associativity = LEFT_TO_RIGHT;
             op_info.node_type     = NODE_MOD;
             break;
@@ -205,14 +245,7 @@ uint8_t subrule_specifiers(SyntacticAnalyzer* analyzer, uint8_t specifier_flags)
 SyntacticNode* subrule_decl_initialization(SyntacticAnalyzer* analyzer, SyntacticNode *decl)
 {
     SyntacticNode* ref = syntactic_node_create(NODE_REF, decl->line, decl->col);
-    size_t nb_char = strlen(decl->value.str_val);
-    ref->value.str_val = malloc((nb_char + 1) * sizeof(char));
-    if (ref->value.str_val == NULL)
-    {
-        perror("Failed to allocate space for reference's name");
-        exit(EXIT_FAILURE);
-    }
-    memcpy(ref->value.str_val, decl->value.str_val, (nb_char + 1) * sizeof(char));
+    ref->value.str_val = decl->value.str_val; // Names are interned, they can be shared
 
     SyntacticNode* assignment = syntactic_node_create(NODE_ASSIGNMENT, analyzer->tokenizer.current.line, analyzer->tokenizer.current.col);
     SyntacticNode* expr = sr_expression(analyzer);
@@ -223,6 +256,45 @@ SyntacticNode* subrule_decl_initialization(SyntacticAnalyzer* analyzer, Syntacti
     return assignment;
 }
 
+// Reads what follows the identifier of a declaration : the size of an array or the initial value of a variable
+void subrule_decl_suffix(SyntacticAnalyzer* analyzer, SyntacticNode* decl, bool allow_init)
+{
+    if (tokenizer_check(&(analyzer->tokenizer), TOK_OPEN_BRACKET))
+    {
+        tokenizer_accept(&(analyzer->tokenizer), TOK_CONSTANT);
+        int nb_elements = analyzer->tokenizer.current.value.int_val;
+        if (nb_elements <= 0)
+        {
+            fprintf(stderr, "(%d:%d):error: size of array '%s' must be positive\n", analyzer->tokenizer.current.line, analyzer->tokenizer.current.col, decl->value.str_val);
+            syntactic_analyzer_inc_error(analyzer);
+            nb_elements = 1;
+        }
+        else if (nb_elements > MACHINE_MEMORY_SIZE)
+        {
+            fprintf(stderr, "(%d:%d):error: size of array '%s' exceeds the %d cells of the memory\n", analyzer->tokenizer.current.line, analyzer->tokenizer.current.col, decl->value.str_val, MACHINE_MEMORY_SIZE);
+            syntactic_analyzer_inc_error(analyzer);
+            nb_elements = 1;
+        }
+        tokenizer_accept(&(analyzer->tokenizer), TOK_CLOSE_BRACKET);
+
+        decl->flags  = set_flag(decl->flags, ARRAY_FLAG);
+        decl->nb_var = nb_elements;
+    }
+
+    if (allow_init && tokenizer_check(&(analyzer->tokenizer), TOK_EQUAL))
+    {
+        SyntacticNode* init = subrule_decl_initialization(analyzer, decl);
+        if (syntactic_node_is_flag_set(decl, ARRAY_FLAG))
+        {
+            fprintf(stderr, "(%d:%d):error: array '%s' can't be initialized\n", init->line, init->col, decl->value.str_val);
+            syntactic_analyzer_inc_error(analyzer);
+            syntactic_node_free_tree(init);
+        }
+        else
+            syntactic_node_add_child(decl, init);
+    }
+}
+
 SyntacticNode* subrule_single_decl(SyntacticAnalyzer* analyzer, SyntacticNode* declaration_seq, bool allow_init)
 {
     tokenizer_accept(&(analyzer->tokenizer), TOK_IDENTIFIER);
@@ -231,11 +303,7 @@ SyntacticNode* subrule_single_decl(SyntacticAnalyzer* analyzer, SyntacticNode* d
     analyzer->tokenizer.current.value.str_val = NULL;
     syntactic_node_add_child(declaration_seq, decl);
 
-    if (allow_init && tokenizer_check(&(analyzer->tokenizer), TOK_EQUAL))
-    {
-        SyntacticNode* init = subrule_decl_initialization(analyzer, decl);
-        syntactic_node_add_child(decl, init);
-    }
+    subrule_decl_suffix(analyzer, decl, allow_init);
 
     return decl;
 }
@@ -265,6 +333,8 @@ SyntacticAnalyzer syntactic_analyzer_create(char* source_buffer, optimization_t
     analyzer.nb_errors      = 0;
     analyzer.nb_warnings    = 0;
     analyzer.optimizations  = optimizations;
+    analyzer.declaration_start = 0;
+    analyzer.declaration_end   = 0;
 
     return analyzer;
 }
@@ -282,6 +352,22 @@ SyntacticNode* syntactic_analyzer_build_tree(SyntacticAnalyzer* analyzer)
     return analyzer->syntactic_tree;
 }
 
+SyntacticNode* syntactic_analyzer_next_declaration(SyntacticAnalyzer* analyzer)
+{
+    assert(analyzer != NULL);
+
+    // The first call reads the first token
+    if (analyzer->tokenizer.next.type == TOK_NONE)
+        tokenizer_step(&(analyzer->tokenizer));
+    if (analyzer->tokenizer.next.type == TOK_EOF)
+        return NULL;
+
+    analyzer->declaration_start = analyzer->tokenizer.next_start;
+    SyntacticNode* declaration = sr_global_declaration(analyzer);
+    analyzer->declaration_end = analyzer->tokenizer.current_end;
+    return declaration;
+}
+
 
 void syntactic_analyzer_report_and_exit(const SyntacticAnalyzer* analyzer)
 {
@@ -317,6 +403,7 @@ SyntacticNode* sr_global_declaration(SyntacticAnalyzer* analyzer)
 
     SyntacticNode* global_decl = NULL;
 
+    bool is_extern = tokenizer_check(&(analyzer->tokenizer), TOK_EXTERN);
     uint8_t specifiers = subrule_specifiers(analyzer, 0);
 
     if (tokenizer_check(&(analyzer->tokenizer), TOK_INT))
@@ -352,13 +439,19 @@ SyntacticNode* sr_global_declaration(SyntacticAnalyzer* analyzer)
             }
             syntactic_node_add_child(global_decl, seq);
 
-            tokenizer_accept(&(analyzer->tokenizer), TOK_OPEN_BRACE);
-            SyntacticNode* function_body = syntactic_node_create(NODE_SEQUENCE, analyzer->tokenizer.current.line, analyzer->tokenizer.current.col);
-            while (!tokenizer_check(&(analyzer->tokenizer), TOK_CLOSE_BRACE))
+            // A prototype only has the parameters, the function is defined further or in another object file
+            if (tokenizer_check(&(analyzer->tokenizer), TOK_SEMICOLON))
+                global_decl->flags = set_flag(global_decl->flags, EXTERN_FLAG);
+            else
             {
-                syntactic_node_add_child(function_body, sr_instruction(analyzer));
+                tokenizer_accept(&(analyzer->tokenizer), TOK_OPEN_BRACE);
+                SyntacticNode* function_body = syntactic_node_create(NODE_SEQUENCE, analyzer->tokenizer.current.line, analyzer->tokenizer.current.col);
+                while (!tokenizer_check(&(analyzer->tokenizer), TOK_CLOSE_BRACE))
+                {
+                    syntactic_node_add_child(function_body, sr_instruction(analyzer));
+                }
+                syntactic_node_add_child(global_decl, function_body);
             }
-            syntactic_node_add_child(global_decl, function_body);
         }
         else
         {
@@ -366,11 +459,7 @@ SyntacticNode* sr_global_declaration(SyntacticAnalyzer* analyzer)
             SyntacticNode* var_decl = syntactic_node_create(NODE_DECL, tok_identifier.line, tok_identifier.col);
             var_decl->value.str_val = tok_identifier.value.str_val; // Steal the pointer from the token to avoid a copy
             syntactic_node_add_child(global_decl, var_decl);
-            if (tokenizer_check(&(analyzer->tokenizer), TOK_EQUAL))
-            {
-                SyntacticNode* init = subrule_decl_initialization(analyzer, var_decl);
-                syntactic_node_add_child(var_decl, init);
-            }
+            subrule_decl_suffix(analyzer, var_decl, true);
 
             while (!tokenizer_check(&(analyzer->tokenizer), TOK_SEMICOLON))
             {
@@ -379,7 +468,20 @@ SyntacticNode* sr_global_declaration(SyntacticAnalyzer* analyzer)
             }
 
             for (int i = 0; i < global_decl->nb_children; i++)
-                global_decl->children[i]->flags = specifiers;
+            {
+                SyntacticNode* var_decl = global_decl->children[i];
+                var_decl->flags |= specifiers;
+                if (is_extern)
+                {
+                    // The variable is defined in another object file, which initializes it
+                    var_decl->flags = set_flag(var_decl->flags, EXTERN_FLAG);
+                    if (var_decl->nb_children > 0)
+                    {
+                        fprintf(stderr, "(%d:%d):error: extern variable '%s' can't be initialized\n", var_decl->line, var_decl->col, var_decl->value.str_val);
+                        syntactic_analyzer_inc_error(analyzer);
+                    }
+                }
+            }
         }
 
     }
@@ -407,19 +509,19 @@ SyntacticNode* sr_instruction(SyntacticAnalyzer* analyzer)
 
     uint8_t specifiers = subrule_specifiers(analyzer, 0);
     if (specifiers != 0)
-    { // I ---> specifier* 'int' specifier* ident ('=' E)? (',' ident ('=' E)? )* ';'
+    { // I ---> specifier* 'int' specifier* ident ('[' const ']' | '=' E)? (',' ident ('[' const ']' | '=' E)? )* ';'
         tokenizer_accept(&(analyzer->tokenizer), TOK_INT);
         specifiers = subrule_specifiers(analyzer, specifiers);
         node = subrule_decl_instruction(analyzer, true);
         for (int i = 0; i < node->nb_children; i++)
-            node->children[i]->flags = specifiers;
+            node->children[i]->flags |= specifiers;
     }
     else if (tokenizer_check(&(analyzer->tokenizer), TOK_INT))
-    { // I ---> 'int' specifier* ident ('=' E)? (',' ident ('=' E)? )* ';'
+    { // I ---> 'int' specifier* ident ('[' const ']' | '=' E)? (',' ident ('[' const ']' | '=' E)? )* ';'
         specifiers = subrule_specifiers(analyzer, specifiers);
         node = subrule_decl_instruction(analyzer, true);
         for (int i = 0; i < node->nb_children; i++)
-            node->children[i]->flags = specifiers;
+            node->children[i]->flags |= specifiers;
     }
     else if (tokenizer_check(&(analyzer->tokenizer), TOK_OPEN_BRACE))
     { // I ---> '{' I* '}'
@@ -578,10 +680,15 @@ SyntacticNode* sr_expression_prio(SyntacticAnalyzer* analyzer, int priority)
     //      | P '*=' E
     //      | P '/=' E
     //      | P '%=' E
+    //      | P '<<=' | '>>=' | '&=' | '|=' | '^=' E
     //      | P '||' E
     //      | P '&&' E
+    //      | P '|' E
+    //      | P '^' E
+    //      | P '&' E
     //      | P '==' | '!=' E
     //      | P '<' | '<=' | '>' | '>='  E
+    //      | P '<<' | '>>' E
     //      | P '+' | '-' E
     //      | P '*' | '/' E
 
@@ -622,6 +729,12 @@ SyntacticNode* sr_expression_prio(SyntacticAnalyzer* analyzer, int priority)
                         case NODE_LESS_OR_EQUAL:    value = op1_val <=  op2_val;  break;
                         case NODE_GREATER:          value = op1_val >   op2_val;  break;
                         case NODE_GREATER_OR_EQUAL: value = op1_val >=  op2_val;  break;
+                        case NODE_BITWISE_OR:       value = op1_val |   op2_val;  has_been_folded = true; break;
+                        case NODE_BITWISE_XOR:      value = op1_val ^   op2_val;  has_been_folded = true; break;
+                        case NODE_BITWISE_AND:      value = op1_val &   op2_val;  has_been_folded = true; break;
+                        // Same semantic as the msm 'shl' and 'shr' instructions : the shift count is taken modulo 32
+                        case NODE_LEFT_SHIFT:       value = (int) ((unsigned) op1_val << (op2_val & 31)); has_been_folded = true; break;
+                        case NODE_RIGHT_SHIFT:      value = op1_val >> (op2_val & 31); has_been_folded = true; break;
 
                         case NODE_ADD:
                         {
@@ -745,12 +858,17 @@ SyntacticNode* sr_expression_prio(SyntacticAnalyzer* analyzer, int priority)
                             SyntacticNode* arithmetic_op = NULL;
                             switch (token_operator.type)
                             {
-                                case TOK_PLUS_EQUAL:  arithmetic_op = syntactic_node_create(NODE_ADD, token_operator.line, token_operator.col); break;
-                                case TOK_MINUS_EQUAL: arithmetic_op = syntactic_node_create(NODE_SUB, token_operator.line, token_operator.col); break;
-                                case TOK_MUL_EQUAL:   arithmetic_op = syntactic_node_create(NODE_MUL, token_operator.line, token_operator.col); break;
-                                case TOK_DIV_EQUAL:   arithmetic_op = syntactic_node_create(NODE_DIV, token_operator.line, token_operator.col); break;
-                                case TOK_MOD_EQUAL:   arithmetic_op = syntactic_node_create(NODE_MOD, token_operator.line, token_operator.col); break;
-                                default:              assert(false);
+                                case TOK_PLUS_EQUAL:        arithmetic_op = syntactic_node_create(NODE_ADD,         token_operator.line, token_operator.col); break;
+                                case TOK_MINUS_EQUAL:       arithmetic_op = syntactic_node_create(NODE_SUB,         token_operator.line, token_operator.col); break;
+                                case TOK_MUL_EQUAL:         arithmetic_op = syntactic_node_create(NODE_MUL,         token_operator.line, token_operator.col); break;
+                                case TOK_DIV_EQUAL:         arithmetic_op = syntactic_node_create(NODE_DIV,         token_operator.line, token_operator.col); break;
+                                case TOK_MOD_EQUAL:         arithmetic_op = syntactic_node_create(NODE_MOD,         token_operator.line, token_operator.col); break;
+                                case TOK_2_LESS_EQUAL:      arithmetic_op = syntactic_node_create(NODE_LEFT_SHIFT,  token_operator.line, token_operator.col); break;
+                                case TOK_2_GREATER_EQUAL:   arithmetic_op = syntactic_node_create(NODE_RIGHT_SHIFT, token_operator.line, token_operator.col); break;
+                                case TOK_AMPERSAND_EQUAL:   arithmetic_op = syntactic_node_create(NODE_BITWISE_AND, token_operator.line, token_operator.col); break;
+                                case TOK_PIPE_EQUAL:        arithmetic_op = syntactic_node_create(NODE_BITWISE_OR,  token_operator.line, token_operator.col); break;
+                                case TOK_CARET_EQUAL:       arithmetic_op = syntactic_node_create(NODE_BITWISE_XOR, token_operator.line, token_operator.col); break;
+                                default:                    assert(false);
                             }
                             syntactic_node_add_child(arithmetic_op, operand1);
                             syntactic_node_add_child(arithmetic_op, operand2);
@@ -789,6 +907,12 @@ SyntacticNode* sr_prefix(SyntacticAnalyzer* analyzer)
         SyntacticNode* next_prefix_node = sr_prefix(analyzer);
         syntactic_node_add_child(node, next_prefix_node);
     }
+    else if (tokenizer_check(&(analyzer->tokenizer), TOK_TILDE))
+    { // P ---> '~' P
+        node = syntactic_node_create(NODE_BITWISE_NOT, analyzer->tokenizer.current.line, analyzer->tokenizer.current.col);
+        SyntacticNode* next_prefix_node = sr_prefix(analyzer);
+        syntactic_node_add_child(node, next_prefix_node);
+    }
     else if (tokenizer_check(&(analyzer->tokenizer), TOK_STAR))
     { // P ---> '*' P
         node = syntactic_node_create(NODE_DEREF, analyzer->tokenizer.current.line, analyzer->tokenizer.current.col);
@@ -958,6 +1082,21 @@ SyntacticNode* opti_constant_prefix(SyntacticNode* node, SyntacticAnalyzer* anal
             }
             break;
         }
+        case NODE_BITWISE_NOT:
+        {
+            assert(node->children[0] != NULL);
+            SyntacticNode* constant = node->children[0];
+
+            if (constant->type == NODE_CONSTANT)
+            {
+                optimized_node = constant;
+                optimized_node->value.int_val = ~ constant->value.int_val;
+
+                syntactic_node_free(optimized_node->parent);
+                optimized_node->parent = NULL;
+            }
+            break;
+        }
     }
 
     return optimized_node;
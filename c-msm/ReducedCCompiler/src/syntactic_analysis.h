@@ -17,10 +17,15 @@ struct SyntacticAnalyzer_s
     int            nb_errors;
     int            nb_warnings;
     optimization_t optimizations;
+    int            declaration_start; // Source of the last declaration returned by syntactic_analyzer_next_declaration(),
+    int            declaration_end;   // from its first token to its last
 };
 
 SyntacticAnalyzer syntactic_analyzer_create(char* source_buffer, optimization_t optimizations);
 SyntacticNode* syntactic_analyzer_build_tree(SyntacticAnalyzer* analyzer);
+// Parses the next function or global variable declaration, NULL at the end of the source.
+// The declarations are owned by the caller, 'syntactic_tree' stays NULL.
+SyntacticNode* syntactic_analyzer_next_declaration(SyntacticAnalyzer* analyzer);
 void syntactic_analyzer_report_and_exit(const SyntacticAnalyzer* analyzer);
 
 #endif // SYNTACTIC_ANALYSIS_H
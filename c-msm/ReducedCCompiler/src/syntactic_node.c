@@ -62,12 +62,18 @@ void syntactic_node_display(const SyntacticNode* node, FILE *out_file)
         case NODE_CONSTANT:                fprintf(out_file, "CONST : value = %d\n", node->value.int_val);                               break;
         case NODE_UNARY_MINUS:          fprintf(out_file, "UNARY_MINUS\n");                                                           break;
         case NODE_NEGATION:             fprintf(out_file, "NEGATION\n");                                                              break;
+        case NODE_BITWISE_NOT:          fprintf(out_file, "BITWISE NOT\n");                                                           break;
         case NODE_ADDRESS:              fprintf(out_file, "ADDRESS\n");                                                               break;
         case NODE_ADD:                  fprintf(out_file, "ADD\n");                                                                   break;
         case NODE_SUB:                  fprintf(out_file, "SUB\n");                                                                   break;
         case NODE_MUL:                  fprintf(out_file, "MUL\n");                                                                   break;
         case NODE_DIV:                  fprintf(out_file, "DIV\n");                                                                   break;
         case NODE_MOD:                  fprintf(out_file, "MOD\n");                                                                   break;
+        case NODE_BITWISE_OR:           fprintf(out_file, "BITWISE OR\n");                                                            break;
+        case NODE_BITWISE_XOR:          fprintf(out_file, "BITWISE XOR\n");                                                           break;
+        case NODE_BITWISE_AND:          fprintf(out_file, "BITWISE AND\n");                                                           break;
+        case NODE_LEFT_SHIFT:           fprintf(out_file, "LEFT SHIFT\n");                                                            break;
+        case NODE_RIGHT_SHIFT:          fprintf(out_file, "RIGHT SHIFT\n");                                                           break;
         case NODE_BLOCK:                fprintf(out_file, "BLOCK\n");                                                                 break;
         case NODE_SEQUENCE:             fprintf(out_file, "SEQUENCE\n");                                                              break;
         case NODE_PRINT:                fprintf(out_file, "PRINT\n");                                                                 break;
@@ -101,6 +107,8 @@ void syntactic_node_display(const SyntacticNode* node, FILE *out_file)
         case NODE_RETURN:               fprintf(out_file, "RETURN\n");                                                                break;
         case NODE_DEREF:                fprintf(out_file, "DEREF\n");                                                                 break;
         case NODE_COMPOUND:             fprintf(out_file, "COMPOUND\n");                                                              break;
+        case NODE_INLINED_CALL:         fprintf(out_file, "INLINED CALL : name = %s\n", node->value.str_val);                         break;
+        case NODE_TAIL_CALL:            fprintf(out_file, "TAIL CALL : name = %s\n", node->value.str_val);                            break;
     }
 }
 
@@ -126,6 +134,24 @@ void syntactic_node_display_tree(const SyntacticNode* root, int depth, FILE* out
     free(depth_indicator);
 }
 
+// The copy shares the names (str_val) of the original nodes
+SyntacticNode* syntactic_node_copy_tree(const SyntacticNode* tree)
+{
+    assert(tree != NULL);
+
+    SyntacticNode* copy = syntactic_node_create(tree->type, tree->line, tree->col);
+    copy->value        = tree->value;
+    copy->stack_offset = tree->stack_offset;
+    copy->nb_var       = tree->nb_var;
+    copy->flags        = tree->flags;
+    for (int i = 0; i < tree->nb_children; i++)
+    {
+        syntactic_node_add_child(copy, syntactic_node_copy_tree(tree->children[i]));
+    }
+
+    return copy;
+}
+
 void syntactic_node_free(SyntacticNode* node)
 {
     free(node->children);
@@ -140,3 +166,12 @@ void syntactic_node_free_tree(SyntacticNode* tree)
     }
     syntactic_node_free(tree);
 }
+
+void syntactic_node_free_children(SyntacticNode* node)
+{
+    for (int i = 0; i < node->nb_children; i++)
+    {
+        syntactic_node_free_tree(node->children[i]);
+    }
+    node->nb_children = 0;
+}
@@ -7,6 +7,7 @@
 #include <assert.h>
 
 #define NO_STACK_OFFSET -1
+#define MACHINE_MEMORY_SIZE (1 << 16) // Cells of the memory of msm, which the variables can't exceed
 
 typedef struct SyntacticNode_s SyntacticNode;
 struct SyntacticNode_s
@@ -19,7 +20,7 @@ struct SyntacticNode_s
     } value;
     int stack_offset;   // Only usefull for variable declaration and references
                         // Indicates its location on the stack
-    int  nb_var;        // For functions
+    int  nb_var;        // For functions, and number of elements of array declarations
     int  line;
     int  col;
     SyntacticNode* parent;
@@ -30,6 +31,9 @@ struct SyntacticNode_s
 
 #define GLOBAL_FLAG (1 << 0)
 #define CONST_FLAG  (1 << 1)
+#define TAIL_CALL_FLAG (1 << 2) // For functions, set if the function jumps back to its entry
+#define ARRAY_FLAG (1 << 3)     // For variables, the value of the variable is the address of its first element
+#define EXTERN_FLAG (1 << 4)    // Prototype of a function or variable defined further or in another object file
 
 static inline void syntactic_node_set_flag(SyntacticNode* node, uint8_t flag)
 {
@@ -49,8 +53,12 @@ void syntactic_node_add_child(SyntacticNode* parent, SyntacticNode* child);
 void syntactic_node_display(const SyntacticNode* node, FILE *out_file);
 void syntactic_node_display_tree(const SyntacticNode* root, int depth, FILE* out_file);
 
+SyntacticNode* syntactic_node_copy_tree(const SyntacticNode* tree);
+
 void syntactic_node_free(SyntacticNode* node);
 void syntactic_node_free_tree(SyntacticNode* tree);
+// Frees the subtrees of the node, the node itself is kept
+void syntactic_node_free_children(SyntacticNode* node);
 
 enum
 {
@@ -60,6 +68,7 @@ enum
     // Prefix operators
     NODE_UNARY_MINUS,       // '-' to denote the corresponding negative value
     NODE_NEGATION,          // '!' to denote the corresponding negation
+    NODE_BITWISE_NOT,       // '~' to denote the complement of every bit
     NODE_DEREF,             // '*' to access the pointed memory
     NODE_ADDRESS,           // '&' to denote the address where the variable is stored
 
@@ -78,6 +87,11 @@ enum
     NODE_MOD,               //
     NODE_ADD,               //
     NODE_SUB,               //
+    NODE_BITWISE_OR,        //
+    NODE_BITWISE_XOR,       //
+    NODE_BITWISE_AND,       //
+    NODE_LEFT_SHIFT,        //
+    NODE_RIGHT_SHIFT,       // Arithmetic shift, the sign bit is copied
 
     NODE_DECL,              // Variable declaration
     NODE_REF,               // Reference to a variable
@@ -96,5 +110,7 @@ enum
     NODE_CALL,
     NODE_RETURN,
     NODE_COMPOUND,
+    NODE_INLINED_CALL,      // Body of a function substituted to its call : argument bindings then the returned expression
+    NODE_TAIL_CALL,         // 'return' of a call to the current function : the arguments overwrite the parameters
 };
 #endif // SYNTACTIC_NODE_H
@@ -0,0 +1,116 @@
+#include "thread_pool.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32) || defined(WIN32)
+    #include <windows.h>
+
+    typedef HANDLE           Thread;
+    typedef CRITICAL_SECTION Mutex;
+
+    #define THREAD_RESULT                  DWORD WINAPI
+    #define THREAD_RETURN                  return 0
+    #define THREAD_CREATE(thread, f, arg)  ((*(thread) = CreateThread(NULL, 0, f, arg, 0, NULL)) != NULL)
+    #define THREAD_JOIN(thread)            (WaitForSingleObject(thread, INFINITE), CloseHandle(thread))
+    #define MUTEX_INIT(mutex)              InitializeCriticalSection(mutex)
+    #define MUTEX_DESTROY(mutex)           DeleteCriticalSection(mutex)
+    #define MUTEX_LOCK(mutex)              EnterCriticalSection(mutex)
+    #define MUTEX_UNLOCK(mutex)            LeaveCriticalSection(mutex)
+#else
+    #include <pthread.h>
+
+    typedef pthread_t       Thread;
+    typedef pthread_mutex_t Mutex;
+
+    #define THREAD_RESULT                  void*
+    #define THREAD_RETURN                  return NULL
+    #define THREAD_CREATE(thread, f, arg)  (pthread_create(thread, NULL, f, arg) == 0)
+    #define THREAD_JOIN(thread)            pthread_join(thread, NULL)
+    #define MUTEX_INIT(mutex)              pthread_mutex_init(mutex, NULL)
+    #define MUTEX_DESTROY(mutex)           pthread_mutex_destroy(mutex)
+    #define MUTEX_LOCK(mutex)              pthread_mutex_lock(mutex)
+    #define MUTEX_UNLOCK(mutex)            pthread_mutex_unlock(mutex)
+#endif
+
+typedef struct ThreadPool_s ThreadPool;
+struct ThreadPool_s
+{
+    ThreadPoolTask task;
+    void*          context;
+    int            nb_tasks;
+    int            next_task;  // Next task not started yet, protected by the mutex
+    Mutex          mutex;
+};
+
+typedef struct Worker_s Worker;
+struct Worker_s
+{
+    ThreadPool* pool;
+    int         index;
+    Thread      thread;
+};
+
+static THREAD_RESULT worker_run(void* argument)
+{
+    Worker* worker = argument;
+    ThreadPool* pool = worker->pool;
+    for (;;)
+    {
+        MUTEX_LOCK(&(pool->mutex));
+        int task = pool->next_task;
+        if (task < pool->nb_tasks)
+            pool->next_task++;
+        MUTEX_UNLOCK(&(pool->mutex));
+
+        if (task >= pool->nb_tasks)
+            break;
+        pool->task(pool->context, task, worker->index);
+    }
+    THREAD_RETURN;
+}
+
+void thread_pool_run(int nb_workers, int nb_tasks, ThreadPoolTask task, void* context)
+{
+    assert(nb_workers >= 1 && nb_tasks >= 0 && task != NULL);
+
+    if (nb_workers > nb_tasks)
+        nb_workers = nb_tasks;
+
+    ThreadPool pool;
+    pool.task      = task;
+    pool.context   = context;
+    pool.nb_tasks  = nb_tasks;
+    pool.next_task = 0;
+    MUTEX_INIT(&(pool.mutex));
+
+    Worker* workers = malloc(sizeof(Worker) * (nb_workers + (size_t) 1));
+    if (workers == NULL)
+    {
+        perror("Failed to allocate memory for the thread pool");
+        exit(EXIT_FAILURE);
+    }
+
+    // The calling thread is the first worker
+    for (int i = 0; i < nb_workers; i++)
+    {
+        workers[i].pool  = &pool;
+        workers[i].index = i;
+    }
+    for (int i = 1; i < nb_workers; i++)
+    {
+        if ( ! THREAD_CREATE(&(workers[i].thread), worker_run, &(workers[i])))
+        {
+            perror("Failed to create a thread of the thread pool");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (nb_workers > 0)
+        worker_run(&(workers[0]));
+    for (int i = 1; i < nb_workers; i++)
+        THREAD_JOIN(workers[i].thread);
+
+    free(workers);
+    MUTEX_DESTROY(&(pool.mutex));
+}
@@ -0,0 +1,11 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Task run by the pool, 'worker' is the index of the thread that runs it, from 0 to the number of workers - 1
+typedef void (*ThreadPoolTask)(void* context, int task, int worker);
+
+// Runs the tasks 0 to 'nb_tasks' - 1 on 'nb_workers' threads and returns once they are all done
+// Each idle worker takes the next task not started yet, so the order in which the tasks complete is unspecified
+void thread_pool_run(int nb_workers, int nb_tasks, ThreadPoolTask task, void* context);
+
+#endif // THREAD_POOL_H
@@ -2,10 +2,71 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
+/*
+* Blanks, comment bodies and identifiers are skipped a whole vector of characters at a time
+* when the target supports it, TOKENIZER_NO_SIMD forces the scalar path.
+*/
+#if !defined(TOKENIZER_NO_SIMD) && defined(__GNUC__) && defined(__AVX2__)
+    #include <immintrin.h>
+
+    #define SIMD_WIDTH 32
+    #define SIMD_FULL_MASK 0xFFFFFFFFu
+    typedef __m256i simd_t;
+    #define simd_load(ptr) _mm256_loadu_si256((const __m256i*) (ptr))
+    #define simd_set(c)    _mm256_set1_epi8((char) (c))
+    #define simd_eq(a, b)  _mm256_cmpeq_epi8(a, b)
+    #define simd_gt(a, b)  _mm256_cmpgt_epi8(a, b)
+    #define simd_or(a, b)  _mm256_or_si256(a, b)
+    #define simd_and(a, b) _mm256_and_si256(a, b)
+    #define simd_mask(a)   ((uint32_t) _mm256_movemask_epi8(a))
+#elif !defined(TOKENIZER_NO_SIMD) && defined(__GNUC__) && defined(__SSE2__)
+    #include <emmintrin.h>
+
+    #define SIMD_WIDTH 16
+    #define SIMD_FULL_MASK 0xFFFFu
+    typedef __m128i simd_t;
+    #define simd_load(ptr) _mm_loadu_si128((const __m128i*) (ptr))
+    #define simd_set(c)    _mm_set1_epi8((char) (c))
+    #define simd_eq(a, b)  _mm_cmpeq_epi8(a, b)
+    #define simd_gt(a, b)  _mm_cmpgt_epi8(a, b)
+    #define simd_or(a, b)  _mm_or_si128(a, b)
+    #define simd_and(a, b) _mm_and_si128(a, b)
+    #define simd_mask(a)   ((uint32_t) _mm_movemask_epi8(a))
+#endif
+
+#define B CHAR_BLANK
+#define D CHAR_DIGIT
+#define L CHAR_LETTER
+
+enum
+{
+    CHAR_BLANK  = 1 << 0,   // ' ', '\t', '\r' and '\n'
+    CHAR_DIGIT  = 1 << 1,
+    CHAR_LETTER = 1 << 2,   // Letters and '_'
+};
+
+// Class of every character, the non ASCII characters belong to no class
+static const unsigned char CHAR_CLASS[256] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0, 0, B, B, 0, 0, B, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    B, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    D, D, D, D, D, D, D, D, D, D, 0, 0, 0, 0, 0, 0,
+    0, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L,
+    L, L, L, L, L, L, L, L, L, L, L, 0, 0, 0, 0, L,
+    0, L, L, L, L, L, L, L, L, L, L, L, L, L, L, L,
+    L, L, L, L, L, L, L, L, L, L, L, 0, 0, 0, 0, 0,
+};
+
+#undef B
+#undef D
+#undef L
+
 Token token_create()
 {
     Token token;
@@ -21,9 +82,12 @@ Tokenizer tokenizer_create(char* buff)
 
     Tokenizer tokenizer;
     tokenizer.buff    = buff;
+    tokenizer.length  = (int) strlen(buff);
     tokenizer.pos     = 0;
     tokenizer.line    = 1;
     tokenizer.col     = 1;
+    tokenizer.current_end = 0;
+    tokenizer.next_start  = 0;
     tokenizer.current = token_create();
     tokenizer.next    = token_create();
 
@@ -49,19 +113,17 @@ void token_error(Tokenizer* tokenizer)
 
 static inline bool is_numeric(char c)
 {
-    return c >= '0' && c <= '9';
+    return (CHAR_CLASS[(unsigned char) c] & CHAR_DIGIT) != 0;
 }
 
 static inline bool is_letter(char c)
 {
-    return (c >= 'A' && c <= 'Z')
-        || (c >= 'a' && c <= 'z')
-        || c == '_';
+    return (CHAR_CLASS[(unsigned char) c] & CHAR_LETTER) != 0;
 }
 
 static inline bool is_alphanumeric(char c)
 {
-    return is_letter(c) || is_numeric(c);
+    return (CHAR_CLASS[(unsigned char) c] & (CHAR_LETTER | CHAR_DIGIT)) != 0;
 }
 
 static inline bool is_binary(char c)
@@ -79,34 +141,242 @@ static inline bool is_hexa(char c)
     return is_numeric(c) || ('a' <= c && c <= 'f') || ('A' <= c && c <= 'F');
 }
 
+#ifdef SIMD_WIDTH
+// Masks of the characters of the vector at 'ptr' that stop a scan, one bit per character
+
+static inline uint32_t non_blank_mask(const char* ptr)
+{
+    simd_t chunk = simd_load(ptr);
+    simd_t blank = simd_or(simd_or(simd_eq(chunk, simd_set(' ')),  simd_eq(chunk, simd_set('\t'))),
+                           simd_or(simd_eq(chunk, simd_set('\r')), simd_eq(chunk, simd_set('\n'))));
+    return ~simd_mask(blank) & SIMD_FULL_MASK;
+}
+
+static inline uint32_t non_alphanumeric_mask(const char* ptr)
+{
+    // The comparisons are signed : the non ASCII characters are below every range
+    simd_t chunk  = simd_load(ptr);
+    simd_t lower  = simd_or(chunk, simd_set(0x20));
+    simd_t letter = simd_and(simd_gt(lower, simd_set('a' - 1)), simd_gt(simd_set('z' + 1), lower));
+    simd_t digit  = simd_and(simd_gt(chunk, simd_set('0' - 1)), simd_gt(simd_set('9' + 1), chunk));
+    simd_t accepted = simd_or(simd_or(letter, digit), simd_eq(chunk, simd_set('_')));
+    return ~simd_mask(accepted) & SIMD_FULL_MASK;
+}
+
+static inline uint32_t char_or_end_mask(const char* ptr, char c)
+{
+    simd_t chunk = simd_load(ptr);
+    return simd_mask(simd_or(simd_eq(chunk, simd_set(c)), simd_eq(chunk, simd_set('\0'))));
+}
+#endif
+
+// Returns the position of the first character from 'pos' that is not a blank
+static int scan_blanks(const Tokenizer* tokenizer, int pos)
+{
+#ifdef SIMD_WIDTH
+    for (; pos + SIMD_WIDTH <= tokenizer->length; pos += SIMD_WIDTH)
+    {
+        uint32_t stop = non_blank_mask(tokenizer->buff + pos);
+        if (stop != 0)
+            return pos + __builtin_ctz(stop);
+    }
+#endif
+    while (CHAR_CLASS[(unsigned char) tokenizer->buff[pos]] & CHAR_BLANK)
+        pos++;
+    return pos;
+}
+
+// Returns the position of the first character from 'pos' that can't be part of an identifier
+static int scan_alphanumerics(const Tokenizer* tokenizer, int pos)
+{
+#ifdef SIMD_WIDTH
+    for (; pos + SIMD_WIDTH <= tokenizer->length; pos += SIMD_WIDTH)
+    {
+        uint32_t stop = non_alphanumeric_mask(tokenizer->buff + pos);
+        if (stop != 0)
+            return pos + __builtin_ctz(stop);
+    }
+#endif
+    while (is_alphanumeric(tokenizer->buff[pos]))
+        pos++;
+    return pos;
+}
+
+// Returns the position of the first 'c' or null character from 'pos'
+static int scan_until(const Tokenizer* tokenizer, int pos, char c)
+{
+#ifdef SIMD_WIDTH
+    for (; pos + SIMD_WIDTH <= tokenizer->length; pos += SIMD_WIDTH)
+    {
+        uint32_t stop = char_or_end_mask(tokenizer->buff + pos, c);
+        if (stop != 0)
+            return pos + __builtin_ctz(stop);
+    }
+#endif
+    while (tokenizer->buff[pos] != c && tokenizer->buff[pos] != '\0')
+        pos++;
+    return pos;
+}
+
+// Moves the tokenizer forward to 'end', the line and the column are computed from the position of the newlines crossed
+static void move_to(Tokenizer* tokenizer, int end)
+{
+    const char* newline = memchr(tokenizer->buff + tokenizer->pos, '\n', end - tokenizer->pos);
+    if (newline == NULL)
+    {
+        tokenizer->col += end - tokenizer->pos;
+    }
+    else
+    {
+        const char* last_newline;
+        do
+        {
+            tokenizer->line++;
+            last_newline = newline;
+            newline = memchr(last_newline + 1, '\n', tokenizer->buff + end - (last_newline + 1));
+        }
+        while (newline != NULL);
+        tokenizer->col = 1 + (int) (tokenizer->buff + end - (last_newline + 1));
+    }
+    tokenizer->pos = end;
+}
+
+/*
+* Perfect hash of the keywords : (first character + last character + length) % 32
+* gives a different slot to every keyword, a single comparison tells if the text is the keyword of its slot.
+*/
+#define KEYWORD_HASH(text, size) (((unsigned char) (text)[0] + (unsigned char) (text)[(size) - 1] + (size)) & 31)
+
+typedef struct Keyword_s Keyword;
+struct Keyword_s
+{
+    const char* text;
+    int         size;
+    int         type;
+};
+
+static const Keyword KEYWORDS[32] =
+{
+    [ 0] = { "int",      3, TOK_INT },
+    [ 1] = { "while",    5, TOK_WHILE },
+    [ 6] = { "return",   6, TOK_RETURN },
+    [ 9] = { "print",    5, TOK_PRINT },
+    [14] = { "else",     4, TOK_ELSE },
+    [16] = { "continue", 8, TOK_CONTINUE },
+    [17] = { "if",       2, TOK_IF },
+    [18] = { "break",    5, TOK_BREAK },
+    [21] = { "do",       2, TOK_DO },
+    [25] = { "extern",   6, TOK_EXTERN },
+    [27] = { "for",      3, TOK_FOR },
+    [28] = { "const",    5, TOK_CONST_SPECIFIER },
+};
+
+int token_keyword_type(const char* text, int size)
+{
+    assert(text != NULL && size > 0);
+
+    const Keyword* keyword = &KEYWORDS[KEYWORD_HASH(text, size)];
+    if (keyword->size == size && memcmp(keyword->text, text, size) == 0)
+        return keyword->type;
+    return TOK_IDENTIFIER;
+}
+
+/*
+* Identifiers are interned : every occurrence of a name shares the same string, so the memory used by the names
+* grows with the number of different identifiers instead of the size of the source. The strings are never freed.
+*/
+static char** interned_names      = NULL; // Open addressing hash table
+static int    interned_names_size = 0;    // Power of 2
+static int    nb_interned_names   = 0;
+
+// FNV-1a
+static unsigned long identifier_hash(const char* text, int size)
+{
+    unsigned long hash = 2166136261UL;
+    for (int i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char) text[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+static void intern_table_grow()
+{
+    int new_size = (interned_names_size == 0) ? 1024 : 2 * interned_names_size;
+    char** new_names = calloc(new_size, sizeof(char*));
+    if (new_names == NULL)
+    {
+        perror("Failed to allocate memory for the identifiers");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < interned_names_size; i++)
+    {
+        if (interned_names[i] == NULL)
+            continue;
+        unsigned long slot = identifier_hash(interned_names[i], (int) strlen(interned_names[i])) & (new_size - 1);
+        while (new_names[slot] != NULL)
+            slot = (slot + 1) & (new_size - 1);
+        new_names[slot] = interned_names[i];
+    }
+    free(interned_names);
+    interned_names      = new_names;
+    interned_names_size = new_size;
+}
+
+char* token_intern(const char* text, int size)
+{
+    assert(text != NULL && size > 0);
+
+    // The table is kept at most half full
+    if (2 * (nb_interned_names + 1) > interned_names_size)
+        intern_table_grow();
+
+    unsigned long slot = identifier_hash(text, size) & (interned_names_size - 1);
+    while (interned_names[slot] != NULL)
+    {
+        if (strncmp(interned_names[slot], text, size) == 0 && interned_names[slot][size] == '\0')
+            return interned_names[slot];
+        slot = (slot + 1) & (interned_names_size - 1);
+    }
+
+    char* name = malloc(sizeof(char) * size + 1);
+    if (name == NULL)
+    {
+        perror("Failed to allocate memory for an identifier");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(name, text, size);
+    name[size] = '\0';
+    interned_names[slot] = name;
+    nb_interned_names++;
+    return name;
+}
+
 void tokenizer_step(Tokenizer* tokenizer)
 {
     assert(tokenizer != NULL);
 
     // str_val is dynamically allocated when a token requiring a string is created so it must be freed before overwriting tokenizer.current
-    // str_val is not freed for TOK_IDENTIFIER because the pointer is given to the syntactic node (NODE_DECL or NODE_REF)
+    // str_val is not freed for TOK_IDENTIFIER because the name is interned and shared by the syntactic nodes (NODE_DECL or NODE_REF)
     if (tokenizer->current.type == TOK_INVALID_SEQ)
         free(tokenizer->current.value.str_val);
 
-    tokenizer->current = tokenizer->next;
+    tokenizer->current     = tokenizer->next;
+    tokenizer->current_end = tokenizer->pos;
     bool found = false;
     while ( ! found)
     {
+        // The blanks and the comments are skipped by the iterations before the one that finds the token
+        tokenizer->next_start = tokenizer->pos;
         switch (tokenizer->buff[tokenizer->pos])
         {
             case '\n':
-            {
-                tokenizer->line++;
-                tokenizer->col = 1;
-                tokenizer->pos++;
-                break;
-            }
             case ' ':
             case '\t':
             case '\r':
             {
-                tokenizer->col++;
-                tokenizer->pos++;
+                move_to(tokenizer, scan_blanks(tokenizer, tokenizer->pos));
                 break;
             }
             case '&' :
@@ -118,6 +388,12 @@ void tokenizer_step(Tokenizer* tokenizer)
                     tokenizer->col += 2;
                     tokenizer->pos += 2;
                 }
+                else if (tokenizer->buff[tokenizer->pos + 1] == '=')
+                {
+                    set_next(tokenizer, TOK_AMPERSAND_EQUAL);
+                    tokenizer->col += 2;
+                    tokenizer->pos += 2;
+                }
                 else
                 {
                     set_next(tokenizer, TOK_AMPERSAND);
@@ -163,7 +439,19 @@ void tokenizer_step(Tokenizer* tokenizer)
             case '<':
             {
                 found = true;
-                if (tokenizer->buff[tokenizer->pos + 1] == '=')
+                if (tokenizer->buff[tokenizer->pos + 1] == '<' && tokenizer->buff[tokenizer->pos + 2] == '=')
+                {
+                    set_next(tokenizer, TOK_2_LESS_EQUAL);
+                    tokenizer->col += 3;
+                    tokenizer->pos += 3;
+                }
+                else if (tokenizer->buff[tokenizer->pos + 1] == '<')
+                {
+                    set_next(tokenizer, TOK_2_LESS);
+                    tokenizer->col += 2;
+                    tokenizer->pos += 2;
+                }
+                else if (tokenizer->buff[tokenizer->pos + 1] == '=')
                 {
                     set_next(tokenizer, TOK_LESS_OR_EQUAL);
                     tokenizer->col += 2;
@@ -180,7 +468,19 @@ void tokenizer_step(Tokenizer* tokenizer)
             case '>':
             {
                 found = true;
-                if (tokenizer->buff[tokenizer->pos + 1] == '=')
+                if (tokenizer->buff[tokenizer->pos + 1] == '>' && tokenizer->buff[tokenizer->pos + 2] == '=')
+                {
+                    set_next(tokenizer, TOK_2_GREATER_EQUAL);
+                    tokenizer->col += 3;
+                    tokenizer->pos += 3;
+                }
+                else if (tokenizer->buff[tokenizer->pos + 1] == '>')
+                {
+                    set_next(tokenizer, TOK_2_GREATER);
+                    tokenizer->col += 2;
+                    tokenizer->pos += 2;
+                }
+                else if (tokenizer->buff[tokenizer->pos + 1] == '=')
                 {
                     set_next(tokenizer, TOK_GREATER_OR_EQUAL);
                     tokenizer->col += 2;
@@ -203,93 +503,62 @@ void tokenizer_step(Tokenizer* tokenizer)
                     tokenizer->col += 2;
                     tokenizer->pos += 2;
                 }
+                else if (tokenizer->buff[tokenizer->pos + 1] == '=')
+                {
+                    set_next(tokenizer, TOK_PIPE_EQUAL);
+                    tokenizer->col += 2;
+                    tokenizer->pos += 2;
+                }
                 else
                 {
-                    char* invalid_sequence = malloc(sizeof(char) * 2);
-                    if (invalid_sequence == NULL)
-                    {
-                        perror("Failed to allocate memory for an invalid_sequence of an invalid token");
-                        exit(EXIT_FAILURE);
-                    }
-                    invalid_sequence[0] = '|';
-                    invalid_sequence[1] = '\0';
-
-                    // Creating the invalid sequence token
-                    tokenizer->next.type = TOK_INVALID_SEQ;
-                    tokenizer->next.value.str_val = invalid_sequence;
-                    tokenizer->next.line = tokenizer->line;
-                    tokenizer->next.col = tokenizer->col;
-
+                    set_next(tokenizer, TOK_PIPE);
                     tokenizer->col++;
                     tokenizer->pos++;
                 }
                 break;
             }
-            case '/' :
+            case '^':
             {
-                if (tokenizer->buff[tokenizer->pos + 1] == '*')
-                { // Entering block comment
+                found = true;
+                if (tokenizer->buff[tokenizer->pos + 1] == '=')
+                {
+                    set_next(tokenizer, TOK_CARET_EQUAL);
                     tokenizer->col += 2;
                     tokenizer->pos += 2;
-                    bool in_comment_block = true;
-                    while (in_comment_block)
+                }
+                else
+                {
+                    set_next(tokenizer, TOK_CARET);
+                    tokenizer->col++;
+                    tokenizer->pos++;
+                }
+                break;
+            }
+            case '/' :
+            {
+                if (tokenizer->buff[tokenizer->pos + 1] == '*')
+                { // Block comment, it ends at the first '*/' or at the end of the file
+                    int end = tokenizer->pos + 2;
+                    while (true)
                     {
-                        switch (tokenizer->buff[tokenizer->pos])
+                        end = scan_until(tokenizer, end, '*');
+                        if (tokenizer->buff[end] == '\0')
+                            break;
+                        if (tokenizer->buff[end + 1] == '/')
                         {
-                            case '\n':
-                            {
-                                tokenizer->line++;
-                                tokenizer->col = 1;
-                                tokenizer->pos++;
-                                break;
-                            }
-                            case '*':
-                            {
-                                if (tokenizer->buff[tokenizer->pos + 1] != '/')
-                                {
-                                    tokenizer->col++;
-                                    tokenizer->pos++;
-                                }
-                                else
-                                {
-                                    in_comment_block = false;
-                                    tokenizer->col += 2;
-                                    tokenizer->pos += 2;
-                                }
-                                break;
-                            }
-                            default:
-                            {
-                                tokenizer->col++;
-                                tokenizer->pos++;
-                            }
+                            end += 2;
+                            break;
                         }
+                        end++;
                     }
+                    move_to(tokenizer, end);
                 }
                 else if (tokenizer->buff[tokenizer->pos + 1] == '/')
-                { // Entering line comment
-                    tokenizer->col += 2;
-                    tokenizer->pos += 2;
-                    bool in_comment_line = true;
-                    while (in_comment_line)
-                    {
-                        switch (tokenizer->buff[tokenizer->pos])
-                        {
-                            case '\n':
-                            {
-                                in_comment_line = false;
-                                tokenizer->line++;
-                                tokenizer->col = 1;
-                                tokenizer->pos++;
-                                break;
-                            }
-                            default:
-                            {
-                                tokenizer->col++;
-                                tokenizer->pos++;
-                            }
-                        }
-                    }
+                { // Line comment, its newline is skipped with it
+                    int end = scan_until(tokenizer, tokenizer->pos + 2, '\n');
+                    if (tokenizer->buff[end] == '\n')
+                        end++;
+                    move_to(tokenizer, end);
                 }
                 else if (tokenizer->buff[tokenizer->pos + 1] == '=')
                 {
@@ -462,8 +731,10 @@ void tokenizer_step(Tokenizer* tokenizer)
             case ']' : set_next(tokenizer, TOK_CLOSE_BRACKET);     found = true; tokenizer->col++; tokenizer->pos++; break;
             case '{' : set_next(tokenizer, TOK_OPEN_BRACE);        found = true; tokenizer->col++; tokenizer->pos++; break;
             case '}' : set_next(tokenizer, TOK_CLOSE_BRACE);       found = true; tokenizer->col++; tokenizer->pos++; break;
+            case '~' : set_next(tokenizer, TOK_TILDE);             found = true; tokenizer->col++; tokenizer->pos++; break;
 
-            case '\0': set_next(tokenizer, TOK_EOF);               found = true; tokenizer->col++; tokenizer->pos++; break;
+            // The tokenizer stays on the null terminator, the following steps give EOF again
+            case '\0': set_next(tokenizer, TOK_EOF);               found = true; break;
 
             default  :
             {
@@ -556,40 +827,12 @@ void tokenizer_step(Tokenizer* tokenizer)
                 }
                 else if (is_letter(tokenizer->buff[tokenizer->pos])) // looking for an identifier or keyword
                 {
-                    int size = 0;
-                    while (is_alphanumeric(tokenizer->buff[tokenizer->pos + size]))
-                        size++;
-
-                    char* text = malloc(sizeof(char) * size + 1);
-                    if (text == NULL)
-                    {
-                        perror("Failed to allocate memory for a constant ascii value");
-                        exit(EXIT_FAILURE);
-                    }
-                    memcpy(text, &(tokenizer->buff[tokenizer->pos]), size);
-                    text[size] = '\0';
-
-                    // Testing if it is one of the supported keywords
-                    if      (strcmp(text, "int") == 0)       tokenizer->next.type = TOK_INT;
-                    else if (strcmp(text, "if") == 0)        tokenizer->next.type = TOK_IF;
-                    else if (strcmp(text, "else") == 0)      tokenizer->next.type = TOK_ELSE;
-                    else if (strcmp(text, "for") == 0)       tokenizer->next.type = TOK_FOR;
-                    else if (strcmp(text, "while") == 0)     tokenizer->next.type = TOK_WHILE;
-                    else if (strcmp(text, "do") == 0)        tokenizer->next.type = TOK_DO;
-                    else if (strcmp(text, "break") == 0)     tokenizer->next.type = TOK_BREAK;
-                    else if (strcmp(text, "continue") == 0)  tokenizer->next.type = TOK_CONTINUE;
-                    else if (strcmp(text, "return") == 0)    tokenizer->next.type = TOK_RETURN;
-                    else if (strcmp(text, "print") == 0)     tokenizer->next.type = TOK_PRINT;
-                    else if (strcmp(text, "const") == 0)     tokenizer->next.type = TOK_CONST_SPECIFIER;
-
-                    else // It is an identifier
-                    {
-                        tokenizer->next.type = TOK_IDENTIFIER;
-                        tokenizer->next.value.str_val = text;
-                    }
+                    int size = scan_alphanumerics(tokenizer, tokenizer->pos) - tokenizer->pos;
 
-                    if (tokenizer->next.type != TOK_IDENTIFIER) // If it is a keyword, we don't need the text
-                        free(text);
+                    // Only the identifiers need their text
+                    tokenizer->next.type = token_keyword_type(&(tokenizer->buff[tokenizer->pos]), size);
+                    if (tokenizer->next.type == TOK_IDENTIFIER)
+                        tokenizer->next.value.str_val = token_intern(&(tokenizer->buff[tokenizer->pos]), size);
 
                     tokenizer->next.line = tokenizer->line;
                     tokenizer->next.col = tokenizer->col;
@@ -636,6 +879,11 @@ static const char* TOKEN_REPR[] =
     "'*='",
     "'/='",
     "'%='",
+    "'<<='",
+    "'>>='",
+    "'&='",
+    "'|='",
+    "'^='",
     "'||'",
     "'&&'",
     "'!='",
@@ -644,13 +892,18 @@ static const char* TOKEN_REPR[] =
     "'>'",
     "'<='",
     "'>='",
+    "'<<'",
+    "'>>'",
     "'+'",
     "'-'",
     "'*'",
     "'/'",
     "'%'",
+    "'|'",
+    "'^'",
     "'&'",
     "'!'",
+    "'~'",
     "','",
     "';'",
     "'('",
@@ -670,6 +923,7 @@ static const char* TOKEN_REPR[] =
     "'return'",
     "'print'",
     "'const'",
+    "'extern'",
     "a numeric value",
     "an identifier",
     "end of file",
@@ -735,12 +989,22 @@ void token_display(Token token, FILE* out_file)
         case TOK_SLASH:             fprintf(out_file, "SLASH\n");                                            break;
         case TOK_PERCENT:           fprintf(out_file, "PERCENT\n");                                          break;
         case TOK_AMPERSAND:         fprintf(out_file, "AMPERSAND\n");                                        break;
+        case TOK_PIPE:              fprintf(out_file, "PIPE\n");                                             break;
+        case TOK_CARET:             fprintf(out_file, "CARET\n");                                            break;
+        case TOK_TILDE:             fprintf(out_file, "TILDE\n");                                            break;
+        case TOK_2_LESS:            fprintf(out_file, "DOUBLE LESS\n");                                      break;
+        case TOK_2_GREATER:         fprintf(out_file, "DOUBLE GREATER\n");                                   break;
         case TOK_EQUAL:             fprintf(out_file, "EQUAL\n");                                            break;
         case TOK_PLUS_EQUAL:        fprintf(out_file, "PLUS EQUAL\n");                                       break;
         case TOK_MINUS_EQUAL:       fprintf(out_file, "MINUS EQUAL\n");                                      break;
         case TOK_MUL_EQUAL:         fprintf(out_file, "MUL EQUAL\n");                                        break;
         case TOK_DIV_EQUAL:         fprintf(out_file, "DIV EQUAL\n");                                        break;
         case TOK_MOD_EQUAL:         fprintf(out_file, "MOD EQUAL\n");                                        break;
+        case TOK_2_LESS_EQUAL:      fprintf(out_file, "DOUBLE LESS EQUAL\n");                                break;
+        case TOK_2_GREATER_EQUAL:   fprintf(out_file, "DOUBLE GREATER EQUAL\n");                             break;
+        case TOK_AMPERSAND_EQUAL:   fprintf(out_file, "AMPERSAND EQUAL\n");                                  break;
+        case TOK_PIPE_EQUAL:        fprintf(out_file, "PIPE EQUAL\n");                                       break;
+        case TOK_CARET_EQUAL:       fprintf(out_file, "CARET EQUAL\n");                                      break;
         case TOK_2_EQUAL:           fprintf(out_file, "DOUBLE EQUAL\n");                                     break;
         case TOK_NOT:               fprintf(out_file, "NOT\n");                                              break;
         case TOK_NOT_EQUAL:         fprintf(out_file, "NOT EQUAL\n");                                        break;
@@ -769,6 +1033,7 @@ void token_display(Token token, FILE* out_file)
         case TOK_RETURN:            fprintf(out_file, "RETURN\n");                                           break;
         case TOK_PRINT:             fprintf(out_file, "PRINT\n");                                            break;
         case TOK_CONST_SPECIFIER:   fprintf(out_file, "CONST_SPECIFIER\n");                                  break;
+        case TOK_EXTERN:            fprintf(out_file, "EXTERN\n");                                           break;
         case TOK_EOF:               fprintf(out_file, "EOF\n");                                              break;
     }
 }
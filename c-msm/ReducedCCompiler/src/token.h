@@ -22,9 +22,12 @@ typedef struct Tokenizer_s Tokenizer;
 struct Tokenizer_s
 {
     char* buff;
+    int   length;   // Number of characters before the null terminator of the buffer
     int   pos;
     int   line;
     int   col;
+    int   current_end;  // Position following the last character of the current token
+    int   next_start;   // Position of the first character of the next token
     Token current;
     Token next;
 };
@@ -33,6 +36,10 @@ Token token_create();
 Tokenizer tokenizer_create(char* buff);
 
 void tokenizer_step(Tokenizer* tokenizer);
+// Type of the keyword made of the 'size' first characters of 'text', TOK_IDENTIFIER if it isn't a keyword
+int token_keyword_type(const char* text, int size);
+// Shared copy of the name made of the 'size' first characters of 'text'
+char* token_intern(const char* text, int size);
 bool tokenizer_check(Tokenizer* tokenizer, int token_type);
 void tokenizer_accept(Tokenizer* tokenizer, int token_type);
 
@@ -48,6 +55,11 @@ enum
     TOK_MUL_EQUAL,          // *=
     TOK_DIV_EQUAL,          // /=
     TOK_MOD_EQUAL,          // %=
+    TOK_2_LESS_EQUAL,       // <<=
+    TOK_2_GREATER_EQUAL,    // >>=
+    TOK_AMPERSAND_EQUAL,    // &=
+    TOK_PIPE_EQUAL,         // |=
+    TOK_CARET_EQUAL,        // ^=
 
     TOK_2_PIPE,             // ||
     TOK_2_AMPERSAND,        // &&
@@ -59,14 +71,20 @@ enum
     TOK_LESS_OR_EQUAL,      // <=
     TOK_GREATER_OR_EQUAL,   // >=
 
+    TOK_2_LESS,             // <<
+    TOK_2_GREATER,          // >>
+
     TOK_PLUS,               // +
     TOK_MINUS,              // -
     TOK_STAR,               // *
     TOK_SLASH,              // /
     TOK_PERCENT,            // %
 
-    TOK_AMPERSAND,          // &
+    TOK_PIPE,               // |
+    TOK_CARET,              // ^
+    TOK_AMPERSAND,          // &   Last binary operator, also the address prefix operator
     TOK_NOT,                // !
+    TOK_TILDE,              // ~
 
     // Ponctuation
     TOK_COMMA,              // ,
@@ -90,6 +108,7 @@ enum
     TOK_RETURN,             // return
     TOK_PRINT,              // print
     TOK_CONST_SPECIFIER,    // const
+    TOK_EXTERN,             // extern
 
     TOK_CONSTANT,           // Numeric value
     TOK_IDENTIFIER,         // Identifier (text that is not a keyword)
@@ -0,0 +1,15 @@
+# Writes the header defining RCC_BUILD_ID, a hash of the sources of rcc
+# Usage : cmake -D SOURCE_DIR=<sources of rcc> -D OUTPUT=<header> -P build_id.cmake
+
+file(GLOB sources "${SOURCE_DIR}/*.c" "${SOURCE_DIR}/*.h")
+list(SORT sources)
+
+set(content "")
+foreach(source ${sources})
+    get_filename_component(name "${source}" NAME)
+    file(SHA256 "${source}" source_hash)
+    string(APPEND content "${name} ${source_hash}\n")
+endforeach()
+string(SHA256 build_id "${content}")
+
+file(WRITE "${OUTPUT}" "#ifndef BUILD_ID_H\n#define BUILD_ID_H\n\n#define RCC_BUILD_ID \"${build_id}\"\n\n#endif // BUILD_ID_H\n")